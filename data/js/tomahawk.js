@@ -121,6 +121,52 @@ Tomahawk.extend = function (object, members) {
 };
 
 
+/**
+ * Resolves a batch of queries handed over by Tomahawk. Each query is an
+ * object with a qid and either artist, album and track or fullText.
+ *
+ * Resolvers can implement resolveBatch(queries) to answer a whole batch at
+ * once, otherwise every query goes through resolve() or search(). Results
+ * returned synchronously are handed back to Tomahawk in one list, results
+ * found later can be reported with Tomahawk.addTrackResults() or
+ * Tomahawk.addTrackResultsBatch().
+ */
+Tomahawk.resolveBatch = function (queries) {
+    var instance = Tomahawk.resolver.instance,
+        results = [],
+        query,
+        result,
+        i;
+
+    if (typeof instance.resolveBatch === "function") {
+        return instance.resolveBatch(queries);
+    }
+
+    for (i = 0; i < queries.length; i++) {
+        query = queries[i];
+        try {
+            if (query.hasOwnProperty("fullText")) {
+                result = instance.search(query.qid, query.fullText);
+            } else {
+                result = instance.resolve(query.qid, query.artist, query.album, query.track);
+            }
+        } catch (e) {
+            Tomahawk.log("Failed to resolve " + query.qid + ": " + e);
+            continue;
+        }
+
+        if (result && typeof result === "object") {
+            results.push({
+                qid: query.qid,
+                results: result.results || []
+            });
+        }
+    }
+
+    return results;
+};
+
+
 var TomahawkResolverCapability = {
     NullCapability: 0,
     Browsable:      1,
@@ -0,0 +1,25 @@
+-- Script to migate from db version 31 to 32.
+
+-- Pre-aggregated plays per source, track and day. Charts, trending and stats
+-- read from here instead of grouping the whole playback_log every time
+CREATE TABLE IF NOT EXISTS playback_log_daily (
+    source INTEGER NOT NULL DEFAULT 0,      -- 0 for local plays, not a source(id)
+    track INTEGER REFERENCES track(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
+    artist INTEGER REFERENCES artist(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
+    day INTEGER NOT NULL,
+    plays INTEGER NOT NULL DEFAULT 0,
+    secs_played INTEGER NOT NULL DEFAULT 0,
+    UNIQUE(source, track, day)
+);
+
+INSERT INTO playback_log_daily(source, track, artist, day, plays, secs_played)
+    SELECT IFNULL(playback_log.source, 0), playback_log.track, track.artist, playback_log.playtime / 86400, COUNT(*), SUM(playback_log.secs_played)
+    FROM playback_log, track
+    WHERE track.id = playback_log.track
+    GROUP BY playback_log.source, playback_log.track, playback_log.playtime / 86400;
+
+CREATE INDEX playback_log_daily_track ON playback_log_daily(track, day);
+CREATE INDEX playback_log_daily_artist ON playback_log_daily(artist, day);
+CREATE INDEX playback_log_daily_day ON playback_log_daily(day);
+
+UPDATE settings SET v = '32' WHERE k == 'schema_version';
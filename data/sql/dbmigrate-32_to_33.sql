@@ -0,0 +1,7 @@
+-- Script to migate from db version 32 to 33.
+
+-- Playlist revisions can now be stored as a delta against their previous revision.
+-- Existing revisions keep their full list of entries.
+ALTER TABLE playlist_revision ADD COLUMN delta TEXT;
+
+UPDATE settings SET v = '33' WHERE k == 'schema_version';
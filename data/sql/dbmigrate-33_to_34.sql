@@ -0,0 +1,13 @@
+-- Script to migate from db version 33 to 34.
+
+-- Local files carry the directory they live in, so that the files below a
+-- directory are an index range instead of a scan over every url.
+ALTER TABLE file ADD COLUMN dir TEXT;
+
+-- rtrim strips every trailing character but '/', leaving the url up to its last slash
+UPDATE file SET dir = rtrim( url, replace( url, '/', '' ) ) WHERE source IS NULL;
+UPDATE file SET dir = substr( dir, 1, length( dir ) - 1 ) WHERE source IS NULL AND dir LIKE '%/';
+
+CREATE INDEX file_source_dir ON file(source, dir);
+
+UPDATE settings SET v = '34' WHERE k == 'schema_version';
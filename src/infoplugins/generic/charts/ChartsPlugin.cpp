@@ -25,11 +25,11 @@
 #include "CountryUtils.h"
 #include "Typedefs.h"
 #include "audio/AudioEngine.h"
+#include "infosystem/InfoRequestScheduler.h"
 #include "TomahawkSettings.h"
 #include "utils/Json.h"
 #include "utils/Logger.h"
 #include "utils/TomahawkCache.h"
-#include "utils/NetworkAccessManager.h"
 #include "Source.h"
 
 #include <QDir>
@@ -278,7 +278,7 @@ ChartsPlugin::fetchChartSourcesList( bool fetchOnlySourceList )
 
     TomahawkUtils::urlAddQueryItem( url, "version", TomahawkUtils::appFriendlyVersion() );
 
-    QNetworkReply* reply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+    QNetworkReply* reply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), InfoPriorityLow );
     reply->setProperty( "only_source_list", fetchOnlySourceList );
 
     connect( reply, SIGNAL( finished() ), SLOT( chartSourcesList() ) );
@@ -374,7 +374,7 @@ ChartsPlugin::fetchSource(const QString& source)
     QUrl url = QUrl( QString( CHART_URL "charts/%1" ).arg( source ) );
     TomahawkUtils::urlAddQueryItem( url, "version", TomahawkUtils::appFriendlyVersion() );
 
-    QNetworkReply* reply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+    QNetworkReply* reply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), InfoPriorityLow );
     reply->setProperty( "chart_source", source );
 
     tDebug() << Q_FUNC_INFO << "fetching:" << url;
@@ -420,7 +420,7 @@ ChartsPlugin::fetchChart( Tomahawk::InfoSystem::InfoRequestData requestData, con
 
     tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "fetching: " << url;
 
-    QNetworkReply* reply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+    QNetworkReply* reply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), requestData );
     reply->setProperty( "requestData", QVariant::fromValue< Tomahawk::InfoSystem::InfoRequestData >( requestData ) );
 
     connect( reply, SIGNAL( finished() ), SLOT( chartReturned() ) );
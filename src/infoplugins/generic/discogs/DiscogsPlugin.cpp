@@ -19,10 +19,10 @@
 #include "DiscogsPlugin.h"
 
 
+#include "infosystem/InfoRequestScheduler.h"
 #include "utils/Json.h"
 #include "utils/Logger.h"
 #include "utils/Closure.h"
-#include "utils/NetworkAccessManager.h"
 
 #include <QNetworkReply>
 #include <QDomDocument>
@@ -96,7 +96,7 @@ DiscogsPlugin::notInCacheSlot( InfoStringHash criteria, InfoRequestData requestD
 
             QNetworkRequest req( url );
             req.setRawHeader( "User-Agent", "TomahawkPlayer/1.0 +http://tomahawk-player.org" );
-            QNetworkReply* reply = Tomahawk::Utils::nam()->get( req );
+            QNetworkReply* reply = InfoRequestScheduler::instance()->get( req, requestData );
 
             NewClosure( reply, SIGNAL( finished() ),  this, SLOT( albumSearchSlot( Tomahawk::InfoSystem::InfoRequestData, QNetworkReply* ) ), requestData, reply );
             break;
@@ -134,7 +134,7 @@ DiscogsPlugin::albumSearchSlot( const InfoRequestData &requestData, QNetworkRepl
     QNetworkRequest req( url );
     req.setRawHeader( "User-Agent", "TomahawkPlayer/1.0 +http://tomahawk-player.org" );
 
-    QNetworkReply* reply2 = Tomahawk::Utils::nam()->get( req );
+    QNetworkReply* reply2 = InfoRequestScheduler::instance()->get( req, requestData );
     NewClosure( reply2, SIGNAL( finished() ),  this, SLOT( albumInfoSlot( Tomahawk::InfoSystem::InfoRequestData, QNetworkReply* ) ), requestData, reply2 );
 }
 
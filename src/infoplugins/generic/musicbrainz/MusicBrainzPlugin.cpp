@@ -19,9 +19,9 @@
 
 #include "MusicBrainzPlugin.h"
 
+#include "infosystem/InfoRequestScheduler.h"
 #include "utils/TomahawkUtils.h"
 #include "utils/Logger.h"
-#include "utils/NetworkAccessManager.h"
 
 #include <QNetworkReply>
 #include <QDomDocument>
@@ -43,6 +43,14 @@ MusicBrainzPlugin::~MusicBrainzPlugin()
 }
 
 
+void
+MusicBrainzPlugin::init()
+{
+    // MusicBrainz blocks clients making more than one request per second
+    InfoRequestScheduler::instance()->setHostLimits( "musicbrainz.org", 1, 1 );
+}
+
+
 void
 MusicBrainzPlugin::getInfo( Tomahawk::InfoSystem::InfoRequestData requestData )
 {
@@ -111,7 +119,7 @@ MusicBrainzPlugin::notInCacheSlot( InfoStringHash criteria, InfoRequestData requ
             TomahawkUtils::urlAddQueryItem( url, "limit", "100" );
 
             tDebug() << Q_FUNC_INFO << url.toString();
-            QNetworkReply* reply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+            QNetworkReply* reply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), requestData );
             reply->setProperty( "requestData", QVariant::fromValue< Tomahawk::InfoSystem::InfoRequestData >( requestData ) );
 
             connect( reply, SIGNAL( finished() ), SLOT( gotReleaseGroupsSlot() ) );
@@ -131,7 +139,7 @@ MusicBrainzPlugin::notInCacheSlot( InfoStringHash criteria, InfoRequestData requ
             TomahawkUtils::urlAddQueryItem( url, "limit", "100" );
 
             tDebug() << Q_FUNC_INFO << url.toString();
-            QNetworkReply* reply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+            QNetworkReply* reply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), requestData );
             reply->setProperty( "requestData", QVariant::fromValue< Tomahawk::InfoSystem::InfoRequestData >( requestData ) );
 
             connect( reply, SIGNAL( finished() ), SLOT( gotReleasesSlot() ) );
@@ -237,7 +245,7 @@ MusicBrainzPlugin::gotReleasesSlot()
             TomahawkUtils::urlAddQueryItem( url, "inc", "recordings" );
             tDebug() << Q_FUNC_INFO << url.toString();
 
-            QNetworkReply* newReply = Tomahawk::Utils::nam()->get( QNetworkRequest( url ) );
+            QNetworkReply* newReply = InfoRequestScheduler::instance()->get( QNetworkRequest( url ), requestData );
             newReply->setProperty( "requestData", oldReply->property( "requestData" ) );
             connect( newReply, SIGNAL( finished() ), SLOT( gotRecordingsSlot() ) );
 
@@ -32,6 +32,7 @@
 #include "Api_v1_5.h"
 #include "Pipeline.h"
 #include "Result.h"
+#include "ResultsResponseHandler.h"
 #include "Source.h"
 #include "StatResponseHandler.h"
 #include "UrlHandler.h"
@@ -40,6 +41,12 @@
 
 #include <QHash>
 
+// Longest a client may wait for results with a single get_results call
+#define MAX_RESULTS_WAIT 60000
+
+// Largest resolve_batch body we accept
+#define MAX_BATCH_BODY 1024 * 1024
+
 using namespace Tomahawk;
 using namespace TomahawkUtils;
 
@@ -184,6 +191,7 @@ Api_v1::api( QxtWebRequestEvent* event, const QString& version, const QString& m
 
           if ( method == "stat" )        return stat( event );
           if ( method == "resolve" )     return resolve( event );
+          if ( method == "resolve_batch" ) return resolve_batch( event );
           if ( method == "get_results" ) return get_results( event );
       }
 
@@ -356,37 +364,138 @@ Api_v1::resolve( QxtWebRequestEvent* event )
 }
 
 
+/**
+ * Resolves a list of queries posted as { "queries": [ { "artist": ..., "track": ..., "album": ..., "qid": ... }, ... ] }
+ * and answers with their qids, in the same order. Invalid queries get a null qid.
+ */
 void
-Api_v1::staticdata( QxtWebRequestEvent* event, const QString& file )
+Api_v1::resolve_batch( QxtWebRequestEvent* event )
 {
-    tDebug( LOGVERBOSE ) << "STATIC request:" << event << file;
+    if ( event->content.isNull() )
+    {
+        tDebug( LOGVERBOSE ) << "Malformed HTTP resolve_batch request";
+        return send404( event );
+    }
 
-    bool whitelisted = ( file == QString( "tomahawk_auth_logo.png" ) ||
-                         file.startsWith( "css/" ) ||
-                         file.startsWith( "js/" ) );
+    // Refuse bodies that are too large or of unknown size before reading any of them
+    QxtWebContent* content = event->content;
+    if ( content->wantAll() || content->unreadBytes() > MAX_BATCH_BODY )
+    {
+        tDebug( LOGVERBOSE ) << "Refusing resolve_batch request of size" << content->unreadBytes();
+        content->ignoreRemainingContent();
+        return send404( event );
+    }
+
+    // Don't block on the rest of the body, it is handled once it arrived
+    m_batchRequests.insert( content, event );
+    connect( content, SIGNAL( readyRead() ), SLOT( onBatchContentReady() ) );
+    connect( content, SIGNAL( readChannelFinished() ), SLOT( onBatchContentReady() ) );
+    connect( content, SIGNAL( destroyed( QObject* ) ), SLOT( onBatchContentDestroyed( QObject* ) ) );
+
+    readBatchContent( content );
+}
+
+
+void
+Api_v1::onBatchContentReady()
+{
+    readBatchContent( qobject_cast< QxtWebContent* >( sender() ) );
+}
+
+
+void
+Api_v1::onBatchContentDestroyed( QObject* content )
+{
+    m_batchRequests.remove( content );
+}
 
-    if ( whitelisted )
+
+void
+Api_v1::readBatchContent( QxtWebContent* content )
+{
+    if ( !content || content->bytesNeeded() > 0 || !m_batchRequests.contains( content ) )
+        return;
+
+    disconnect( content, 0, this, 0 );
+    resolveBatch( m_batchRequests.take( content ), content->readAll() );
+}
+
+
+void
+Api_v1::resolveBatch( QxtWebRequestEvent* event, const QByteArray& body )
+{
+    bool ok;
+    const QVariantList list = TomahawkUtils::parseJson( body, &ok ).toMap().value( "queries" ).toList();
+    if ( !ok || list.isEmpty() )
     {
-        QFile f( RESPATH "www/" + file );
-        f.open( QIODevice::ReadOnly );
-        QByteArray data = f.readAll();
+        tDebug( LOGVERBOSE ) << "Malformed HTTP resolve_batch request";
+        return send404( event );
+    }
 
-        QxtWebPageEvent* e = new QxtWebPageEvent( event->sessionID, event->requestID, data );
+    QList< query_ptr > queries;
+    QVariantList qids;
+    foreach ( const QVariant& v, list )
+    {
+        const QVariantMap m = v.toMap();
+        const QString artist = m.value( "artist" ).toString();
+        const QString track = m.value( "track" ).toString();
+        const QString album = m.value( "album" ).toString();
 
-        if ( file.endsWith( ".png" ) )
-            e->contentType = "image/png";
-        if ( file.endsWith( ".css" ) )
-            e->contentType = "text/css";
-        if ( file.endsWith( ".js" ) )
-            e->contentType = "application/javascript";
+        QString qid = m.value( "qid" ).toString();
+        if ( qid.isEmpty() )
+            qid = uuid();
 
-        postEvent( e );
+        query_ptr qry;
+        if ( !artist.trimmed().isEmpty() && !track.trimmed().isEmpty() )
+            qry = Query::get( artist, track, album, qid, false );
+
+        if ( qry.isNull() )
+        {
+            qids << QVariant();
+            continue;
+        }
+
+        queries << qry;
+        qids << qid;
     }
-    else
+
+    Pipeline::instance()->resolve( queries, true, true );
+
+    QVariantMap r;
+    r.insert( "qids", qids );
+    sendJSON( r, event );
+}
+
+
+void
+Api_v1::staticdata( QxtWebRequestEvent* event, const QString& file )
+{
+    tDebug( LOGVERBOSE ) << "STATIC request:" << event << file;
+
+    bool whitelisted = ( file == QString( "tomahawk_auth_logo.png" ) ||
+                         file.startsWith( "css/" ) ||
+                         file.startsWith( "js/" ) );
+
+    const QByteArray data = whitelisted ? resource( RESPATH "www/" + file ) : QByteArray();
+    if ( data.isNull() )
     {
         send404( event );
         return;
     }
+
+    QxtWebPageEvent* e = new QxtWebPageEvent( event->sessionID, event->requestID, data );
+
+    if ( file.endsWith( ".png" ) )
+        e->contentType = "image/png";
+    if ( file.endsWith( ".css" ) )
+        e->contentType = "text/css";
+    if ( file.endsWith( ".js" ) )
+        e->contentType = "application/javascript";
+
+    // these are part of the binary, they only change with the next build
+    e->headers.insert( "Cache-Control", "max-age=86400" );
+
+    postEvent( e );
 }
 
 
@@ -414,12 +523,41 @@ Api_v1::get_results( QxtWebRequestEvent* event )
         return;
     }
 
+    // Long polling: with wait set, hold the request until there's something
+    // new compared to the number of results the client already knows
+    if ( urlHasQueryItem( event->url, "wait" ) )
+    {
+        const int wait = qBound( 0, urlQueryItemValue( event->url, "wait" ).toInt(), MAX_RESULTS_WAIT );
+        const int known = urlQueryItemValue( event->url, "known" ).toInt();
+
+        int online = 0;
+        foreach ( const result_ptr& rp, qry->results() )
+        {
+            if ( rp->isOnline() )
+                online++;
+        }
+
+        if ( wait > 0 && online == known && !qry->resolvingFinished() )
+        {
+            new ResultsResponseHandler( this, event, qry, wait );
+            return;
+        }
+    }
+
+    sendResults( qry, event );
+}
+
+
+void
+Api_v1::sendResults( const query_ptr& qry, QxtWebRequestEvent* event )
+{
     QVariantMap r;
     r.insert( "qid", qry->id() );
     r.insert( "poll_interval", 1300 );
     r.insert( "refresh_interval", 1000 );
     r.insert( "poll_limit", 14 );
     r.insert( "solved", qry->playable() );
+    r.insert( "resolving_finished", qry->resolvingFinished() );
     r.insert( "query", qry->toVariant() );
 
     QVariantList res;
@@ -467,13 +605,10 @@ Api_v1::sendJSON( const QVariantMap& m, QxtWebRequestEvent* event )
 void
 Api_v1::sendWebpageWithArgs( QxtWebRequestEvent* event, const QString& filenameSource, const QHash< QString, QString >& args )
 {
-    if ( !QFile::exists( filenameSource ) )
+    QByteArray html = resource( filenameSource );
+    if ( html.isNull() )
         qWarning() << "Passed invalid file for html source:" << filenameSource;
 
-    QFile f( filenameSource );
-    f.open( QIODevice::ReadOnly );
-    QByteArray html = f.readAll();
-
     foreach( const QString& param, args.keys() )
     {
         html.replace( QString( "<%%1%>" ).arg( param.toUpper() ), args.value( param ).toUtf8() );
@@ -488,6 +623,23 @@ Api_v1::sendWebpageWithArgs( QxtWebRequestEvent* event, const QString& filenameS
 }
 
 
+QByteArray
+Api_v1::resource( const QString& path )
+{
+    QHash< QString, QByteArray >::const_iterator it = m_resources.constFind( path );
+    if ( it != m_resources.constEnd() )
+        return it.value();
+
+    QFile f( path );
+    if ( !f.open( QIODevice::ReadOnly ) )
+        return QByteArray();
+
+    const QByteArray data = f.readAll();
+    m_resources.insert( path, data );
+    return data;
+}
+
+
 void
 Api_v1::index( QxtWebRequestEvent* event )
 {
@@ -32,6 +32,7 @@
 #include <QxtWeb/QxtWebPageEvent>
 
 #include <QFile>
+#include <QHash>
 #include <QSharedPointer>
 #include <QStringList>
 
@@ -39,7 +40,9 @@ class Api_v1_5;
 
 namespace Tomahawk
 {
+    class Query;
     class Result;
+    typedef QSharedPointer< Query > query_ptr;
     typedef QSharedPointer< Result > result_ptr;
 }
 
@@ -70,10 +73,12 @@ public slots:
     void send404( QxtWebRequestEvent* event );
     void stat( QxtWebRequestEvent* event );
     void resolve( QxtWebRequestEvent* event );
+    void resolve_batch( QxtWebRequestEvent* event );
     void staticdata( QxtWebRequestEvent* event, const QString& file );
     void staticdata( QxtWebRequestEvent* event, const QString& path, const QString& file );
     void get_results( QxtWebRequestEvent* event );
     void sendJSON( const QVariantMap& m, QxtWebRequestEvent* event );
+    void sendResults( const Tomahawk::query_ptr& query, QxtWebRequestEvent* event );
 
     void sendJsonError( QxtWebRequestEvent* event, const QString& message );
     void sendJsonOk( QxtWebRequestEvent* event );
@@ -88,9 +93,26 @@ protected:
     void apiCallFailed( QxtWebRequestEvent* event, const QString& method );
     void sendPlain404( QxtWebRequestEvent* event, const QString& message, const QString& statusmessage );
 
+private slots:
+    void onBatchContentReady();
+    void onBatchContentDestroyed( QObject* content );
+
 private:
+    void readBatchContent( QxtWebContent* content );
+    void resolveBatch( QxtWebRequestEvent* event, const QByteArray& body );
+
     void processSid( QxtWebRequestEvent* event, const Tomahawk::result_ptr, const QString url, QSharedPointer< QIODevice > );
 
+    /**
+     * Contents of a file from our resources, only read once.
+     */
+    QByteArray resource( const QString& path );
+
+    QHash< QString, QByteArray > m_resources;
+
+    // resolve_batch requests still waiting for their body
+    QHash< QObject*, QxtWebRequestEvent* > m_batchRequests;
+
     QSharedPointer< QIODevice > m_ioDevice;
     Api_v1_5* m_api_v1_5;
 };
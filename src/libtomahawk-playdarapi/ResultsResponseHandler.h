@@ -0,0 +1,51 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifndef RESULTSRESPONSEHANDLER_H
+#define RESULTSRESPONSEHANDLER_H
+
+#include "Typedefs.h"
+
+#include <QObject>
+#include <QTimer>
+
+class Api_v1;
+class QxtWebRequestEvent;
+
+/**
+ * Holds back a get_results request until the results of its query change,
+ * resolving finishes or the timeout passes, whichever comes first.
+ */
+class ResultsResponseHandler : public QObject
+{
+    Q_OBJECT
+public:
+    ResultsResponseHandler( Api_v1* parent, QxtWebRequestEvent* event, const Tomahawk::query_ptr& query, int timeout );
+
+private slots:
+    void respond();
+
+private:
+    Api_v1* m_parent;
+    QxtWebRequestEvent* m_storedEvent;
+    Tomahawk::query_ptr m_query;
+    QTimer m_timer;
+};
+
+#endif // RESULTSRESPONSEHANDLER_H
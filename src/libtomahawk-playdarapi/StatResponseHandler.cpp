@@ -20,6 +20,10 @@
 
 #include "Api_v1.h"
 
+#include "utils/TomahawkUtils.h"
+
+#include "Pipeline.h"
+
 StatResponseHandler::StatResponseHandler( Api_v1* parent, QxtWebRequestEvent* event )
     : QObject( parent )
     , m_parent( parent )
@@ -43,6 +47,15 @@ StatResponseHandler::statResult( const QString& clientToken, const QString& name
     m.insert( "version", "0.1.1" ); // TODO (needs to be >=0.1.1 for JS to work)
     m.insert( "authenticated", valid ); // TODO
     m.insert( "capabilities", QVariantList() );
+
+    // Resolver stats on request, only for local clients
+    const QHostAddress remote = m_storedEvent->remoteAddress;
+    if ( TomahawkUtils::urlHasQueryItem( m_storedEvent->url, "pipeline" ) && Tomahawk::Pipeline::instance() &&
+         ( remote == QHostAddress( QHostAddress::LocalHost ) || remote == QHostAddress( QHostAddress::LocalHostIPv6 ) ) )
+    {
+        m.insert( "pipeline", Tomahawk::Pipeline::instance()->stats().toVariantMap() );
+    }
+
     m_parent->sendJSON( m, m_storedEvent );
 
     deleteLater();
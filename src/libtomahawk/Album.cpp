@@ -22,6 +22,7 @@
 #include "database/Database.h"
 #include "database/DatabaseImpl.h"
 #include "database/IdThreadWorker.h"
+#include "utils/CoverLoader.h"
 #include "utils/TomahawkUtilsGui.h"
 #include "utils/Logger.h"
 
@@ -262,6 +263,8 @@ Album::cover( const QSize& size, bool forceLoad ) const
         requestData.type = Tomahawk::InfoSystem::InfoAlbumCoverArt;
         requestData.input = QVariant::fromValue< Tomahawk::InfoSystem::InfoStringHash >( trackInfo );
         requestData.customData = QVariantMap();
+        // asked for by a view painting it right now
+        requestData.priority = Tomahawk::InfoSystem::InfoPriorityHigh;
 
         connect( Tomahawk::InfoSystem::InfoSystem::instance(),
                 SIGNAL( info( Tomahawk::InfoSystem::InfoRequestData, QVariant ) ),
@@ -276,27 +279,24 @@ Album::cover( const QSize& size, bool forceLoad ) const
         d->coverLoading = true;
     }
 
-    if ( !d->cover && !d->coverBuffer.isEmpty() )
+    if ( !d->coverBuffer.isEmpty() && !size.isEmpty() )
     {
+        // Decoded and scaled on a worker thread, coverChanged() tells when it's there
+        const QString cacheKey = QString( "%1_%2_%3" ).arg( infoid() ).arg( size.width() ).arg( size.height() );
         QPixmap cover;
-        cover.loadFromData( d->coverBuffer );
-        d->coverBuffer.clear();
 
-        d->cover = new QPixmap( TomahawkUtils::squareCenterPixmap( cover ) );
+        if ( !QPixmapCache::find( cacheKey, &cover ) )
+            CoverLoader::instance()->load( cacheKey, d->coverBuffer, size, const_cast< Album* >( this ) );
+
+        return cover;
     }
 
-    if ( d->cover && !d->cover->isNull() && !size.isEmpty() )
+    if ( !d->cover && !d->coverBuffer.isEmpty() )
     {
-        const QString cacheKey = QString( "%1_%2_%3" ).arg( infoid() ).arg( size.width() ).arg( size.height() );
         QPixmap cover;
+        cover.loadFromData( d->coverBuffer );
 
-        if ( !QPixmapCache::find( cacheKey, &cover ) )
-        {
-            cover = d->cover->scaled( size, Qt::KeepAspectRatio, Qt::SmoothTransformation );
-            QPixmapCache::insert( cacheKey, cover );
-            return cover;
-        }
-        return cover;
+        d->cover = new QPixmap( TomahawkUtils::squareCenterPixmap( cover ) );
     }
 
     if ( d->cover )
@@ -313,6 +313,14 @@ Album::coverLoaded() const
 }
 
 
+bool
+Album::hasCover() const
+{
+    Q_D( const Album );
+    return !d->coverBuffer.isEmpty();
+}
+
+
 void
 Album::infoSystemInfo( const Tomahawk::InfoSystem::InfoRequestData& requestData, const QVariant& output )
 {
@@ -60,6 +60,8 @@ public:
     artist_ptr artist() const;
     QPixmap cover( const QSize& size, bool forceLoad = true ) const;
     bool coverLoaded() const;
+    // Cover art was found, even if it isn't decoded at the size asked for yet
+    bool hasCover() const;
 
     QList<Tomahawk::query_ptr> tracks( ModelMode mode = Mixed, const Tomahawk::collection_ptr& collection = Tomahawk::collection_ptr() );
     Tomahawk::playlistinterface_ptr playlistInterface( ModelMode mode, const Tomahawk::collection_ptr& collection = Tomahawk::collection_ptr() );
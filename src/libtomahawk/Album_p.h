@@ -71,6 +71,9 @@ private:
     mutable bool coverLoading;
     mutable QString uuid;
 
+    // The raw cover as fetched, kept for the object's lifetime. Usually some
+    // 10-200kb of compressed image data, far less than a single decoded cover.
+    // Each new size is scaled from it, and it keys the thumbnails on disk.
     mutable QByteArray coverBuffer;
     mutable QPixmap* cover;
 
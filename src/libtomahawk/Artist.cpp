@@ -27,6 +27,7 @@
 #include "database/DatabaseCommand_ArtistStats.h"
 #include "database/DatabaseCommand_TrackStats.h"
 #include "database/IdThreadWorker.h"
+#include "utils/CoverLoader.h"
 #include "utils/TomahawkUtilsGui.h"
 #include "utils/Logger.h"
 
@@ -601,6 +602,8 @@ Artist::cover( const QSize& size, bool forceLoad ) const
         requestData.type = Tomahawk::InfoSystem::InfoArtistImages;
         requestData.input = QVariant::fromValue< Tomahawk::InfoSystem::InfoStringHash >( trackInfo );
         requestData.customData = QVariantMap();
+        // asked for by a view painting it right now
+        requestData.priority = Tomahawk::InfoSystem::InfoPriorityHigh;
 
         connect( Tomahawk::InfoSystem::InfoSystem::instance(),
                 SIGNAL( info( Tomahawk::InfoSystem::InfoRequestData, QVariant ) ),
@@ -616,27 +619,24 @@ Artist::cover( const QSize& size, bool forceLoad ) const
         m_coverLoading = true;
     }
 
-    if ( !m_cover && !m_coverBuffer.isEmpty() )
+    if ( !m_coverBuffer.isEmpty() && !size.isEmpty() )
     {
+        // Decoded and scaled on a worker thread, coverChanged() tells when it's there
+        const QString cacheKey = QString( "%1_%2_%3" ).arg( infoid() ).arg( size.width() ).arg( size.height() );
         QPixmap cover;
-        cover.loadFromData( m_coverBuffer );
-        m_coverBuffer.clear();
 
-        m_cover = new QPixmap( TomahawkUtils::squareCenterPixmap( cover ) );
+        if ( !QPixmapCache::find( cacheKey, &cover ) )
+            CoverLoader::instance()->load( cacheKey, m_coverBuffer, size, const_cast< Artist* >( this ) );
+
+        return cover;
     }
 
-    if ( m_cover && !m_cover->isNull() && !size.isEmpty() )
+    if ( !m_cover && !m_coverBuffer.isEmpty() )
     {
-        const QString cacheKey = QString( "%1_%2_%3" ).arg( infoid() ).arg( size.width() ).arg( size.height() );
         QPixmap cover;
+        cover.loadFromData( m_coverBuffer );
 
-        if ( !QPixmapCache::find( cacheKey, &cover ) )
-        {
-            cover = m_cover->scaled( size, Qt::KeepAspectRatio, Qt::SmoothTransformation );
-            QPixmapCache::insert( cacheKey, cover );
-            return cover;
-        }
-        return cover;
+        m_cover = new QPixmap( TomahawkUtils::squareCenterPixmap( cover ) );
     }
 
     if ( m_cover )
@@ -127,6 +127,9 @@ private:
     unsigned int m_chartPosition;
     unsigned int m_chartCount;
 
+    // The raw cover as fetched, kept for the object's lifetime. Usually some
+    // 10-200kb of compressed image data, far less than a single decoded cover.
+    // Each new size is scaled from it, and it keys the thumbnails on disk.
     mutable QByteArray m_coverBuffer;
     mutable QPixmap* m_cover;
 
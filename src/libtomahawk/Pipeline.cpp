@@ -22,9 +22,11 @@
 
 #include "database/Database.h"
 #include "resolvers/ExternalResolver.h"
+#include "resolvers/ResolveCache.h"
 #include "resolvers/ScriptResolver.h"
 #include "resolvers/JSResolver.h"
 #include "utils/ResultUrlChecker.h"
+#include "utils/UrlCheckCache.h"
 #include "utils/Logger.h"
 
 #include "FuncTimeout.h"
@@ -110,6 +112,43 @@ Pipeline::activeQueryCount() const
 }
 
 
+PipelineStats
+Pipeline::stats() const
+{
+    Q_D( const Pipeline );
+    QMutexLocker lock( &d->statsMut );
+
+    return d->stats.snapshot();
+}
+
+
+void
+Pipeline::resetStats()
+{
+    Q_D( Pipeline );
+    QMutexLocker lock( &d->statsMut );
+
+    d->stats = PipelineStats();
+}
+
+
+Pipeline::DispatchMode
+Pipeline::dispatchMode() const
+{
+    Q_D( const Pipeline );
+    return d->dispatchMode;
+}
+
+
+void
+Pipeline::setDispatchMode( DispatchMode mode )
+{
+    Q_D( Pipeline );
+    tDebug() << Q_FUNC_INFO << mode;
+    d->dispatchMode = mode;
+}
+
+
 void
 Pipeline::databaseReady()
 {
@@ -286,6 +325,11 @@ Pipeline::resolve( const QList<query_ptr>& qlist, bool prioritized, bool tempora
             else
                 d->queries_pending << q;
 
+            {
+                QMutexLocker statsLock( &d->statsMut );
+                d->stats.recordQueued( q->id() );
+            }
+
             if ( temporaryQuery )
             {
                 d->queries_temporary << q;
@@ -301,6 +345,28 @@ Pipeline::resolve( const QList<query_ptr>& qlist, bool prioritized, bool tempora
 }
 
 
+void
+Pipeline::cancel( const QList<query_ptr>& qlist )
+{
+    Q_D( Pipeline );
+    QMutexLocker lock( &d->mut );
+
+    foreach ( const query_ptr& q, qlist )
+    {
+        if ( !d->queries_pending.removeOne( q ) )
+            continue;
+
+        {
+            QMutexLocker statsLock( &d->statsMut );
+            d->stats.recordDropped( q->id() );
+        }
+
+        if ( !d->qidsState.contains( q->id() ) && !d->queries_temporary.contains( q ) )
+            d->qids.remove( q->id() );
+    }
+}
+
+
 bool
 Pipeline::isResolving( const query_ptr& q ) const
 {
@@ -331,6 +397,17 @@ Pipeline::resolve( QID qid, bool prioritized, bool temporaryQuery )
 
 void
 Pipeline::reportResults( QID qid, const QList< result_ptr >& results )
+{
+    Resolver* resolver = 0;
+    if ( !results.isEmpty() && !results.first().isNull() )
+        resolver = results.first()->resolvedBy().data();
+
+    reportResults( qid, resolver, results );
+}
+
+
+void
+Pipeline::reportResults( QID qid, Resolver* resolver, const QList< result_ptr >& results )
 {
     Q_D( Pipeline );
     if ( !d->running )
@@ -353,6 +430,14 @@ Pipeline::reportResults( QID qid, const QList< result_ptr >& results )
     if ( q.isNull() )
         return;
 
+    {
+        QMutexLocker lock( &d->statsMut );
+        if ( resolver )
+            d->stats.recordAnswer( qid, resolver->name(), !results.isEmpty() );
+        if ( !results.isEmpty() )
+            d->stats.recordResults( qid );
+    }
+
     QList< result_ptr > cleanResults;
     QList< result_ptr > httpResults;
     foreach ( const result_ptr& r, results )
@@ -361,23 +446,45 @@ Pipeline::reportResults( QID qid, const QList< result_ptr >& results )
             continue;
 
         if ( !r->checked() && ( r->url().startsWith( "http" ) && !r->url().startsWith( "http://localhost" ) ) )
-            httpResults << r;
+        {
+            // Skip the HEAD request if we've recently checked this url already
+            switch ( UrlCheckCache::instance()->state( r->url() ) )
+            {
+                case UrlCheckCache::Valid:
+                    cleanResults << r;
+                    break;
+
+                case UrlCheckCache::Invalid:
+                    break;
+
+                case UrlCheckCache::Unknown:
+                    httpResults << r;
+                    break;
+            }
+        }
         else
             cleanResults << r;
-    }const
+    }
 
-    ResultUrlChecker* checker = new ResultUrlChecker( q, httpResults );
-    connect( checker, SIGNAL( done() ), SLOT( onResultUrlCheckerDone() ) );
+    if ( !httpResults.isEmpty() )
+    {
+        ResultUrlChecker* checker = new ResultUrlChecker( q, httpResults );
+        connect( checker, SIGNAL( done() ), SLOT( onResultUrlCheckerDone() ) );
+
+        QMutexLocker lock( &d->mut );
+        d->checkedFor.insert( checker, resolver );
+    }
 
     addResultsToQuery( q, cleanResults );
-    if ( q->solved() && !q->isFullTextQuery() )
+    if ( solvedBy( q, cleanResults ) )
     {
         setQIDState( q, 0 );
         return;
     }
 
+    // Otherwise the answer counts once its urls are checked
     if ( httpResults.isEmpty() )
-        decQIDState( q );
+        answered( q, resolver );
 }
 
 
@@ -415,21 +522,37 @@ Pipeline::addResultsToQuery( const query_ptr& query, const QList< result_ptr >&
 void
 Pipeline::onResultUrlCheckerDone()
 {
+    Q_D( Pipeline );
     ResultUrlChecker* checker = qobject_cast< ResultUrlChecker* >( sender() );
     if ( !checker )
         return;
 
     checker->deleteLater();
 
+    Resolver* resolver;
+    {
+        QMutexLocker lock( &d->mut );
+        resolver = d->checkedFor.take( checker );
+    }
+
     const query_ptr q = checker->query();
+    if ( !q )
+        return;
+
     addResultsToQuery( q, checker->validResults() );
-    if ( q && !q->isFullTextQuery() )
+
+    // Other results reported along with the unchecked ones may have finished the query already
+    if ( !isResolving( q ) )
+        return;
+
+    // A dead hint or a live one that doesn't match well enough leaves it to the next resolvers
+    if ( solvedBy( q, checker->validResults() ) )
     {
         setQIDState( q, 0 );
         return;
     }
 
-    decQIDState( q );
+    answered( q, resolver );
 }
 
 
@@ -501,7 +624,7 @@ Pipeline::shuntNext()
         return;
 
     unsigned int rc;
-    query_ptr q;
+    QList< query_ptr > queries;
     {
         QMutexLocker lock( &d->mut );
 
@@ -513,67 +636,163 @@ Pipeline::shuntNext()
             return;
         }
 
-        // Check if we are ready to dispatch more queries
-        if ( d->qidsState.count() >= d->maxConcurrentQueries )
+        // Check if we are ready to dispatch more queries. Whatever fits goes out as one
+        // batch, resolvers supporting it get all of theirs in a single call.
+        const int available = d->maxConcurrentQueries - d->qidsState.count();
+        if ( available <= 0 )
             return;
 
         /*
             Since resolvers are async, we now dispatch to the highest weighted ones
             and after timeout, dispatch to next highest etc, aborting when solved
         */
-        q = d->queries_pending.takeFirst();
-        q->setCurrentResolver( 0 );
+        while ( queries.count() < available && !d->queries_pending.isEmpty() )
+        {
+            query_ptr q = d->queries_pending.takeFirst();
+            q->setCurrentResolver( 0 );
+
+            if ( rc > 0 )
+                d->qidsState.insert( q->id(), rc );
+            queries << q;
+        }
+    }
+
+    if ( rc == 0 )
+    {
+        foreach ( const query_ptr& q, queries )
+            setQIDState( q, 0 );
+        return;
     }
 
-    setQIDState( q, rc );
+    new FuncTimeout( 0, boost::bind( &Pipeline::shuntBatch, this, queries ), this );
 }
 
 
 void
-Pipeline::timeoutShunt( const query_ptr& q )
+Pipeline::timeoutShunt( const query_ptr& q, unsigned int round )
 {
     Q_D( Pipeline );
     if ( !d->running )
         return;
 
-    // are we still waiting for a timeout?
-    if ( d->qidsTimeout.contains( q->id() ) )
+    // are we still waiting for this round to time out?
+    if ( d->qidsTimeout.value( q->id() ) == round )
     {
-        decQIDState( q );
+        {
+            QMutexLocker lock( &d->mut );
+            d->qidsTimedOut << q->id();
+
+            QMutexLocker statsLock( &d->statsMut );
+            d->stats.recordTimeout( q->id() );
+        }
+
+        // give up on everyone of the round who didn't answer yet
+        unsigned int inFlight;
+        {
+            QMutexLocker lock( &d->mut );
+            inFlight = d->qidsInFlight.value( q->id() ).count();
+            d->qidsInFlight.insert( q->id(), QList< Resolver* >() );
+        }
+        decQIDState( q, qMax( 1U, inFlight ) );
     }
 }
 
 
 void
 Pipeline::shunt( const query_ptr& q )
+{
+    shuntBatch( QList< query_ptr >() << q );
+}
+
+
+void
+Pipeline::shuntBatch( const QList< query_ptr >& queries )
 {
     Q_D( Pipeline );
     if ( !d->running )
         return;
 
-    Resolver* r = 0;
-    if ( !q->resolvingFinished() )
-        r = nextResolver( q );
-
-    if ( r )
+    // Group the queries by the resolvers they go to next, keeping their order
+    QList< Resolver* > resolvers;
+    QHash< Resolver*, QList< query_ptr > > batches;
+    foreach ( const query_ptr& q, queries )
     {
-        tLog( LOGVERBOSE ) << "Dispatching to resolver" << r->name() << q->toString() << q->solved() << q->id();
+        QList< Resolver* > next;
+        if ( !q->resolvingFinished() )
+        {
+            next = nextResolvers( q );
 
-        q->setCurrentResolver( r );
-        r->resolve( q );
-        emit resolving( q );
+            // Everyone we'd ask didn't find it last time, go on with the ones after them
+            while ( !next.isEmpty() && skipCachedResolvers( q, next ) > 0 && next.isEmpty() )
+                next = nextResolvers( q );
+        }
+
+        if ( next.isEmpty() )
+        {
+            // we get here if we disable a resolver while a query is resolving
+            setQIDState( q, 0 );
+            continue;
+        }
+
+        // A round only times out once its slowest resolver did, never if one of them doesn't
+        unsigned int timeout = 0;
+        foreach ( Resolver* r, next )
+        {
+            if ( r->timeout() == 0 )
+            {
+                timeout = 0;
+                break;
+            }
+            timeout = qMax( timeout, r->timeout() );
+        }
+
+        unsigned int round;
+        {
+            QMutexLocker lock( &d->mut );
+            round = ++d->rounds;
+
+            QList< QPointer< Resolver > >& dispatched = d->qidsDispatched[ q->id() ];
+            dispatched.clear();
+            foreach ( Resolver* r, next )
+                dispatched << r;
+            d->qidsInFlight.insert( q->id(), next );
 
-        if ( r->timeout() > 0 )
+            if ( timeout > 0 )
+                d->qidsTimeout.insert( q->id(), round );
+
+            QMutexLocker statsLock( &d->statsMut );
+            foreach ( Resolver* r, next )
+                d->stats.recordDispatched( q->id(), r->name() );
+        }
+
+        foreach ( Resolver* r, next )
         {
-            d->qidsTimeout.insert( q->id(), true );
-            new FuncTimeout( r->timeout(), boost::bind( &Pipeline::timeoutShunt, this, q ), this );
+            q->setCurrentResolver( r );
+
+            if ( !batches.contains( r ) )
+                resolvers << r;
+            batches[ r ] << q;
         }
+        emit resolving( q );
+
+        if ( timeout > 0 )
+            new FuncTimeout( timeout, boost::bind( &Pipeline::timeoutShunt, this, q, round ), this );
     }
-    else
+
+    foreach ( Resolver* r, resolvers )
     {
-        // we get here if we disable a resolver while a query is resolving
-        setQIDState( q, 0 );
-        return;
+        // Another resolver may have found a perfect result already
+        QList< query_ptr > batch;
+        foreach ( const query_ptr& q, batches.value( r ) )
+        {
+            if ( isResolving( q ) )
+                batch << q;
+        }
+        if ( batch.isEmpty() )
+            continue;
+
+        tLog( LOGVERBOSE ) << "Dispatching" << batch.count() << "queries to resolver" << r->name();
+        r->resolve( batch );
     }
 
     shuntNext();
@@ -605,30 +824,217 @@ Pipeline::nextResolver( const Tomahawk::query_ptr& query ) const
 }
 
 
-void
-Pipeline::setQIDState( const Tomahawk::query_ptr& query, int state )
+QList< Tomahawk::Resolver* >
+Pipeline::nextResolvers( const Tomahawk::query_ptr& query ) const
+{
+    Q_D( const Pipeline );
+    QList< Resolver* > next;
+
+    if ( d->dispatchMode == Sequential )
+    {
+        Resolver* r = nextResolver( query );
+        if ( r )
+            next << r;
+
+        return next;
+    }
+
+    unsigned int topWeight = 0;
+    foreach ( Resolver* r, d->resolvers )
+    {
+        if ( query->resolvedBy().contains( r ) )
+            continue;
+
+        if ( d->dispatchMode == Tiered && !next.isEmpty() )
+        {
+            if ( r->weight() < topWeight )
+                continue;
+            if ( r->weight() > topWeight )
+                next.clear();
+        }
+
+        topWeight = qMax( topWeight, r->weight() );
+        next << r;
+    }
+
+    return next;
+}
+
+
+bool
+Pipeline::solvedByTopResolver( const Tomahawk::query_ptr& query, const QList< result_ptr >& results ) const
+{
+    Q_D( const Pipeline );
+
+    // Resolvers asked later have a lower weight, only the ones asked together could beat us
+    unsigned int topWeight = 0;
+    foreach ( const QPointer< Resolver >& r, d->qidsDispatched.value( query->id() ) )
+    {
+        if ( !r.isNull() )
+            topWeight = qMax( topWeight, r.data()->weight() );
+    }
+
+    foreach ( const result_ptr& r, results )
+    {
+        if ( r->isOnline() && r->score() > 0.99 && !r->resolvedBy().isNull() && r->resolvedBy()->weight() >= topWeight )
+            return true;
+    }
+
+    return false;
+}
+
+
+bool
+Pipeline::solvedBy( const Tomahawk::query_ptr& query, const QList< result_ptr >& results ) const
+{
+    Q_D( const Pipeline );
+
+    // Unless everyone is asked one after the other, only the top weight of the round decides early
+    return query->solved() && !query->isFullTextQuery() &&
+           ( d->dispatchMode == Sequential || solvedByTopResolver( query, results ) );
+}
+
+
+unsigned int
+Pipeline::skipCachedResolvers( const Tomahawk::query_ptr& query, QList< Tomahawk::Resolver* >& next )
 {
     Q_D( Pipeline );
-    QMutexLocker lock( &d->mut );
+    ResolveCache* cache = ResolveCache::instance();
+    if ( !cache || query->isFullTextQuery() )
+        return 0;
+
+    unsigned int skipped = 0;
+    foreach ( Resolver* r, QList< Resolver* >( next ) )
+    {
+        QString resultHint;
+        switch ( cache->state( query, r->name(), &resultHint ) )
+        {
+            case ResolveCache::NotFound:
+            {
+                // Counts as asked, so we don't get it again from nextResolvers()
+                query->setCurrentResolver( r );
+                next.removeAll( r );
+                skipped++;
+
+                QMutexLocker lock( &d->statsMut );
+                d->stats.recordSkipped( r->name() );
+                break;
+            }
+
+            case ResolveCache::Found:
+                // A hint that turns out dead is dropped after its url check, and the
+                // query goes on. Don't even hand out the ones we know are dead.
+                if ( query->resultHint().isEmpty() && UrlCheckCache::instance()->state( resultHint ) != UrlCheckCache::Invalid )
+                    query->setResultHint( resultHint );
+                break;
+
+            case ResolveCache::Unknown:
+                break;
+        }
+    }
+
+    if ( skipped > 0 )
+    {
+        tDebug( LOGVERBOSE ) << "Skipping" << skipped << "resolvers which didn't find" << query->toString() << "before";
+
+        QMutexLocker lock( &d->mut );
+        if ( d->qidsState.contains( query->id() ) )
+        {
+            const unsigned int state = d->qidsState.value( query->id() );
+            d->qidsState.insert( query->id(), state > skipped ? state - skipped : 0 );
+        }
+    }
+
+    return skipped;
+}
+
 
-    if ( d->qidsTimeout.contains( query->id() ) )
-        d->qidsTimeout.remove( query->id() );
+void
+Pipeline::cacheAnswers( const Tomahawk::query_ptr& query, const QList< QPointer< Tomahawk::Resolver > >& asked, bool everyoneAnswered )
+{
+    ResolveCache* cache = ResolveCache::instance();
+    if ( !cache || query->isFullTextQuery() )
+        return;
 
-    if ( state > 0 )
+    const QList< result_ptr > results = query->results();
+    foreach ( const QPointer< Resolver >& r, asked )
     {
-        d->qidsState.insert( query->id(), state );
+        if ( r.isNull() )
+            continue;
 
-        new FuncTimeout( 0, boost::bind( &Pipeline::shunt, this, query ), this );
+        // Results are sorted by score, the first one of a resolver is its best
+        result_ptr found;
+        foreach ( const result_ptr& result, results )
+        {
+            if ( result->resolvedBy() == r.data() )
+            {
+                found = result;
+                break;
+            }
+        }
+
+        if ( !found.isNull() )
+            cache->setFound( query, r.data()->name(), found->url() );
+        else if ( everyoneAnswered )
+            cache->setNotFound( query, r.data()->name() );
     }
-    else
+}
+
+
+void
+Pipeline::setQIDState( const Tomahawk::query_ptr& query, int state )
+{
+    Q_D( Pipeline );
+    QList< QPointer< Resolver > > dispatched;
+    QList< QPointer< Resolver > > outstanding;
+    bool everyoneAnswered = false;
     {
-        d->qidsState.remove( query->id() );
-        query->onResolvingFinished();
+        QMutexLocker lock( &d->mut );
+
+        if ( d->qidsTimeout.contains( query->id() ) )
+            d->qidsTimeout.remove( query->id() );
+
+        dispatched = d->qidsDispatched.take( query->id() );
+        const bool timedOut = d->qidsTimedOut.remove( query->id() );
+        if ( !d->qidsInFlight.take( query->id() ).isEmpty() )
+            outstanding = dispatched;
+        else
+            everyoneAnswered = !timedOut;
+
+        if ( state > 0 )
+        {
+            d->qidsState.insert( query->id(), state );
+
+            new FuncTimeout( 0, boost::bind( &Pipeline::shunt, this, query ), this );
+        }
+        else
+        {
+            d->qidsState.remove( query->id() );
+            query->onResolvingFinished();
+
+            {
+                QMutexLocker statsLock( &d->statsMut );
+                d->stats.recordFinished( query->id(), query->solved() );
+            }
 
-        if ( !d->queries_temporary.contains( query ) )
-            d->qids.remove( query->id() );
+            if ( !d->queries_temporary.contains( query ) )
+                d->qids.remove( query->id() );
 
-        new FuncTimeout( 0, boost::bind( &Pipeline::shuntNext, this ), this );
+            new FuncTimeout( 0, boost::bind( &Pipeline::shuntNext, this ), this );
+        }
+    }
+
+    // Only a miss reported by everyone of the round is known to be theirs
+    cacheAnswers( query, dispatched, everyoneAnswered );
+
+    // Done before everyone asked answered, they don't need to bother anymore
+    if ( state <= 0 )
+    {
+        foreach ( const QPointer< Resolver >& r, outstanding )
+        {
+            if ( !r.isNull() )
+                r.data()->cancel( query );
+        }
     }
 }
 
@@ -651,7 +1057,7 @@ Pipeline::incQIDState( const Tomahawk::query_ptr& query )
 
 
 int
-Pipeline::decQIDState( const Tomahawk::query_ptr& query )
+Pipeline::decQIDState( const Tomahawk::query_ptr& query, unsigned int count )
 {
     Q_D( Pipeline );
     int state = 0;
@@ -661,14 +1067,51 @@ Pipeline::decQIDState( const Tomahawk::query_ptr& query )
         if ( !d->qidsState.contains( query->id() ) )
             return 0;
 
-        state = d->qidsState.value( query->id() ) - 1;
+        state = (int)d->qidsState.value( query->id() ) - (int)count;
+
+        // Others of this round are still to answer, wait for them before asking the next ones
+        if ( state > 0 && !d->qidsInFlight.value( query->id() ).isEmpty() )
+        {
+            d->qidsState.insert( query->id(), state );
+            return state;
+        }
+        d->qidsInFlight.remove( query->id() );
     }
 
+    // The round is over, a perfect result of anyone in it beats everyone asked later
+    if ( state > 0 && query->solved() && !query->isFullTextQuery() )
+        state = 0;
+
     setQIDState( query, state );
     return state;
 }
 
 
+void
+Pipeline::answered( const Tomahawk::query_ptr& query, Tomahawk::Resolver* resolver )
+{
+    Q_D( Pipeline );
+    {
+        QMutexLocker lock( &d->mut );
+
+        QMap< QID, QList< Resolver* > >::iterator it = d->qidsInFlight.find( query->id() );
+        if ( resolver )
+        {
+            // Late for a round we gave up on, it was accounted for when that timed out
+            if ( it == d->qidsInFlight.end() || !it->removeOne( resolver ) )
+                return;
+        }
+        else if ( it != d->qidsInFlight.end() && !it->isEmpty() )
+        {
+            // Don't know who it was, count it against the current round
+            it->removeFirst();
+        }
+    }
+
+    decQIDState( query );
+}
+
+
 void
 Pipeline::onTemporaryQueryTimer()
 {
@@ -23,6 +23,7 @@
 
 #include "DllMacro.h"
 #include "Typedefs.h"
+#include "PipelineStats.h"
 #include "Query.h"
 
 #include <QObject>
@@ -44,6 +45,19 @@ class DLLEXPORT Pipeline : public QObject
 Q_OBJECT
 
 public:
+    /**
+     * How a query is handed to the resolvers. Whatever the mode, resolvers
+     * with a higher weight() are asked first and a query is done once every
+     * resolver answered or timed out, or a perfect result (score 1.0) came
+     * from the highest weighted resolver still being asked.
+     */
+    enum DispatchMode
+    {
+        Sequential = 0, // one resolver at a time, next one after it answered or timed out
+        Tiered,         // all resolvers sharing the highest weight at once, then the next weight
+        Parallel        // all resolvers at once
+    };
+
     static Pipeline* instance();
 
     explicit Pipeline( QObject* parent = 0 );
@@ -54,6 +68,14 @@ public:
     unsigned int pendingQueryCount() const;
     unsigned int activeQueryCount() const;
 
+    DispatchMode dispatchMode() const;
+    void setDispatchMode( DispatchMode mode );
+
+    /**
+     * Resolvers should report with the overload naming themselves, without
+     * that an answer without results can't be told apart for the stats.
+     */
+    void reportResults( QID qid, Tomahawk::Resolver* resolver, const QList< result_ptr >& results );
     void reportResults( QID qid, const QList< result_ptr >& results );
     void reportAlbums( QID qid, const QList< album_ptr >& albums );
     void reportArtists( QID qid, const QList< artist_ptr >& artists );
@@ -73,11 +95,21 @@ public:
 
     bool isResolving( const query_ptr& q ) const;
 
+    // A snapshot of what happened to the queries since the start or the last resetStats()
+    Tomahawk::PipelineStats stats() const;
+    void resetStats();
+
 public slots:
     void resolve( const query_ptr& q, bool prioritized = true, bool temporaryQuery = false );
     void resolve( const QList<query_ptr>& qlist, bool prioritized = true, bool temporaryQuery = false );
     void resolve( QID qid, bool prioritized = true, bool temporaryQuery = false );
 
+    /**
+     * Drops queries that are still waiting to be dispatched from the queue.
+     * Queries already handed to a resolver are not affected.
+     */
+    void cancel( const QList<query_ptr>& qlist );
+
     void start();
     void stop();
     void databaseReady();
@@ -94,8 +126,9 @@ protected:
     QScopedPointer<PipelinePrivate> d_ptr;
 
 private slots:
-    void timeoutShunt( const query_ptr& q );
+    void timeoutShunt( const query_ptr& q, unsigned int round );
     void shunt( const query_ptr& q );
+    void shuntBatch( const QList< query_ptr >& queries );
     void shuntNext();
 
     void onTemporaryQueryTimer();
@@ -106,10 +139,18 @@ private:
 
     void addResultsToQuery( const query_ptr& query, const QList< result_ptr >& results );
     Tomahawk::Resolver* nextResolver( const Tomahawk::query_ptr& query ) const;
+    QList< Tomahawk::Resolver* > nextResolvers( const Tomahawk::query_ptr& query ) const;
+    bool solvedByTopResolver( const Tomahawk::query_ptr& query, const QList< result_ptr >& results ) const;
+    bool solvedBy( const Tomahawk::query_ptr& query, const QList< result_ptr >& results ) const;
+
+    // Takes the resolvers that didn't find query last time out of next, returns how many it took
+    unsigned int skipCachedResolvers( const Tomahawk::query_ptr& query, QList< Tomahawk::Resolver* >& next );
+    void cacheAnswers( const Tomahawk::query_ptr& query, const QList< QPointer< Tomahawk::Resolver > >& asked, bool everyoneAnswered );
 
     void setQIDState( const Tomahawk::query_ptr& query, int state );
     int incQIDState( const Tomahawk::query_ptr& query );
-    int decQIDState( const Tomahawk::query_ptr& query );
+    int decQIDState( const Tomahawk::query_ptr& query, unsigned int count = 1 );
+    void answered( const Tomahawk::query_ptr& query, Tomahawk::Resolver* resolver );
 };
 
 } // Tomahawk
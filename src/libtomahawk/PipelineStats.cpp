@@ -0,0 +1,309 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PipelineStats.h"
+
+using namespace Tomahawk;
+
+static const qint64 s_bounds[] = { 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000 };
+static const int s_boundCount = sizeof( s_bounds ) / sizeof( s_bounds[ 0 ] );
+
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets( s_boundCount + 1, 0 )
+    , m_count( 0 )
+    , m_total( 0 )
+    , m_max( 0 )
+{
+}
+
+
+void
+LatencyHistogram::add( qint64 ms )
+{
+    ms = qMax( Q_INT64_C( 0 ), ms );
+
+    int bucket = 0;
+    while ( bucket < s_boundCount && ms > s_bounds[ bucket ] )
+        bucket++;
+
+    m_buckets[ bucket ]++;
+    m_count++;
+    m_total += ms;
+    m_max = qMax( m_max, ms );
+}
+
+
+qint64
+LatencyHistogram::mean() const
+{
+    if ( !m_count )
+        return 0;
+
+    return m_total / (qint64)m_count;
+}
+
+
+qint64
+LatencyHistogram::percentile( int p ) const
+{
+    if ( !m_count )
+        return 0;
+
+    // The rank of the sample we're looking for, counting from 1
+    const quint64 rank = qMax( Q_UINT64_C( 1 ), ( m_count * qBound( 0, p, 100 ) + 99 ) / 100 );
+
+    quint64 seen = 0;
+    for ( int i = 0; i < s_boundCount; i++ )
+    {
+        seen += m_buckets.at( i );
+        if ( seen >= rank )
+            return qMin( s_bounds[ i ], m_max );
+    }
+
+    return m_max;
+}
+
+
+QList< qint64 >
+LatencyHistogram::bounds()
+{
+    QList< qint64 > bounds;
+    for ( int i = 0; i < s_boundCount; i++ )
+        bounds << s_bounds[ i ];
+
+    return bounds;
+}
+
+
+QVariantMap
+LatencyHistogram::toVariantMap() const
+{
+    QVariantList buckets;
+    for ( int i = 0; i < m_buckets.count(); i++ )
+    {
+        QVariantMap bucket;
+        bucket[ "le" ] = i < s_boundCount ? QVariant( (qlonglong)s_bounds[ i ] ) : QVariant( "inf" );
+        bucket[ "count" ] = (qlonglong)m_buckets.at( i );
+        buckets << bucket;
+    }
+
+    QVariantMap m;
+    m[ "count" ] = (qlonglong)m_count;
+    m[ "mean" ] = (qlonglong)mean();
+    m[ "p50" ] = (qlonglong)percentile( 50 );
+    m[ "p90" ] = (qlonglong)percentile( 90 );
+    m[ "p99" ] = (qlonglong)percentile( 99 );
+    m[ "max" ] = (qlonglong)m_max;
+    m[ "buckets" ] = buckets;
+
+    return m;
+}
+
+
+ResolverStats::ResolverStats()
+    : dispatched( 0 )
+    , answered( 0 )
+    , hits( 0 )
+    , timeouts( 0 )
+    , cancelled( 0 )
+    , skipped( 0 )
+{
+}
+
+
+qreal
+ResolverStats::hitRate() const
+{
+    if ( !answered )
+        return 0.0;
+
+    return (qreal)hits / (qreal)answered;
+}
+
+
+QVariantMap
+ResolverStats::toVariantMap() const
+{
+    QVariantMap m;
+    m[ "dispatched" ] = (qlonglong)dispatched;
+    m[ "answered" ] = (qlonglong)answered;
+    m[ "hits" ] = (qlonglong)hits;
+    m[ "hitrate" ] = hitRate();
+    m[ "timeouts" ] = (qlonglong)timeouts;
+    m[ "cancelled" ] = (qlonglong)cancelled;
+    m[ "skipped" ] = (qlonglong)skipped;
+    m[ "latency" ] = latency.toVariantMap();
+
+    return m;
+}
+
+
+PipelineStats::PipelineStats()
+    : m_queued( 0 )
+    , m_solved( 0 )
+    , m_finished( 0 )
+{
+    m_clock.start();
+}
+
+
+PipelineStats
+PipelineStats::snapshot() const
+{
+    PipelineStats s;
+    s.m_resolvers = m_resolvers;
+    s.m_queueWait = m_queueWait;
+    s.m_firstResult = m_firstResult;
+    s.m_queued = m_queued;
+    s.m_solved = m_solved;
+    s.m_finished = m_finished;
+
+    return s;
+}
+
+
+QStringList
+PipelineStats::resolvers() const
+{
+    QStringList names = m_resolvers.keys();
+    names.sort();
+
+    return names;
+}
+
+
+ResolverStats
+PipelineStats::resolver( const QString& name ) const
+{
+    return m_resolvers.value( name );
+}
+
+
+QVariantMap
+PipelineStats::toVariantMap() const
+{
+    QVariantMap resolvers;
+    foreach ( const QString& name, m_resolvers.keys() )
+        resolvers[ name ] = m_resolvers.value( name ).toVariantMap();
+
+    QVariantMap m;
+    m[ "queued" ] = (qlonglong)m_queued;
+    m[ "finished" ] = (qlonglong)m_finished;
+    m[ "solved" ] = (qlonglong)m_solved;
+    m[ "queuewait" ] = m_queueWait.toVariantMap();
+    m[ "firstresult" ] = m_firstResult.toVariantMap();
+    m[ "resolvers" ] = resolvers;
+
+    return m;
+}
+
+
+void
+PipelineStats::recordQueued( const QID& qid )
+{
+    if ( m_waitingForResult.contains( qid ) )
+        return;
+
+    m_queued++;
+    m_queuedAt.insert( qid, m_clock.elapsed() );
+    m_waitingForResult.insert( qid, m_clock.elapsed() );
+}
+
+
+void
+PipelineStats::recordDispatched( const QID& qid, const QString& resolver )
+{
+    QHash< QID, qint64 >::iterator it = m_queuedAt.find( qid );
+    if ( it != m_queuedAt.end() )
+    {
+        m_queueWait.add( m_clock.elapsed() - it.value() );
+        m_queuedAt.erase( it );
+    }
+
+    m_resolvers[ resolver ].dispatched++;
+    m_inFlight[ qid ].insert( resolver, m_clock.elapsed() );
+}
+
+
+void
+PipelineStats::recordSkipped( const QString& resolver )
+{
+    m_resolvers[ resolver ].skipped++;
+}
+
+
+void
+PipelineStats::recordAnswer( const QID& qid, const QString& resolver, bool hit )
+{
+    QHash< QID, QHash< QString, qint64 > >::iterator it = m_inFlight.find( qid );
+    if ( it == m_inFlight.end() || !it.value().contains( resolver ) )
+        return;
+
+    ResolverStats& stats = m_resolvers[ resolver ];
+    stats.answered++;
+    if ( hit )
+        stats.hits++;
+    stats.latency.add( m_clock.elapsed() - it.value().take( resolver ) );
+
+    if ( it.value().isEmpty() )
+        m_inFlight.erase( it );
+}
+
+
+void
+PipelineStats::recordResults( const QID& qid )
+{
+    QHash< QID, qint64 >::iterator it = m_waitingForResult.find( qid );
+    if ( it == m_waitingForResult.end() )
+        return;
+
+    m_firstResult.add( m_clock.elapsed() - it.value() );
+    m_waitingForResult.erase( it );
+}
+
+
+void
+PipelineStats::recordTimeout( const QID& qid )
+{
+    foreach ( const QString& resolver, m_inFlight.take( qid ).keys() )
+        m_resolvers[ resolver ].timeouts++;
+}
+
+
+void
+PipelineStats::recordFinished( const QID& qid, bool solved )
+{
+    foreach ( const QString& resolver, m_inFlight.take( qid ).keys() )
+        m_resolvers[ resolver ].cancelled++;
+
+    m_queuedAt.remove( qid );
+    m_waitingForResult.remove( qid );
+
+    m_finished++;
+    if ( solved )
+        m_solved++;
+}
+
+
+void
+PipelineStats::recordDropped( const QID& qid )
+{
+    m_queuedAt.remove( qid );
+    m_waitingForResult.remove( qid );
+}
@@ -0,0 +1,155 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include "DllMacro.h"
+#include "Typedefs.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+namespace Tomahawk
+{
+
+/**
+ * Durations in milliseconds, counted in buckets growing roughly by 2.5x
+ * from 5ms to 10s, plus one for everything slower.
+ */
+class DLLEXPORT LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void add( qint64 ms );
+
+    quint64 count() const { return m_count; }
+    qint64 mean() const;
+    qint64 max() const { return m_max; }
+
+    /**
+     * Upper bound of the bucket the p-th percentile (0 - 100) falls into,
+     * the maximum for the last bucket. 0 if nothing was added yet.
+     */
+    qint64 percentile( int p ) const;
+
+    // Upper bounds of all buckets but the last
+    static QList< qint64 > bounds();
+    QVector< quint64 > buckets() const { return m_buckets; }
+
+    QVariantMap toVariantMap() const;
+
+private:
+    QVector< quint64 > m_buckets;
+    quint64 m_count;
+    qint64 m_total;
+    qint64 m_max;
+};
+
+
+/**
+ * What a single resolver did with the queries the Pipeline handed it.
+ */
+struct DLLEXPORT ResolverStats
+{
+    ResolverStats();
+
+    quint64 dispatched; // queries handed to the resolver
+    quint64 answered;   // answers that arrived while the Pipeline still waited for them
+    quint64 hits;       // answers with at least one result
+    quint64 timeouts;   // the Pipeline gave up waiting
+    quint64 cancelled;  // not needed anymore before it answered
+    quint64 skipped;    // not asked, it didn't find the track last time
+    LatencyHistogram latency;
+
+    // Share of answers with results, 0 - 1
+    qreal hitRate() const;
+
+    QVariantMap toVariantMap() const;
+};
+
+
+/**
+ * Collects what happens to the queries going through the Pipeline, per
+ * resolver and overall. Pipeline::stats() hands out a snapshot to look at.
+ *
+ * Not thread safe, the Pipeline serializes access to its instance.
+ */
+class DLLEXPORT PipelineStats
+{
+public:
+    PipelineStats();
+
+    /**
+     * A copy of the totals, without what is tracked per query in flight.
+     * As the snapshot doesn't share that, the next record call doesn't
+     * have to copy it either.
+     */
+    PipelineStats snapshot() const;
+
+    // Names of all resolvers anything was recorded for
+    QStringList resolvers() const;
+    ResolverStats resolver( const QString& name ) const;
+
+    // From being queued with Pipeline::resolve() until handed to the first resolver
+    LatencyHistogram queueWait() const { return m_queueWait; }
+    // From being queued until the first result arrived
+    LatencyHistogram timeToFirstResult() const { return m_firstResult; }
+
+    quint64 queued() const { return m_queued; }
+    quint64 solved() const { return m_solved; }
+    quint64 finished() const { return m_finished; }
+
+    // Everything above, e.g. for the Playdar API
+    QVariantMap toVariantMap() const;
+
+    void recordQueued( const QID& qid );
+    void recordDispatched( const QID& qid, const QString& resolver );
+    void recordSkipped( const QString& resolver );
+    void recordAnswer( const QID& qid, const QString& resolver, bool hit );
+    void recordResults( const QID& qid );
+    // Everyone still to answer for qid timed out
+    void recordTimeout( const QID& qid );
+    // Everyone still to answer for qid isn't needed anymore
+    void recordFinished( const QID& qid, bool solved );
+    // Taken out of the queue before it was dispatched
+    void recordDropped( const QID& qid );
+
+private:
+    QElapsedTimer m_clock;
+
+    QHash< QString, ResolverStats > m_resolvers;
+    LatencyHistogram m_queueWait;
+    LatencyHistogram m_firstResult;
+    quint64 m_queued;
+    quint64 m_solved;
+    quint64 m_finished;
+
+    QHash< QID, qint64 > m_queuedAt;           // until first dispatched
+    QHash< QID, qint64 > m_waitingForResult;   // queued at, until the first result
+    QHash< QID, QHash< QString, qint64 > > m_inFlight; // dispatched at, per resolver
+};
+
+} // Tomahawk
+
+#endif // PIPELINESTATS_H
@@ -23,17 +23,24 @@
 
 #include "Pipeline.h"
 
+#include <QHash>
 #include <QMutex>
+#include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 namespace Tomahawk
 {
 
+class ResultUrlChecker;
+
 class PipelinePrivate
 {
 public:
     PipelinePrivate( Pipeline* q )
         : q_ptr( q )
+        , dispatchMode( Pipeline::Sequential )
+        , rounds( 0 )
         , running( false )
     {
     }
@@ -45,19 +52,30 @@ private:
     QList< Resolver* > resolvers;
     QList< QPointer<Tomahawk::ExternalResolver> > scriptResolvers;
     QList< ResolverFactoryFunc > resolverFactories;
-    QMap< QID, bool > qidsTimeout;
+    QMap< QID, unsigned int > qidsTimeout; // dispatch round we're waiting on the timeout of
     QMap< QID, unsigned int > qidsState;
+    // Resolvers of the current round yet to answer. A resolver is asked at most once per
+    // query, so who answered tells which round the answer belongs to. Never dereferenced.
+    QMap< QID, QList< Resolver* > > qidsInFlight;
+    QMap< QID, QList< QPointer< Resolver > > > qidsDispatched; // resolvers asked in the current round
+    QSet< QID > qidsTimedOut; // current round ended without everyone answering
     QMap< QID, query_ptr > qids;
     QMap< RID, result_ptr > rids;
+    QHash< ResultUrlChecker*, Resolver* > checkedFor; // who reported the results being checked
 
     QMutex mut; // for m_qids, m_rids
 
+    PipelineStats stats;
+    mutable QMutex statsMut; // always taken after mut, if both are needed
+
     // store queries here until DB index is loaded, then shunt them all
     QList< query_ptr > queries_pending;
     // store temporary queries here and clean up after timeout threshold
     QList< query_ptr > queries_temporary;
 
     int maxConcurrentQueries;
+    Pipeline::DispatchMode dispatchMode;
+    unsigned int rounds;
     bool running;
     QTimer temporaryQueryTimer;
 
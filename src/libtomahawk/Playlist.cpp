@@ -557,7 +557,8 @@ Playlist::resolve()
         qlist << p->query();
     }
 
-    Pipeline::instance()->resolve( qlist );
+    // Views bump whatever is on screen to the front of the queue
+    Pipeline::instance()->resolve( qlist, false );
 }
 
 
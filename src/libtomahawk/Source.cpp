@@ -29,6 +29,7 @@
 #include "database/DatabaseCommand_AddSource.h"
 #include "database/DatabaseCommand_CollectionStats.h"
 #include "database/DatabaseCommand_LoadAllSources.h"
+#include "database/DatabaseCommand_Replay.h"
 #include "database/DatabaseCommand_SocialAction.h"
 #include "database/DatabaseCommand_SourceOffline.h"
 #include "database/DatabaseCommand_UpdateSearchIndex.h"
@@ -43,6 +44,9 @@
 #include <QtAlgorithms>
 #include <QPainter>
 
+// How many ops of a peer get applied in one transaction
+#define REPLAY_BATCH_SIZE 1000
+
 using namespace Tomahawk;
 
 
@@ -715,28 +719,14 @@ Source::executeCommands()
     if ( commandsAvail )
     {
         QMutexLocker lock( &d->cmdMutex );
-        QList< Tomahawk::dbcmd_ptr > cmdGroup;
-        Tomahawk::dbcmd_ptr cmd = d->cmds.takeFirst();
-        while ( cmd->groupable() )
-        {
-            cmdGroup << cmd;
-            if ( !d->cmds.isEmpty() && d->cmds.first()->groupable() && d->cmds.first()->commandname() == cmd->commandname() )
-                cmd = d->cmds.takeFirst();
-            else
-                break;
-        }
+        const QList< Tomahawk::dbcmd_ptr > batch = d->cmds.mid( 0, REPLAY_BATCH_SIZE );
+        d->cmds.erase( d->cmds.begin(), d->cmds.begin() + batch.count() );
 
-        // return here when the last command finished
-        connect( cmd.data(), SIGNAL( finished() ), SLOT( executeCommands() ) );
+        d->replay = dbcmd_ptr( new DatabaseCommand_Replay( batch ) );
 
-        if ( cmdGroup.count() )
-        {
-            Database::instance()->enqueue( cmdGroup );
-        }
-        else
-        {
-            Database::instance()->enqueue( cmd );
-        }
+        // return here when the batch is done
+        connect( d->replay.data(), SIGNAL( finished() ), SLOT( onReplayFinished() ) );
+        Database::instance()->enqueue( d->replay );
 
         int percentage = ( float( d->commandCount - d->cmds.count() ) / (float)d->commandCount ) * 100.0;
         d->textStatus = tr( "Saving (%1%)" ).arg( percentage );
@@ -760,6 +750,28 @@ Source::executeCommands()
 }
 
 
+void
+Source::onReplayFinished()
+{
+    Q_D( Source );
+
+    const QSharedPointer< DatabaseCommand_Replay > replay = d->replay.objectCast< DatabaseCommand_Replay >();
+    d->replay.clear();
+
+    if ( replay && replay->failed() > 0 )
+    {
+        // The replay stopped at a failing op. What we got after it has to
+        // wait for the next sync, which starts at the last op applied.
+        QMutexLocker lock( &d->cmdMutex );
+        tLog() << Q_FUNC_INFO << "Dropping" << d->cmds.count() << "queued commands of" << friendlyName() << "after a failed replay";
+        d->cmds.clear();
+        d->lastCmdGuid.clear();
+    }
+
+    executeCommands();
+}
+
+
 void
 Source::reportSocialAttributesChanged( DatabaseCommand_SocialAction* action )
 {
@@ -149,6 +149,7 @@ private slots:
     void trackTimerFired();
 
     void executeCommands();
+    void onReplayFinished();
     void addCommand( const dbcmd_ptr& command );
 
 private:
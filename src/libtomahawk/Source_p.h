@@ -71,6 +71,7 @@ private:
 
     QPointer<ControlConnection> cc;
     QList< Tomahawk::dbcmd_ptr > cmds;
+    Tomahawk::dbcmd_ptr replay;
     int commandCount;
     QString lastCmdGuid;
     QMutex setControlConnectionMutex;
@@ -646,11 +646,12 @@ Track::composerPtr() const
 QPixmap
 Track::cover( const QSize& size, bool forceLoad ) const
 {
-    albumPtr()->cover( size, forceLoad );
+    const QPixmap cover = albumPtr()->cover( size, forceLoad );
     if ( albumPtr()->coverLoaded() )
     {
-        if ( !albumPtr()->cover( size ).isNull() )
-            return albumPtr()->cover( size );
+        // Still being scaled, don't show the artist in the meantime
+        if ( !cover.isNull() || albumPtr()->hasCover() )
+            return cover;
 
         return artistPtr()->cover( size, forceLoad );
     }
@@ -666,7 +667,7 @@ Track::coverLoaded() const
     if ( d->albumPtr.isNull() )
         return false;
 
-    if ( d->albumPtr->coverLoaded() && !d->albumPtr->cover( QSize( 0, 0 ) ).isNull() )
+    if ( d->albumPtr->coverLoaded() && d->albumPtr->hasCover() )
         return true;
 
     return d->artistPtr->coverLoaded();
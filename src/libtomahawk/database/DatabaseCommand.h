@@ -67,6 +67,11 @@ public:
     void postCommit() { postCommitHook(); emitCommitted(); }
     virtual void postCommitHook(){}
 
+    // When replaying a batch, a later command of the same batch is offered to
+    // the one before it. Returning true means our postCommitHook() takes care
+    // of its notifications as well, and its own hook is skipped.
+    virtual bool coalescePostCommit( DatabaseCommand* /*later*/ ) { return false; }
+
     void setSource( const Tomahawk::source_ptr& s );
     const Tomahawk::source_ptr& source() const;
 
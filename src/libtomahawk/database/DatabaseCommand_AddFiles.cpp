@@ -29,6 +29,7 @@
 #include "DatabaseImpl.h"
 #include "PlaylistEntry.h"
 #include "SourceList.h"
+#include "TrackSampleIndex.h"
 
 #include <QSqlQuery>
 
@@ -70,6 +71,18 @@ DatabaseCommand_AddFiles::postCommitHook()
 }
 
 
+bool
+DatabaseCommand_AddFiles::coalescePostCommit( DatabaseCommand* later )
+{
+    DatabaseCommand_AddFiles* cmd = qobject_cast< DatabaseCommand_AddFiles* >( later );
+    if ( !cmd || cmd->source() != source() )
+        return false;
+
+    m_ids << cmd->m_ids;
+    return true;
+}
+
+
 void
 DatabaseCommand_AddFiles::exec( DatabaseImpl* dbi )
 {
@@ -80,7 +93,7 @@ DatabaseCommand_AddFiles::exec( DatabaseImpl* dbi )
     TomahawkSqlQuery query_filejoin = dbi->newquery();
     TomahawkSqlQuery query_trackattr = dbi->newquery();
 
-    query_file.prepare( "INSERT INTO file(source, url, size, mtime, md5, mimetype, duration, bitrate) VALUES (?, ?, ?, ?, ?, ?, ?, ?)" );
+    query_file.prepare( "INSERT INTO file(source, url, dir, size, mtime, md5, mimetype, duration, bitrate) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)" );
     query_filejoin.prepare( "INSERT INTO file_join(file, artist, album, track, albumpos, composer, discnumber) VALUES (?, ?, ?, ?, ?, ?, ?)" );
     query_trackattr.prepare( "INSERT INTO track_attributes(id, k, v) VALUES (?, ?, ?)" );
 
@@ -113,12 +126,13 @@ DatabaseCommand_AddFiles::exec( DatabaseImpl* dbi )
 
         query_file.bindValue( 0, srcid );
         query_file.bindValue( 1, url );
-        query_file.bindValue( 2, size );
-        query_file.bindValue( 3, mtime );
-        query_file.bindValue( 4, hash );
-        query_file.bindValue( 5, mimetype );
-        query_file.bindValue( 6, duration );
-        query_file.bindValue( 7, bitrate );
+        query_file.bindValue( 2, source()->isLocal() ? QVariant( DatabaseImpl::directoryOfUrl( url ) ) : QVariant( QVariant::String ) );
+        query_file.bindValue( 3, size );
+        query_file.bindValue( 4, mtime );
+        query_file.bindValue( 5, hash );
+        query_file.bindValue( 6, mimetype );
+        query_file.bindValue( 7, duration );
+        query_file.bindValue( 8, bitrate );
         query_file.exec();
 
         if ( added % 1000 == 0 )
@@ -160,6 +174,8 @@ DatabaseCommand_AddFiles::exec( DatabaseImpl* dbi )
         query_trackattr.bindValue( 2, year );
         query_trackattr.exec();
 
+        dbi->sampleIndex()->insert( trackid, artistid, albumid, year );
+
         m_ids << fileid;
         added++;
     }
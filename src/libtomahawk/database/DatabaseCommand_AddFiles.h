@@ -52,6 +52,7 @@ public:
     virtual void exec( DatabaseImpl* );
     virtual bool doesMutates() const { return true; }
     virtual void postCommitHook();
+    virtual bool coalescePostCommit( DatabaseCommand* later );
 
     QVariantList files() const;
     void setFiles( const QVariantList& f ) { m_files = f; }
@@ -66,14 +66,7 @@ DatabaseCommand_AllArtists::exec( DatabaseImpl* dbi )
 
     if ( !m_filter.isEmpty() )
     {
-        QString filtersql;
-        QStringList sl = m_filter.split( " ", QString::SkipEmptyParts );
-        foreach( QString s, sl )
-        {
-            filtersql += QString( " AND ( artist.name LIKE '%%1%' OR album.name LIKE '%%1%' OR track.name LIKE '%%1%' )" ).arg( TomahawkSqlQuery::escape( s ) );
-        }
-
-        filterToken = QString( "AND file_join.track = track.id %1" ).arg( filtersql );
+        filterToken = QString( "AND file_join.track = track.id %1" ).arg( dbi->collectionFilterSql( m_filter ) );
         joins = "LEFT JOIN album ON album.id = file_join.album";
         tables = "artist, track, file, file_join";
     }
@@ -46,10 +46,10 @@ DatabaseCommand_ArtistStats::exec( DatabaseImpl* dbi )
 {
     TomahawkSqlQuery query = dbi->newquery();
 
-    query.prepare( "SELECT COUNT(*) AS counter, artist.id "
-                   "FROM playback_log, track, artist "
-                   "WHERE playback_log.source IS NULL AND track.id = playback_log.track AND artist.id = track.artist "
-                   "GROUP BY track.artist "
+    query.prepare( "SELECT SUM(plays) AS counter, artist "
+                   "FROM playback_log_daily "
+                   "WHERE source = 0 "
+                   "GROUP BY artist "
                    "ORDER BY counter DESC" );
     query.exec();
 
@@ -90,15 +90,43 @@ DatabaseCommand_CalculatePlaytime::exec( DatabaseImpl *dbi )
 {
     Q_D( DatabaseCommand_CalculatePlaytime );
 
+    // Whole days are summed up from the rollup table, only the partial days
+    // at both ends of the range have to be read from playback_log itself.
+    const uint from = d->from.toTime_t();
+    const uint to = d->to.toTime_t();
+    const uint firstDay = ( from + 86399 ) / 86400;
+    const uint endDay = ( to + 1 ) / 86400;
+
+    QString plays;
+    if ( firstDay < endDay )
+    {
+        plays = QString(
+                    " SELECT track, secs_played FROM playback_log_daily "
+                    " WHERE day >= %1 AND day < %2 "
+                    " UNION ALL "
+                    " SELECT track, secs_played FROM playback_log "
+                    " WHERE ( playtime >= %3 AND playtime < %4 ) OR ( playtime >= %5 AND playtime <= %6 ) "
+                    ).arg( firstDay ).arg( endDay )
+                     .arg( from ).arg( firstDay * 86400 )
+                     .arg( endDay * 86400 ).arg( to );
+    }
+    else
+    {
+        plays = QString(
+                    " SELECT track, secs_played FROM playback_log "
+                    " WHERE playtime >= %1 AND playtime <= %2 "
+                    ).arg( from ).arg( to );
+    }
+
     QString sql;
 
     if ( d->plEntryIds.isEmpty() )
     {
         sql = QString(
                     " SELECT SUM(pl.secs_played) "
-                    " FROM playback_log pl "
-                    " WHERE track in ( %1 ) AND playtime >= %2 AND playtime <= %3 "
-                    ).arg( d->trackIds.join(", ") ).arg( d->from.toTime_t() ).arg( d->to.toTime_t() );
+                    " FROM ( %1 ) pl "
+                    " WHERE pl.track in ( %2 ) "
+                    ).arg( plays ).arg( d->trackIds.join(", ") );
     }
     else
     {
@@ -113,13 +141,11 @@ DatabaseCommand_CalculatePlaytime::exec( DatabaseImpl *dbi )
                     " FROM playlist_item pi "
                     " JOIN track t ON pi.trackname = t.name "
                     " JOIN artist a ON a.name = pi.artistname AND t.artist = a.id "
-                    " JOIN playback_log pl ON pl.track = t.id "
-                    " WHERE pi.guid IN (%1) "
-                    " AND pl.playtime >= %2 AND pl.playtime <= %3 "
+                    " JOIN ( %1 ) pl ON pl.track = t.id "
+                    " WHERE pi.guid IN (%2) "
                     )
-                .arg( d->plEntryIds.join(", ") )
-                .arg( d->from.toTime_t() )
-                .arg( d->to.toTime_t() );
+                .arg( plays )
+                .arg( d->plEntryIds.join(", ") );
 
     }
 
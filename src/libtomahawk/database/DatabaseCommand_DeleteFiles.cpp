@@ -24,6 +24,7 @@
 #include "collection/Collection.h"
 #include "database/Database.h"
 #include "database/DatabaseImpl.h"
+#include "database/TrackSampleIndex.h"
 #include "network/Servent.h"
 #include "utils/Logger.h"
 #include "utils/TomahawkUtils.h"
@@ -58,6 +59,18 @@ DatabaseCommand_DeleteFiles::postCommitHook()
 }
 
 
+bool
+DatabaseCommand_DeleteFiles::coalescePostCommit( DatabaseCommand* later )
+{
+    DatabaseCommand_DeleteFiles* cmd = qobject_cast< DatabaseCommand_DeleteFiles* >( later );
+    if ( !cmd || cmd->source() != source() )
+        return false;
+
+    m_idList << cmd->m_idList;
+    return true;
+}
+
+
 void
 DatabaseCommand_DeleteFiles::exec( DatabaseImpl* dbi )
 {
@@ -82,8 +95,8 @@ DatabaseCommand_DeleteFiles::exec( DatabaseImpl* dbi )
         {
             tDebug() << "Deleting" << m_dir.path() << "from db for localsource" << srcid;
             TomahawkSqlQuery dirquery = dbi->newquery();
-            QString path( "file://" + m_dir.canonicalPath() + "/%" );
-            dirquery.prepare( QString( "SELECT id FROM file WHERE source IS NULL AND url LIKE '%1'" ).arg( TomahawkSqlQuery::escape( path ) ) );
+            const QString dir = "file://" + m_dir.canonicalPath();
+            dirquery.prepare( "SELECT id FROM file WHERE source IS NULL" + DatabaseImpl::directoryFilterSql( dir ) );
             dirquery.exec();
 
             while ( dirquery.next() )
@@ -108,35 +121,38 @@ DatabaseCommand_DeleteFiles::exec( DatabaseImpl* dbi )
     }
     else if ( !m_ids.isEmpty() )
     {
-        QString idstring;
-        foreach ( const QVariant& id, m_ids )
-            idstring.append( id.toString() + ", " );
-        idstring.chop( 2 ); //remove the trailing ", "
-
         if ( !source()->isLocal() )
         {
-            delquery.prepare( QString( "SELECT id FROM file WHERE source = %1 AND url IN ( %2 )" )
-                        .arg( source()->id() )
-                        .arg( idstring ) );
-            delquery.exec();
-            
-            idstring = QString();
-            while ( delquery.next() )
+            // Remote files are known by the id they have on the peer, which is their url here
+            TomahawkSqlQuery idquery = dbi->newquery();
+            idquery.prepare( "SELECT id FROM file WHERE source = ? AND url = ?" );
+            foreach ( const QVariant& id, m_ids )
             {
-                idstring.append( delquery.value( 0 ).toString() + ", " );
-                m_idList << delquery.value( 0 ).toUInt();
+                idquery.bindValue( 0, srcid );
+                idquery.bindValue( 1, id.toString() );
+                idquery.exec();
+
+                if ( idquery.next() )
+                    m_idList << idquery.value( 0 ).toUInt();
             }
-            idstring.chop( 2 ); //remove the trailing ", "
         }
 
-        delquery.prepare( QString( "DELETE FROM file WHERE source %1 AND id IN ( %2 )" )
-                             .arg( source()->isLocal() ? "IS NULL" : QString( "= %1" ).arg( source()->id() ) )
-                             .arg( idstring ) );
-        delquery.exec();
+        delquery.prepare( QString( "DELETE FROM file WHERE source %1 AND id = ?" )
+                             .arg( source()->isLocal() ? "IS NULL" : QString( "= %1" ).arg( source()->id() ) ) );
+        foreach ( unsigned int id, m_idList )
+        {
+            delquery.bindValue( 0, id );
+            delquery.exec();
+        }
     }
 
     if ( m_idList.count() )
+    {
         source()->updateIndexWhenSynced();
 
+        // Cheaper to load it again when it is needed next than to find out which tracks are gone
+        dbi->sampleIndex()->clear();
+    }
+
     emit done( m_idList, source()->dbCollection() );
 }
@@ -69,6 +69,7 @@ public:
     virtual bool localOnly() const { return false; }
     virtual bool groupable() const { return true; }
     virtual void postCommitHook();
+    virtual bool coalescePostCommit( DatabaseCommand* later );
 
     QVariantList ids() const { return m_ids; }
     void setIds( const QVariantList& i ) { m_ids = i; }
@@ -70,12 +70,9 @@ void
 DatabaseCommand_FileMtimes::execSelectPath( DatabaseImpl *dbi, const QDir& path, QMap<QString, QMap< unsigned int, unsigned int > > &mtimes )
 {
     TomahawkSqlQuery query = dbi->newquery();
-    query.prepare( QString( "SELECT url, id, mtime "
-                            "FROM file "
-                            "WHERE source IS NULL "
-                            "AND url LIKE :prefix" ) );
-
-    query.bindValue( ":prefix", "file://" + path.canonicalPath() + "%" );
+    query.prepare( "SELECT url, id, mtime "
+                   "FROM file "
+                   "WHERE source IS NULL" + DatabaseImpl::directoryFilterSql( "file://" + path.canonicalPath() ) );
     query.exec();
 
     while( query.next() )
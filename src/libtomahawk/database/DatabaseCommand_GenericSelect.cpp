@@ -27,6 +27,8 @@
 #include "PlaylistEntry.h"
 #include "SourceList.h"
 
+#include <QSqlRecord>
+
 using namespace Tomahawk;
 
 
@@ -36,6 +38,7 @@ DatabaseCommand_GenericSelect::DatabaseCommand_GenericSelect( const QString& sql
     , m_queryType( type )
     , m_limit( limit )
     , m_raw( false )
+    , m_pageSize( 0 )
 {
 }
 
@@ -45,107 +48,153 @@ DatabaseCommand_GenericSelect::DatabaseCommand_GenericSelect( const QString& sql
     , m_queryType( type )
     , m_limit( -1 )
     , m_raw( rawData )
+    , m_pageSize( 0 )
 {
 }
 
+void
+DatabaseCommand_GenericSelect::cancel()
+{
+    m_cancelled.fetchAndStoreRelease( 1 );
+}
+
+
+bool
+DatabaseCommand_GenericSelect::isCancelled() const
+{
+    return m_cancelled.fetchAndAddAcquire( 0 );
+}
+
+
 void
 DatabaseCommand_GenericSelect::exec( DatabaseImpl* dbi )
 {
+    if ( isCancelled() )
+        return;
+
     TomahawkSqlQuery query = dbi->newquery();
 
+    // We only walk the rows once, the driver doesn't have to keep them around
+    query.setForwardOnly( true );
     query.prepare( QString( "%1 %2;" ).arg( m_sqlSelect ).arg( m_limit > -1 ? QString( " LIMIT %1" ).arg( m_limit ) : QString() ) );
     query.exec();
 
+    // Any columns after the first two are extra data
+    const int columns = query.record().count();
+
     QList< query_ptr > queries;
     QList< artist_ptr > arts;
     QList< album_ptr > albs;
+    QList< QStringList > rawDataItems;
+    int rows = 0;
 
-    if ( m_raw )
+    while ( query.next() )
     {
-        QList< QStringList > rawDataItems;
+        if ( isCancelled() )
+        {
+            tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Cancelled after" << rows << "rows";
+            return;
+        }
 
-        while( query.next() )
+        if ( m_raw )
         {
             QStringList rawRow;
-            int count = 0;
-            while ( query.value( count ).isValid() )
-            {
-                rawRow << query.value( count ).toString();
-                ++count;
-            }
+            for ( int i = 0; i < columns; i++ )
+                rawRow << query.value( i ).toString();
+
             rawDataItems << rawRow;
         }
-        emit rawData( rawDataItems );
-        return;
-    }
+        else
+        {
+            query_ptr qry;
+            artist_ptr artist;
+            album_ptr album;
 
-    // Expecting
-    while ( query.next() )
-    {
-        query_ptr qry;
-        artist_ptr artist;
-        album_ptr album;
+            if ( m_queryType == Track )
+            {
+                QString artist, track;
+                track = query.value( 0 ).toString();
+                artist = query.value( 1 ).toString();
 
-        if ( m_queryType == Track )
-        {
-            QString artist, track;
-            track = query.value( 0 ).toString();
-            artist = query.value( 1 ).toString();
+                qry = Tomahawk::Query::get( artist, track, QString() );
+                if ( qry.isNull() )
+                    continue;
+            }
+            else if ( m_queryType == Artist )
+            {
+                int artistId = query.value( 0 ).toInt();
+                QString artistName = query.value( 1 ).toString();
 
-            qry = Tomahawk::Query::get( artist, track, QString() );
-            if ( qry.isNull() )
-                continue;
-        }
-        else if ( m_queryType == Artist )
-        {
-            int artistId = query.value( 0 ).toInt();
-            QString artistName = query.value( 1 ).toString();
+                artist = Tomahawk::Artist::get( artistId, artistName );
+            }
+            else if ( m_queryType == Album )
+            {
+                int albumId = query.value( 0 ).toInt();
+                QString albumName = query.value( 1 ).toString();
+                int artistId = query.value( 2 ).toInt();
+                QString artistName = query.value( 3 ).toString();
 
-            artist = Tomahawk::Artist::get( artistId, artistName );
-        }
-        else if ( m_queryType == Album )
-        {
-            int albumId = query.value( 0 ).toInt();
-            QString albumName = query.value( 1 ).toString();
-            int artistId = query.value( 2 ).toInt();
-            QString artistName = query.value( 3 ).toString();
+                artist = Tomahawk::Artist::get( artistId, artistName );
+                album = Tomahawk::Album::get( albumId, albumName, artist );
+            }
 
-            artist = Tomahawk::Artist::get( artistId, artistName );
-            album = Tomahawk::Album::get( albumId, albumName, artist );
-        }
+            QVariantList extraData;
+            for ( int i = 2; i < columns; i++ )
+                extraData << query.value( i );
 
-        QVariantList extraData;
-        int count = 2;
-        while ( query.value( count ).isValid() )
-        {
-            extraData << query.value( count );
-            count++;
+            if ( m_queryType == Track )
+            {
+                if ( !extraData.isEmpty() )
+                    qry->setProperty( "data", extraData );
+                queries << qry;
+            }
+            else if ( m_queryType == Artist )
+            {
+                if ( !extraData.isEmpty() )
+                    artist->setProperty( "data", extraData );
+                arts << artist;
+            }
+            else if ( m_queryType == Album )
+            {
+                if ( !extraData.isEmpty() )
+                    album->setProperty( "data", extraData );
+                albs << album;
+            }
         }
 
-        if ( m_queryType == Track )
+        if ( ++rows == m_pageSize )
         {
-            if ( !extraData.isEmpty() )
-                qry->setProperty( "data", extraData );
-            queries << qry;
-        }
-        else if ( m_queryType == Artist )
-        {
-            if ( !extraData.isEmpty() )
-                artist->setProperty( "data", extraData );
-            arts << artist;
-        }
-        else if ( m_queryType == Album )
-        {
-            if ( !extraData.isEmpty() )
-                album->setProperty( "data", extraData );
-            albs << album;
+            emitResults( queries, arts, albs, rawDataItems );
+            rows = 0;
         }
     }
 
-    if ( m_queryType == Track )
+    if ( isCancelled() )
+        return;
+
+    // Without paging this is everything, even if there's nothing. Otherwise
+    // what is left over from the last page, if anything.
+    if ( m_pageSize <= 0 || rows > 0 )
+        emitResults( queries, arts, albs, rawDataItems );
+
+    emit done();
+}
+
+
+void
+DatabaseCommand_GenericSelect::emitResults( QList< query_ptr >& queries, QList< artist_ptr >& arts, QList< album_ptr >& albs, QList< QStringList >& rawDataItems )
+{
+    if ( m_raw )
+        emit rawData( rawDataItems );
+    else if ( m_queryType == Track )
         emit tracks( queries );
     else if ( m_queryType == Artist )
         emit artists( arts );
     else if ( m_queryType == Album )
         emit albums( albs );
+
+    queries.clear();
+    arts.clear();
+    albs.clear();
+    rawDataItems.clear();
 }
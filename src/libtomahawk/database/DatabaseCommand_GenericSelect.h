@@ -24,6 +24,7 @@
 #include "DatabaseCommand.h"
 #include "Typedefs.h"
 
+#include <QAtomicInt>
 #include <QStringList>
 #include <QMetaType>
 
@@ -53,6 +54,8 @@ namespace Tomahawk
  *      * Do not trail your SQL command with ;
  *      * Do not use the LIMIT command if you pass limitResults > -1
  *
+ * By default all results are emitted at once when the query is done. With a page size set, they are
+ * emitted in chunks of that many rows while the rows are read, followed by done().
  */
 class DLLEXPORT DatabaseCommand_GenericSelect : public DatabaseCommand
 {
@@ -72,17 +75,40 @@ public:
 
     virtual QString commandname() const { return "genericselect"; }
 
+    /**
+     * Emit the results in chunks of pageSize rows, 0 for all of them at once.
+     */
+    void setPageSize( int pageSize ) { m_pageSize = pageSize; }
+    int pageSize() const { return m_pageSize; }
+
+    /**
+     * Stops reading rows, nothing is emitted afterwards. Can be called from
+     * any thread, e.g. by a requester that isn't interested anymore.
+     */
+    void cancel();
+    bool isCancelled() const;
+
 signals:
     void tracks( const QList< Tomahawk::query_ptr >& tracks );
     void artists( const QList< Tomahawk::artist_ptr >& artists );
     void albums( const QList< Tomahawk::album_ptr >& albums );
 
     void rawData( const QList< QStringList >& data );
+
+    // Right after the last results, unless cancelled. finished() comes later, once the
+    // worker is done with the command, and also after a cancel.
+    void done();
+
 private:
+    void emitResults( QList< Tomahawk::query_ptr >& queries, QList< Tomahawk::artist_ptr >& arts,
+                      QList< Tomahawk::album_ptr >& albs, QList< QStringList >& rawDataItems );
+
     QString m_sqlSelect;
     QueryType m_queryType;
     int m_limit;
     bool m_raw;
+    int m_pageSize;
+    mutable QAtomicInt m_cancelled;
 };
 
 }
@@ -100,7 +100,13 @@ DatabaseCommand_LoadAllPlaylists::exec( DatabaseImpl* dbi )
 
         if ( d->returnPlEntryIds )
         {
-            QStringList trackIds = TomahawkUtils::parseJson( query.value( 8 ).toByteArray() ).toStringList();
+            // revisions stored as a delta have to be rebuilt from their history
+            QStringList trackIds;
+            if ( query.value( 8 ).isNull() )
+                trackIds = dbi->playlistRevisionEntries( query.value( 6 ).toString() );
+            else
+                trackIds = TomahawkUtils::parseJson( query.value( 8 ).toByteArray() ).toStringList();
+
             phash.insert( p, trackIds );
         }
     }
@@ -18,7 +18,6 @@
 
 #include "DatabaseCommand_LoadPlaylistEntries.h"
 
-#include "utils/Json.h"
 #include "utils/Logger.h"
 
 #include "DatabaseImpl.h"
@@ -27,9 +26,20 @@
 #include "Source.h"
 
 #include <QSqlQuery>
+#include <QVector>
+
+#define LOAD_CHUNK_SIZE 500 // SQLite can't bind more than 999 values to a single statement
 
 using namespace Tomahawk;
 
+namespace {
+    struct PlaylistItemRow
+    {
+        QString guid, track, artist, album, annotation, resultHint;
+        unsigned int duration;
+    };
+}
+
 
 void
 DatabaseCommand_LoadPlaylistEntries::exec( DatabaseImpl* dbi )
@@ -44,7 +54,7 @@ void
 DatabaseCommand_LoadPlaylistEntries::generateEntries( DatabaseImpl* dbi )
 {
     TomahawkSqlQuery query_entries = dbi->newquery();
-    query_entries.prepare( "SELECT entries, playlist, author, timestamp, previous_revision "
+    query_entries.prepare( "SELECT entries IS NULL AND delta IS NULL, playlist, author, timestamp, previous_revision "
                            "FROM playlist_revision "
                            "WHERE guid = :guid" );
     query_entries.bindValue( ":guid", m_revguid );
@@ -52,49 +62,14 @@ DatabaseCommand_LoadPlaylistEntries::generateEntries( DatabaseImpl* dbi )
 
     tLog( LOGVERBOSE ) << "trying to load playlist entries for guid:" << m_revguid;
     QString prevrev;
-    bool ok;
 
     if ( query_entries.next() )
     {
-        if ( !query_entries.value( 0 ).isNull() )
+        if ( !query_entries.value( 0 ).toBool() )
         {
-            // entries should be a list of strings:
-            QVariant v = TomahawkUtils::parseJson( query_entries.value( 0 ).toByteArray(), &ok );
-            Q_ASSERT( ok && v.type() == QVariant::List ); //TODO
-
-            m_guids = v.toStringList();
-            QString inclause = QString( "('%1')" ).arg( m_guids.join( "', '" ) );
-
-            TomahawkSqlQuery query = dbi->newquery();
-            QString sql = QString( "SELECT guid, trackname, artistname, albumname, annotation, "
-                                "duration, addedon, addedby, result_hint "
-                                "FROM playlist_item "
-                                "WHERE guid IN %1" ).arg( inclause );
-
-            query.exec( sql );
-            while ( query.next() )
-            {
-                plentry_ptr e( new PlaylistEntry );
-                e->setGuid( query.value( 0 ).toString() );
-                e->setAnnotation( query.value( 4 ).toString() );
-                e->setDuration( query.value( 5 ).toUInt() );
-                e->setLastmodified( 0 ); // TODO e->lastmodified = query.value( 6 ).toInt();
-                const QString resultHint = query.value( 8 ).toString();
-                e->setResultHint( resultHint );
-
-                Tomahawk::query_ptr q = Tomahawk::Query::get( query.value( 2 ).toString(), query.value( 1 ).toString(), query.value( 3 ).toString() );
-                if ( q.isNull() )
-                    continue;
-
-                q->setResultHint( resultHint );
-                if ( resultHint.startsWith( "http" ) )
-                    q->setSaveHTTPResultHint( true );
-
-                q->setProperty( "annotation", e->annotation() );
-                e->setQuery( q );
-
-                m_entrymap.insert( e->guid(), e );
-            }
+            // rebuilt from the last full list of entries plus all deltas since then
+            m_guids = dbi->playlistRevisionEntries( m_revguid );
+            loadEntries( dbi );
         }
 
         prevrev = query_entries.value( 4 ).toString();
@@ -107,7 +82,7 @@ DatabaseCommand_LoadPlaylistEntries::generateEntries( DatabaseImpl* dbi )
     if ( prevrev.length() )
     {
         TomahawkSqlQuery query_entries_old = dbi->newquery();
-        query_entries_old.prepare( "SELECT entries, "
+        query_entries_old.prepare( "SELECT entries IS NULL AND delta IS NULL, "
                                    "(SELECT currentrevision = ? FROM playlist WHERE guid = ?) "
                                    "FROM playlist_revision "
                                    "WHERE guid = ?" );
@@ -122,18 +97,88 @@ DatabaseCommand_LoadPlaylistEntries::generateEntries( DatabaseImpl* dbi )
             Q_ASSERT( false );
         }
 
-        if ( !query_entries_old.value( 0 ).isNull() )
-        {
-            QVariant v = TomahawkUtils::parseJson( query_entries_old.value( 0 ).toByteArray(), &ok );
-            Q_ASSERT( ok && v.type() == QVariant::List ); //TODO
-            m_oldentries = v.toStringList();
-        }
+        if ( !query_entries_old.value( 0 ).toBool() )
+            m_oldentries = dbi->playlistRevisionEntries( prevrev );
         m_islatest = query_entries_old.value( 1 ).toBool();
     }
 
 //    qDebug() << Q_FUNC_INFO << "entrymap:" << m_entrymap;
 }
 
+void
+DatabaseCommand_LoadPlaylistEntries::loadEntries( DatabaseImpl* dbi )
+{
+    // Bind the guids in fixed size chunks, so the statement only has to be prepared
+    // once instead of parsing one huge IN clause with every guid inlined.
+    TomahawkSqlQuery query = dbi->newquery();
+    query.setForwardOnly( true );
+
+    QVector< PlaylistItemRow > rows;
+    rows.reserve( qMin( m_guids.count(), LOAD_CHUNK_SIZE ) );
+
+    int preparedSize = 0;
+    for ( int offset = 0; offset < m_guids.count(); offset += LOAD_CHUNK_SIZE )
+    {
+        const int size = qMin( LOAD_CHUNK_SIZE, m_guids.count() - offset );
+        if ( size != preparedSize )
+        {
+            QStringList placeholders;
+            for ( int i = 0; i < size; i++ )
+                placeholders << "?";
+
+            query.prepare( QString( "SELECT guid, trackname, artistname, albumname, annotation, "
+                                    "duration, addedon, addedby, result_hint "
+                                    "FROM playlist_item "
+                                    "WHERE guid IN (%1)" ).arg( placeholders.join( "," ) ) );
+            preparedSize = size;
+        }
+
+        for ( int i = 0; i < size; i++ )
+            query.bindValue( i, m_guids.at( offset + i ) );
+        query.exec();
+
+        // Read the whole chunk first, so the statement is done before we create any queries
+        rows.clear();
+        while ( query.next() )
+        {
+            PlaylistItemRow row;
+            row.guid = query.value( 0 ).toString();
+            row.track = query.value( 1 ).toString();
+            row.artist = query.value( 2 ).toString();
+            row.album = query.value( 3 ).toString();
+            row.annotation = query.value( 4 ).toString();
+            row.duration = query.value( 5 ).toUInt();
+            row.resultHint = query.value( 8 ).toString();
+            rows << row;
+        }
+        query.finish();
+
+        foreach ( const PlaylistItemRow& row, rows )
+        {
+            plentry_ptr e( new PlaylistEntry );
+            e->setGuid( row.guid );
+            e->setAnnotation( row.annotation );
+            e->setDuration( row.duration );
+            e->setLastmodified( 0 );
+            e->setResultHint( row.resultHint );
+
+            Tomahawk::query_ptr q = Tomahawk::Query::get( row.artist, row.track, row.album );
+            if ( q.isNull() )
+                continue;
+
+            q->setResultHint( row.resultHint );
+            if ( row.resultHint.startsWith( "http" ) )
+                q->setSaveHTTPResultHint( true );
+
+            q->setProperty( "annotation", row.annotation );
+            e->setQuery( q );
+
+            m_entrymap.insert( e->guid(), e );
+        }
+    }
+}
+
+
 DatabaseCommand_LoadPlaylistEntries::DatabaseCommand_LoadPlaylistEntries( QString revision_guid, QObject *parent )
     : DatabaseCommand( parent )
     , m_islatest( true )
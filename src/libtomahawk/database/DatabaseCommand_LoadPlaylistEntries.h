@@ -54,6 +54,7 @@ signals:
 
 protected:
     void generateEntries( DatabaseImpl* dbi );
+    void loadEntries( DatabaseImpl* dbi );
 
     QStringList m_guids;
     QMap< QString, Tomahawk::plentry_ptr > m_entrymap;
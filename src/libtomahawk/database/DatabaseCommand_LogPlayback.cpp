@@ -26,8 +26,10 @@
 
 #include "DatabaseImpl.h"
 #include "PlaylistEntry.h"
+#include "TrackSampleIndex.h"
 
 #include <QDateTime>
+#include <QSqlError>
 #include <QSqlQuery>
 
 #define STARTED_THRESHOLD 600   // Don't advertise tracks older than X seconds as currently playing
@@ -120,6 +122,39 @@ DatabaseCommand_LogPlayback::exec( DatabaseImpl* dbi )
     query.bindValue( 3, m_secsPlayed );
 
     query.exec();
+
+    if ( source()->isLocal() )
+        dbi->sampleIndex()->addPlayback( trkid, m_playtime );
+
+    // Keep the per-day rollup in sync, charts and stats only read from there.
+    // Writes are serialized on the one read-write worker, nothing can add the
+    // row between the UPDATE and the INSERT.
+    const int rollupSource = srcid.isNull() ? 0 : srcid.toInt();
+    const uint day = m_playtime / 86400;
+
+    query.prepare( "UPDATE playback_log_daily SET plays = plays + 1, secs_played = secs_played + ? "
+                   "WHERE source = ? AND track = ? AND day = ?" );
+    query.bindValue( 0, m_secsPlayed );
+    query.bindValue( 1, rollupSource );
+    query.bindValue( 2, trkid );
+    query.bindValue( 3, day );
+    if ( !query.exec() )
+    {
+        tLog() << Q_FUNC_INFO << "Could not update the playback rollup:" << query.lastError().text();
+        return;
+    }
+
+    if ( query.numRowsAffected() > 0 )
+        return;
+
+    query.prepare( "INSERT INTO playback_log_daily(source, track, artist, day, plays, secs_played) VALUES (?, ?, ?, ?, 1, ?)" );
+    query.bindValue( 0, rollupSource );
+    query.bindValue( 1, trkid );
+    query.bindValue( 2, artid );
+    query.bindValue( 3, day );
+    query.bindValue( 4, m_secsPlayed );
+    if ( !query.exec() )
+        tLog() << Q_FUNC_INFO << "Could not add to the playback rollup:" << query.lastError().text();
 }
 
 
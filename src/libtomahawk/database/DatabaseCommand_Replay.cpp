@@ -0,0 +1,135 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseCommand_Replay.h"
+
+#include "DatabaseImpl.h"
+#include "TomahawkSqlQuery.h"
+#include "Source.h"
+#include "utils/Logger.h"
+
+#include <QSqlError>
+
+using namespace Tomahawk;
+
+
+DatabaseCommand_Replay::DatabaseCommand_Replay( const QList< Tomahawk::dbcmd_ptr >& commands, QObject* parent )
+    : DatabaseCommand( parent )
+    , m_commands( commands )
+{
+    if ( !commands.isEmpty() )
+        setSource( commands.first()->source() );
+
+    // finished() is emitted from the worker thread, pass it on right there
+    connect( this, SIGNAL( finished() ), SLOT( onFinished() ), Qt::DirectConnection );
+}
+
+
+void
+DatabaseCommand_Replay::exec( DatabaseImpl* lib )
+{
+    TomahawkSqlQuery savepoint = lib->newquery();
+    QString lastop;
+    int lastopSource = 0;
+
+    foreach ( const dbcmd_ptr& cmd, m_commands )
+    {
+        // We bypass DatabaseWorker::logOp, which only a peer's ops can do without
+        Q_ASSERT( !cmd->source().isNull() && !cmd->source()->isLocal() );
+        if ( cmd->source().isNull() || cmd->source()->isLocal() )
+        {
+            tLog() << "*ERROR* not replaying local databasecommand:" << cmd->commandname() << cmd->guid();
+            continue;
+        }
+
+        savepoint.exec( "SAVEPOINT replay" );
+        try
+        {
+            cmd->_exec( lib );
+            savepoint.exec( "RELEASE SAVEPOINT replay" );
+            m_applied << cmd;
+        }
+        catch ( const char* msg )
+        {
+            tLog() << "*ERROR* replaying databasecommand:" << cmd->commandname() << cmd->guid() << msg
+                   << lib->database().lastError().databaseText();
+
+            savepoint.exec( "ROLLBACK TO SAVEPOINT replay" );
+            savepoint.exec( "RELEASE SAVEPOINT replay" );
+
+            // lastop stays before the failed op, the peer sends it and everything after it again
+            tLog() << "Stopped replaying, skipping" << m_commands.count() - m_commands.indexOf( cmd ) - 1 << "more commands";
+            break;
+        }
+
+        if ( cmd->loggable() && !cmd->singletonCmd() )
+        {
+            lastop = cmd->guid();
+            lastopSource = cmd->source()->id();
+        }
+    }
+
+    if ( !lastop.isEmpty() )
+    {
+        TomahawkSqlQuery query = lib->newquery();
+        query.prepare( "UPDATE source SET lastop = ? WHERE id = ?" );
+        query.addBindValue( lastop );
+        query.addBindValue( lastopSource );
+
+        if ( !query.exec() )
+            throw "Failed to set lastop";
+    }
+
+    tDebug() << Q_FUNC_INFO << "Replayed" << m_applied.count() << "of" << m_commands.count() << "commands";
+}
+
+
+void
+DatabaseCommand_Replay::postCommitHook()
+{
+    DatabaseCommand* head = 0;
+    QList< DatabaseCommand* > heads;
+    foreach ( const dbcmd_ptr& cmd, m_applied )
+    {
+        if ( head && head->coalescePostCommit( cmd.data() ) )
+            continue;
+
+        head = cmd.data();
+        heads << head;
+    }
+
+    int i = 0;
+    foreach ( const dbcmd_ptr& cmd, m_applied )
+    {
+        if ( i < heads.count() && heads.at( i ) == cmd.data() )
+        {
+            cmd->postCommit();
+            i++;
+        }
+        else
+            cmd->emitCommitted();
+    }
+}
+
+
+void
+DatabaseCommand_Replay::onFinished()
+{
+    foreach ( const dbcmd_ptr& cmd, m_commands )
+        cmd->emitFinished();
+}
@@ -0,0 +1,66 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATABASECOMMAND_REPLAY_H
+#define DATABASECOMMAND_REPLAY_H
+
+#include "DatabaseCommand.h"
+#include "DllMacro.h"
+
+namespace Tomahawk
+{
+
+/**
+ * Applies an ordered batch of commands in a single transaction, the ops of
+ * a peer we are syncing with. They aren't logged to the oplog, commands of
+ * the local source are refused.
+ *
+ * Every command runs inside its own savepoint: one that fails is rolled back
+ * on its own and the batch stops there, the source's lastop is only advanced
+ * up to the last op that got applied. Post-commit hooks
+ * of consecutive commands are coalesced where the commands support it, see
+ * DatabaseCommand::coalescePostCommit(). Every command of the batch emits
+ * finished() once the batch is done, whether it was applied or not.
+ */
+class DLLEXPORT DatabaseCommand_Replay : public DatabaseCommand
+{
+Q_OBJECT
+
+public:
+    explicit DatabaseCommand_Replay( const QList< Tomahawk::dbcmd_ptr >& commands, QObject* parent = 0 );
+
+    virtual QString commandname() const { return "replay"; }
+    virtual bool doesMutates() const { return true; }
+    virtual void exec( DatabaseImpl* lib );
+    virtual void postCommitHook();
+
+    QList< Tomahawk::dbcmd_ptr > commands() const { return m_commands; }
+    // Commands that weren't applied, because they failed or came after one that did
+    int failed() const { return m_commands.count() - m_applied.count(); }
+
+private slots:
+    void onFinished();
+
+private:
+    QList< Tomahawk::dbcmd_ptr > m_commands;
+    QList< Tomahawk::dbcmd_ptr > m_applied;
+};
+
+}
+
+#endif // DATABASECOMMAND_REPLAY_H
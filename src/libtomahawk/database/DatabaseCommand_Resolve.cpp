@@ -62,7 +62,16 @@ DatabaseCommand_Resolve::exec( DatabaseImpl* lib )
         {
             QList<Tomahawk::result_ptr> res;
             res << result;
-            emit results( m_query->id(), res );
+
+            // An http hint that hasn't been validated yet may still turn out to be dead.
+            // Report it as pending together with our regular matches instead of waiting.
+            if ( result->checked() || result->collection() || m_query->isFullTextQuery() )
+            {
+                emit results( m_query->id(), res );
+                return;
+            }
+
+            resolve( lib, res );
             return;
         }
     }
@@ -75,9 +84,9 @@ DatabaseCommand_Resolve::exec( DatabaseImpl* lib )
 
 
 void
-DatabaseCommand_Resolve::resolve( DatabaseImpl* lib )
+DatabaseCommand_Resolve::resolve( DatabaseImpl* lib, const QList< Tomahawk::result_ptr >& pendingResults )
 {
-    QList<Tomahawk::result_ptr> res;
+    QList<Tomahawk::result_ptr> res = pendingResults;
 
     // STEP 1
     QList< QPair<int, float> > tracks = lib->search( m_query );
@@ -53,7 +53,7 @@ private:
     DatabaseCommand_Resolve();
 
     void fullTextResolve( DatabaseImpl* lib );
-    void resolve( DatabaseImpl* lib );
+    void resolve( DatabaseImpl* lib, const QList< Tomahawk::result_ptr >& pendingResults = QList< Tomahawk::result_ptr >() );
 
     Tomahawk::query_ptr m_query;
 };
@@ -0,0 +1,119 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseCommand_SampleTracks.h"
+
+#include "utils/Logger.h"
+
+#include "DatabaseImpl.h"
+#include "Query.h"
+
+#include <QDateTime>
+#include <QTime>
+
+using namespace Tomahawk;
+
+
+DatabaseCommand_SampleTracks::DatabaseCommand_SampleTracks( const QStringList& artists, const QStringList& albums,
+                                                            const TrackSampleIndex::Constraints& constraints,
+                                                            int count, const QSet< int >& exclude, QObject* parent )
+    : DatabaseCommand( parent )
+    , m_artists( artists )
+    , m_albums( albums )
+    , m_constraints( constraints )
+    , m_count( count )
+    , m_exclude( exclude )
+{
+}
+
+
+void
+DatabaseCommand_SampleTracks::exec( DatabaseImpl* dbi )
+{
+    QList< query_ptr > queries;
+    QList< uint > ids;
+
+    TomahawkSqlQuery query = dbi->newquery();
+    TrackSampleIndex::Constraints constraints = m_constraints;
+
+    foreach ( const QString& artist, m_artists )
+    {
+        const int id = dbi->artistId( artist, false );
+        if ( id > 0 )
+            constraints.artists << id;
+    }
+
+    query.prepare( "SELECT id FROM album WHERE sortname = ?" );
+    foreach ( const QString& album, m_albums )
+    {
+        query.bindValue( 0, DatabaseImpl::sortname( album ) );
+        query.exec();
+        while ( query.next() )
+            constraints.albums << query.value( 0 ).toInt();
+    }
+
+    // Asked for artists or albums we don't know, nothing can match
+    if ( ( !m_artists.isEmpty() && constraints.artists.isEmpty() ) ||
+         ( !m_albums.isEmpty() && constraints.albums.isEmpty() ) )
+    {
+        emit tracks( queries, ids );
+        return;
+    }
+
+    QTime t;
+    t.start();
+    dbi->loadSampleIndex();
+
+    // qrand() is seeded per thread, make sure we don't draw the same tracks after every start
+    qsrand( (uint)QDateTime::currentMSecsSinceEpoch() ^ (uint)qrand() );
+
+    const QSharedPointer< TrackSampleIndex > index = dbi->sampleIndex();
+    const QList< int > trackIds = index->sample( constraints, m_count, m_exclude );
+
+    query.prepare( "SELECT track.name, artist.name FROM track, artist WHERE track.id = ? AND artist.id = track.artist" );
+    TomahawkSqlQuery albumQuery = dbi->newquery();
+    albumQuery.prepare( "SELECT name FROM album WHERE id = ?" );
+
+    foreach ( int id, trackIds )
+    {
+        query.bindValue( 0, id );
+        query.exec();
+        if ( !query.next() )
+            continue;
+
+        QString album;
+        const int albumId = index->album( id );
+        if ( albumId > 0 )
+        {
+            albumQuery.bindValue( 0, albumId );
+            albumQuery.exec();
+            if ( albumQuery.next() )
+                album = albumQuery.value( 0 ).toString();
+        }
+
+        query_ptr qry = Query::get( query.value( 1 ).toString(), query.value( 0 ).toString(), album );
+        if ( qry.isNull() )
+            continue;
+
+        queries << qry;
+        ids << (uint)id;
+    }
+
+    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Sampled" << queries.count() << "of" << m_count << "tracks in" << t.elapsed() << "ms";
+    emit tracks( queries, ids );
+}
@@ -0,0 +1,69 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATABASECOMMAND_SAMPLETRACKS_H
+#define DATABASECOMMAND_SAMPLETRACKS_H
+
+#include "DatabaseCommand.h"
+#include "TrackSampleIndex.h"
+#include "Typedefs.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include "DllMacro.h"
+
+namespace Tomahawk
+{
+
+/**
+ * Draws random tracks from all collections that match the given constraints,
+ * e.g. for database stations. Artists and albums are given by name, the rest
+ * of the constraints as in TrackSampleIndex::Constraints.
+ *
+ * Tracks in exclude aren't drawn again, so a station can ask for more without
+ * repeating itself. The ids of the drawn tracks are emitted along with them.
+ */
+class DLLEXPORT DatabaseCommand_SampleTracks : public DatabaseCommand
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseCommand_SampleTracks( const QStringList& artists, const QStringList& albums,
+                                           const TrackSampleIndex::Constraints& constraints,
+                                           int count, const QSet< int >& exclude = QSet< int >(), QObject* parent = 0 );
+
+    virtual void exec( DatabaseImpl* lib );
+    virtual bool doesMutates() const { return false; }
+
+    virtual QString commandname() const { return "sampletracks"; }
+
+signals:
+    void tracks( const QList< Tomahawk::query_ptr >& tracks, const QList< uint >& trackIds );
+
+private:
+    QStringList m_artists;
+    QStringList m_albums;
+    TrackSampleIndex::Constraints m_constraints;
+    int m_count;
+    QSet< int > m_exclude;
+};
+
+}
+
+#endif // DATABASECOMMAND_SAMPLETRACKS_H
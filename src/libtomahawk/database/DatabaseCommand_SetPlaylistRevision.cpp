@@ -25,12 +25,15 @@
 
 #include "DatabaseImpl.h"
 #include "PlaylistEntry.h"
+#include "PlaylistRevisionDelta.h"
 #include "Source.h"
 #include "TomahawkSqlQuery.h"
 #include "Track.h"
 
 #include <QSqlQuery>
 
+#define CHECKPOINT_INTERVAL 32 // Store the full list of entries after this many delta revisions
+
 using namespace Tomahawk;
 
 
@@ -147,9 +150,6 @@ DatabaseCommand_SetPlaylistRevision::exec( DatabaseImpl* lib )
         return;
     }
 
-    QVariantList vlist = m_orderedguids;
-    const QByteArray entries = TomahawkUtils::toJson( vlist );
-
     // add any new items:
     TomahawkSqlQuery adde = lib->newquery();
     if ( m_localOnly )
@@ -224,15 +224,69 @@ DatabaseCommand_SetPlaylistRevision::exec( DatabaseImpl* lib )
         }
     }
 
+    // we need the previous order both to diff against and to pass it on in postCommitHook
+    bool haveParent = false;
+    int parentDeltas = 0;
+    QStringList parentEntries;
+    if ( !m_oldrev.isEmpty() )
+        parentEntries = lib->playlistRevisionEntries( m_oldrev, &haveParent, &parentDeltas );
+
+    if ( !m_orderedguidsDelta.isEmpty() )
+    {
+        // a peer only sent us the changes, rebuild the full order from our copy of its previous revision
+        QStringList rebuilt;
+        if ( !haveParent || !PlaylistRevisionDelta::apply( parentEntries, m_orderedguidsDelta, rebuilt ) )
+        {
+            tLog() << "ERROR: Can't apply playlist revision delta, missing previous revision:" << m_playlistguid << m_oldrev;
+            m_failed = true;
+            return;
+        }
+
+        QVariantList tmp;
+        foreach( const QString& s, rebuilt )
+            tmp << s;
+
+        setOrderedguids( tmp );
+    }
+
+    QStringList orderedentriesguids;
+    foreach( const QVariant& v, m_orderedguids )
+        orderedentriesguids << v.toString();
+
+    QVariantList vlist = m_orderedguids;
+    const QByteArray entries = TomahawkUtils::toJson( vlist );
+
+    // store and sync the change as a delta against the previous revision, unless the full list is just as small.
+    // every now and then we store a full list again, so loading a revision never has to replay too many deltas.
+    QVariant entriesData = entries;
+    QVariant deltaData( QVariant::String );
+    if ( haveParent )
+    {
+        if ( m_orderedguidsDelta.isEmpty() )
+            m_orderedguidsDelta = PlaylistRevisionDelta::diff( parentEntries, orderedentriesguids );
+
+        const QByteArray delta = TomahawkUtils::toJson( m_orderedguidsDelta );
+        if ( m_orderedguidsDelta.isEmpty() || delta.length() >= entries.length() )
+        {
+            m_orderedguidsDelta.clear();
+        }
+        else if ( parentDeltas + 1 < CHECKPOINT_INTERVAL )
+        {
+            entriesData = QVariant( QVariant::String );
+            deltaData = delta;
+        }
+    }
+
     // add / update the revision:
     TomahawkSqlQuery query = lib->newquery();
-    QString sql = "INSERT INTO playlist_revision(guid, playlist, entries, author, timestamp, previous_revision) "
-                  "VALUES(?, ?, ?, ?, ?, ?)";
+    QString sql = "INSERT INTO playlist_revision(guid, playlist, entries, delta, author, timestamp, previous_revision) "
+                  "VALUES(?, ?, ?, ?, ?, ?, ?)";
     query.prepare( sql );
 
     query.addBindValue( m_newrev );
     query.addBindValue( m_playlistguid );
-    query.addBindValue( entries );
+    query.addBindValue( entriesData );
+    query.addBindValue( deltaData );
     query.addBindValue( source()->isLocal() ? QVariant(QVariant::Int) : source()->id() );
     query.addBindValue( 0 ); //ts
     query.addBindValue( m_oldrev.isEmpty() ? QVariant(QVariant::String) : m_oldrev );
@@ -252,22 +306,8 @@ DatabaseCommand_SetPlaylistRevision::exec( DatabaseImpl* lib )
 
         m_applied = true;
 
-        // load previous revision entries, which we need to pass on
-        // so the change can be diffed
-        TomahawkSqlQuery query_entries = lib->newquery();
-        query_entries.prepare( "SELECT entries, playlist, author, timestamp, previous_revision "
-                               "FROM playlist_revision "
-                               "WHERE guid = :guid" );
-        query_entries.bindValue( ":guid", m_oldrev );
-        query_entries.exec();
-        if ( query_entries.next() )
-        {
-            bool ok;
-            QVariant v = TomahawkUtils::parseJson( query_entries.value( 0 ).toByteArray(), &ok );
-            Q_ASSERT( ok && v.type() == QVariant::List ); //TODO
-
-            m_previous_rev_orderedguids = v.toStringList();
-        }
+        // pass on the previous revision entries, so the change can be diffed
+        m_previous_rev_orderedguids = parentEntries;
     }
     else if ( !m_oldrev.isEmpty() )
     {
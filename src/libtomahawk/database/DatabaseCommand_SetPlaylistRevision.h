@@ -35,7 +35,8 @@ Q_OBJECT
 Q_PROPERTY( QString playlistguid      READ playlistguid  WRITE setPlaylistguid )
 Q_PROPERTY( QString newrev            READ newrev        WRITE setNewrev )
 Q_PROPERTY( QString oldrev            READ oldrev        WRITE setOldrev )
-Q_PROPERTY( QVariantList orderedguids READ orderedguids  WRITE setOrderedguids )
+Q_PROPERTY( QVariantList orderedguids READ orderedguidsV WRITE setOrderedguids )
+Q_PROPERTY( QVariantMap orderedguidsDelta READ orderedguidsDelta WRITE setOrderedguidsDelta )
 Q_PROPERTY( QVariantList addedentries READ addedentriesV WRITE setAddedentriesV )
 Q_PROPERTY( bool metadataUpdate       READ metadataUpdate WRITE setMetadataUpdate )
 
@@ -92,6 +93,12 @@ public:
     void setOrderedguids( const QVariantList& l ) { m_orderedguids = l; }
     QVariantList orderedguids() const { return m_orderedguids; }
 
+    // only sync the full list of entries if we couldn't express the change as a delta
+    QVariantList orderedguidsV() const { return m_orderedguidsDelta.isEmpty() ? m_orderedguids : QVariantList(); }
+
+    void setOrderedguidsDelta( const QVariantMap& delta ) { m_orderedguidsDelta = delta; }
+    QVariantMap orderedguidsDelta() const { return m_orderedguidsDelta; }
+
 protected:
     bool m_failed;
     bool m_applied;
@@ -102,6 +109,7 @@ protected:
 
 private:
     QVariantList m_orderedguids;
+    QVariantMap m_orderedguidsDelta;
     QList<Tomahawk::plentry_ptr> m_addedentries, m_entries;
 
     bool m_localOnly, m_metadataUpdate;
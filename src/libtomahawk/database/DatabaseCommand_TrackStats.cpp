@@ -57,10 +57,10 @@ DatabaseCommand_TrackStats::exec( DatabaseImpl* dbi )
         if ( m_track->trackId() == 0 )
             return;
 
-        query.prepare( "SELECT COUNT(*) AS counter, track.id "
-                       "FROM playback_log, track "
-                       "WHERE playback_log.source IS NULL AND track.id = playback_log.track "
-                       "GROUP BY track.id "
+        query.prepare( "SELECT SUM(plays) AS counter, track "
+                       "FROM playback_log_daily "
+                       "WHERE source = 0 "
+                       "GROUP BY track "
                        "ORDER BY counter DESC" );
         query.exec();
 
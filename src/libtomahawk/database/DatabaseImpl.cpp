@@ -22,14 +22,18 @@
 #include "DatabaseImpl.h"
 
 #include "database/Database.h"
+#include "utils/Json.h"
 #include "utils/Logger.h"
-#include "utils/ResultUrlChecker.h"
 #include "utils/TomahawkUtils.h"
+#include "utils/UrlCheckCache.h"
 
 #include "Album.h"
 #include "Artist.h"
 #include "fuzzyindex/DatabaseFuzzyIndex.h"
+#include "fuzzyindex/TrigramIndex.h"
+#include "TrackSampleIndex.h"
 #include "PlaylistEntry.h"
+#include "PlaylistRevisionDelta.h"
 #include "Result.h"
 #include "SourceList.h"
 #include "Track.h"
@@ -38,6 +42,7 @@
 #include <QCoreApplication>
 #include <QFile>
 #include <QRegExp>
+#include <QSet>
 #include <QStringList>
 #include <QTime>
 #include <QTimer>
@@ -48,7 +53,10 @@
 */
 #include "Schema.sql.h"
 
-#define CURRENT_SCHEMA_VERSION 31
+#define CURRENT_SCHEMA_VERSION 34
+#define MAX_FILTER_IDS 5000
+// Stays below the 500 terms older SQLite versions allow in a compound SELECT
+#define FILTER_IDS_PER_INSERT 400
 
 Tomahawk::DatabaseImpl::DatabaseImpl( const QString& dbname )
 {
@@ -90,6 +98,8 @@ Tomahawk::DatabaseImpl::DatabaseImpl( const QString& dbname )
     query.exec( "DELETE FROM oplog WHERE source IS NULL AND singleton = 'true'" );
 
     m_fuzzyIndex = new Tomahawk::DatabaseFuzzyIndex( this, schemaUpdated );
+    m_nameIndex = QSharedPointer< Tomahawk::TrigramIndex >( new Tomahawk::TrigramIndex() );
+    m_sampleIndex = QSharedPointer< Tomahawk::TrackSampleIndex >( new Tomahawk::TrackSampleIndex() );
 
     tDebug( LOGVERBOSE ) << "Loaded index:" << t.elapsed();
     if ( qApp->arguments().contains( "--dumpdb" ) )
@@ -164,6 +174,8 @@ Tomahawk::DatabaseImpl::clone() const
     DatabaseImpl* impl = new DatabaseImpl( m_db.databaseName(), true );
     impl->setDatabaseID( m_dbid );
     impl->setFuzzyIndex( m_fuzzyIndex );
+    impl->setNameIndex( m_nameIndex );
+    impl->setSampleIndex( m_sampleIndex );
     return impl;
 }
 
@@ -364,6 +376,8 @@ Tomahawk::DatabaseImpl::artistId( const QString& name_orig, bool autoCreate )
         id = query.lastInsertId().toInt();
         m_lastart = name_orig;
         m_lastartid = id;
+
+        m_nameIndex->insert( TrigramIndex::Artist, id, sortname );
     }
 
     return id;
@@ -407,6 +421,7 @@ Tomahawk::DatabaseImpl::trackId( int artistid, const QString& name_orig, bool au
         }
 
         id = query.lastInsertId().toInt();
+        m_nameIndex->insert( TrigramIndex::Track, id, sortname );
     }
 
     return id;
@@ -461,12 +476,170 @@ Tomahawk::DatabaseImpl::albumId( int artistid, const QString& name_orig, bool au
         id = query.lastInsertId().toInt();
         m_lastalb = name_orig;
         m_lastalbid = id;
+
+        m_nameIndex->insert( TrigramIndex::Album, id, sortname );
     }
 
     return id;
 }
 
 
+void
+Tomahawk::DatabaseImpl::loadNameIndex()
+{
+    static QMutex loadMutex;
+    QMutexLocker lock( &loadMutex );
+
+    static const char* tables[] = { "artist", "album", "track" };
+    const bool loaded = m_nameIndex->isLoaded();
+
+    QTime t;
+    t.start();
+
+    // The first time this reads every name. After that it only picks up the
+    // names of transactions that were still running during an earlier load,
+    // insert() didn't add them and we couldn't see them yet. Writes are
+    // serialized, so their ids are above everything we read before.
+    TomahawkSqlQuery query = newquery();
+    for ( int type = TrigramIndex::Artist; type <= TrigramIndex::Track; type++ )
+    {
+        query.prepare( QString( "SELECT id, sortname FROM %1 WHERE id > ?" ).arg( tables[ type ] ) );
+        query.addBindValue( m_nameIndex->loadedUpTo( (TrigramIndex::NameType)type ) );
+        query.exec();
+
+        while ( query.next() )
+            m_nameIndex->load( (TrigramIndex::NameType)type, query.value( 0 ).toInt(), query.value( 1 ).toString() );
+    }
+
+    if ( loaded )
+        return;
+
+    m_nameIndex->setLoaded( true );
+    tDebug( LOGVERBOSE ) << "Loaded name index:" << t.elapsed();
+}
+
+
+void
+Tomahawk::DatabaseImpl::loadSampleIndex()
+{
+    static QMutex loadMutex;
+    QMutexLocker lock( &loadMutex );
+
+    if ( m_sampleIndex->isLoaded() )
+        return;
+
+    QTime t;
+    t.start();
+
+    TomahawkSqlQuery query = newquery();
+    query.exec( "SELECT file_join.track, file_join.artist, file_join.album, track_attributes.v "
+                "FROM file_join "
+                "LEFT JOIN track_attributes ON track_attributes.id = file_join.track AND track_attributes.k = 'releaseyear'" );
+    while ( query.next() )
+        m_sampleIndex->load( query.value( 0 ).toInt(), query.value( 1 ).toInt(), query.value( 2 ).toInt(), query.value( 3 ).toInt() );
+
+    // Only our own plays, like the charts and stats of the local source
+    query.exec( "SELECT track, COUNT(*), MAX(playtime) FROM playback_log WHERE source IS NULL GROUP BY track" );
+    while ( query.next() )
+        m_sampleIndex->loadPlays( query.value( 0 ).toInt(), query.value( 1 ).toInt(), query.value( 2 ).toUInt() );
+
+    m_sampleIndex->setLoaded( true );
+    tDebug( LOGVERBOSE ) << "Loaded sample index:" << t.elapsed() << "ms," << m_sampleIndex->count() << "tracks";
+}
+
+
+QString
+Tomahawk::DatabaseImpl::collectionFilterSql( const QString& filter )
+{
+    loadNameIndex();
+
+    static const char* columns[] = { "artist", "album", "track" };
+
+    // The matching ids go into a table of this connection, instead of
+    // spelling out thousands of them in the query
+    TomahawkSqlQuery insert = newquery();
+    insert.exec( "CREATE TEMP TABLE IF NOT EXISTS collection_filter(term INTEGER NOT NULL, type INTEGER NOT NULL, id INTEGER NOT NULL)" );
+    insert.exec( "DELETE FROM temp.collection_filter" );
+
+    QString sql;
+    int termCount = 0;
+    foreach ( const QString& s, filter.split( " ", QString::SkipEmptyParts ) )
+    {
+        const QString term = sortname( s );
+        termCount++;
+
+        // Without a single trigram the index would have to look at every
+        // name, and matches most of them anyway
+        bool truncated = ( term.length() < 3 );
+        QList< int > ids[ 3 ];
+        for ( int pass = 0; pass < 2 && !truncated; pass++ )
+        {
+            // If no name contains the term, try again allowing for typos
+            const bool fuzzy = ( pass > 0 );
+            for ( int type = TrigramIndex::Artist; type <= TrigramIndex::Track && !truncated; type++ )
+                ids[ type ] = m_nameIndex->search( (TrigramIndex::NameType)type, term, fuzzy, MAX_FILTER_IDS, &truncated );
+
+            if ( truncated || !ids[ TrigramIndex::Artist ].isEmpty() || !ids[ TrigramIndex::Album ].isEmpty() || !ids[ TrigramIndex::Track ].isEmpty() )
+                break;
+        }
+
+        if ( truncated )
+        {
+            // Matches too many names to list them or is too short for the index, let SQLite do the scanning
+            sql += QString( " AND ( artist.name LIKE '%%1%' OR album.name LIKE '%%1%' OR track.name LIKE '%%1%' )" ).arg( TomahawkSqlQuery::escape( s ) );
+            continue;
+        }
+
+        QStringList clauses;
+        for ( int type = TrigramIndex::Artist; type <= TrigramIndex::Track; type++ )
+        {
+            if ( ids[ type ].isEmpty() )
+                continue;
+
+            // Rows in batches, every statement outside a transaction commits on its own
+            for ( int i = 0; i < ids[ type ].count(); i += FILTER_IDS_PER_INSERT )
+            {
+                QStringList rows;
+                foreach ( int id, ids[ type ].mid( i, FILTER_IDS_PER_INSERT ) )
+                    rows << QString( "(%1, %2, %3)" ).arg( termCount ).arg( type ).arg( id );
+
+                insert.exec( "INSERT INTO temp.collection_filter(term, type, id) VALUES " + rows.join( ", " ) );
+            }
+
+            clauses << QString( "file_join.%1 IN (SELECT id FROM temp.collection_filter WHERE term = %2 AND type = %3)" )
+                          .arg( columns[ type ] ).arg( termCount ).arg( type );
+        }
+
+        if ( clauses.isEmpty() )
+            return QString( " AND 0" );
+
+        sql += QString( " AND ( %1 )" ).arg( clauses.join( " OR " ) );
+    }
+
+    return sql;
+}
+
+
+QString
+Tomahawk::DatabaseImpl::directoryOfUrl( const QString& url )
+{
+    return url.left( url.lastIndexOf( '/' ) );
+}
+
+
+QString
+Tomahawk::DatabaseImpl::directoryFilterSql( const QString& dir )
+{
+    QString d = dir;
+    while ( d.endsWith( '/' ) )
+        d.chop( 1 );
+
+    // '0' follows '/', so the range holds exactly the paths below d
+    const QString escaped = TomahawkSqlQuery::escape( d );
+    return QString( " AND ( dir = '%1' OR ( dir >= '%1/' AND dir < '%2' ) )" ).arg( escaped, escaped + '0' );
+}
+
+
 QList< QPair<int, float> >
 Tomahawk::DatabaseImpl::search( const Tomahawk::query_ptr& query, uint limit )
 {
@@ -549,6 +722,68 @@ Tomahawk::DatabaseImpl::sortname( const QString& str, bool replaceArticle )
 }
 
 
+QStringList
+Tomahawk::DatabaseImpl::playlistRevisionEntries( const QString& revisionGuid, bool* ok, int* deltaCount )
+{
+    if ( ok )
+        *ok = false;
+    if ( deltaCount )
+        *deltaCount = 0;
+
+    // Walk back to the closest checkpoint, collecting all deltas on the way
+    QStringList entries;
+    QList< QVariantMap > deltas;
+    QSet< QString > visited;
+    QString rev = revisionGuid;
+
+    TomahawkSqlQuery query = newquery();
+    query.prepare( "SELECT entries, delta, previous_revision FROM playlist_revision WHERE guid = ?" );
+    forever
+    {
+        if ( visited.contains( rev ) )
+        {
+            tLog() << "Cyclic playlist revision history for" << revisionGuid;
+            return QStringList();
+        }
+        visited << rev;
+
+        query.bindValue( 0, rev );
+        query.exec();
+        if ( !query.next() )
+        {
+            tLog() << "Missing playlist revision" << rev << "while loading" << revisionGuid;
+            return QStringList();
+        }
+
+        if ( query.value( 1 ).isNull() )
+        {
+            if ( !query.value( 0 ).isNull() )
+                entries = TomahawkUtils::parseJson( query.value( 0 ).toByteArray() ).toStringList();
+            break;
+        }
+
+        deltas.prepend( TomahawkUtils::parseJson( query.value( 1 ).toByteArray() ).toMap() );
+        rev = query.value( 2 ).toString();
+    }
+
+    foreach ( const QVariantMap& delta, deltas )
+    {
+        if ( !PlaylistRevisionDelta::apply( entries, delta, entries ) )
+        {
+            tLog() << "Invalid delta in playlist revision history for" << revisionGuid;
+            return QStringList();
+        }
+    }
+
+    if ( ok )
+        *ok = true;
+    if ( deltaCount )
+        *deltaCount = deltas.count();
+
+    return entries;
+}
+
+
 QVariantMap
 Tomahawk::DatabaseImpl::artist( int id )
 {
@@ -637,14 +872,23 @@ Tomahawk::DatabaseImpl::resultFromHint( const Tomahawk::query_ptr& origquery )
         Tomahawk::track_ptr track = Tomahawk::Track::get( origquery->queryTrack()->artist(), origquery->queryTrack()->track(), origquery->queryTrack()->album(), origquery->queryTrack()->duration() );
         res->setTrack( track );
 
-        ResultUrlChecker* checker = new ResultUrlChecker( origquery, QList< result_ptr >() << res );
-        QEventLoop loop;
-        connect( checker, SIGNAL( done() ), &loop, SLOT( quit() ) );
-        loop.exec();
-        checker->deleteLater();
+        // Never wait for the network on a database thread. If we don't know
+        // the url yet, hand out the result unchecked: the Pipeline validates
+        // it asynchronously before it gets added to the query.
+        switch ( UrlCheckCache::instance()->state( url ) )
+        {
+            case UrlCheckCache::Valid:
+                res->setChecked( true );
+                break;
+
+            case UrlCheckCache::Invalid:
+                res = result_ptr();
+                break;
 
-        if ( checker->validResults().isEmpty() )
-            res = result_ptr();
+            case UrlCheckCache::Unknown:
+                UrlCheckCache::instance()->check( url );
+                break;
+        }
 
         return res;
     }
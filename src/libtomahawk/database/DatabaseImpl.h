@@ -31,6 +31,8 @@
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QHash>
+#include <QSharedPointer>
+#include <QStringList>
 #include <QThread>
 
 #include "DllMacro.h"
@@ -43,6 +45,8 @@ namespace Tomahawk
 
 class Database;
 class DatabaseFuzzyIndex;
+class TrigramIndex;
+class TrackSampleIndex;
 
 class DLLEXPORT DatabaseImpl : public QObject
 {
@@ -70,6 +74,37 @@ public:
 
     static QString sortname( const QString& str, bool replaceArticle = false );
 
+    /**
+     * Returns an SQL condition (starting with AND) that matches file_join rows
+     * whose artist, album or track name contains every word of filter.
+     * Expects the artist, album and track tables to be joined to file_join.
+     *
+     * The matching ids are kept in a temporary table of this connection,
+     * the condition only holds until the next call.
+     */
+    QString collectionFilterSql( const QString& filter );
+
+    /**
+     * Returns the directory a local file url is stored under in file.dir,
+     * e.g. "file:///music/foo" for "file:///music/foo/bar.mp3".
+     */
+    static QString directoryOfUrl( const QString& url );
+
+    /**
+     * Returns an SQL condition (starting with AND) that matches the files in
+     * dir and all of its subdirectories, as a range on the file(source, dir)
+     * index. dir is a directory url like directoryOfUrl() returns.
+     */
+    static QString directoryFilterSql( const QString& dir );
+
+    /**
+     * Returns the ordered entry guids of a playlist revision. Revisions are
+     * stored as deltas against their previous revision with a full list
+     * every now and then, so this replays the deltas since the last full one.
+     * deltaCount is set to the number of deltas that had to be applied.
+     */
+    QStringList playlistRevisionEntries( const QString& revisionGuid, bool* ok = 0, int* deltaCount = 0 );
+
     QVariantMap artist( int id );
     QVariantMap album( int id );
     QVariantMap track( int id );
@@ -85,6 +120,13 @@ public:
 
     void loadIndex();
 
+    /**
+     * The index DatabaseCommand_SampleTracks draws random tracks from, shared
+     * by all connections. Call loadSampleIndex() before sampling from it.
+     */
+    QSharedPointer< Tomahawk::TrackSampleIndex > sampleIndex() const { return m_sampleIndex; }
+    void loadSampleIndex();
+
 signals:
     void indexReady();
     void schemaUpdateStarted();
@@ -94,6 +136,8 @@ signals:
 private:
     DatabaseImpl( const QString& dbname, bool internal );
     void setFuzzyIndex( DatabaseFuzzyIndex* fi ) { m_fuzzyIndex = fi; }
+    void setNameIndex( const QSharedPointer< TrigramIndex >& ni ) { m_nameIndex = ni; }
+    void setSampleIndex( const QSharedPointer< TrackSampleIndex >& si ) { m_sampleIndex = si; }
     void setDatabaseID( const QString& dbid ) { m_dbid = dbid; }
 
     void init();
@@ -101,6 +145,7 @@ private:
     bool updateSchema( int oldVersion );
     void dumpDatabase();
     QString cleanSql( const QString& sql );
+    void loadNameIndex();
 
     bool m_ready;
     QSqlDatabase m_db;
@@ -110,6 +155,8 @@ private:
 
     QString m_dbid;
     Tomahawk::DatabaseFuzzyIndex* m_fuzzyIndex;
+    QSharedPointer< Tomahawk::TrigramIndex > m_nameIndex;
+    QSharedPointer< Tomahawk::TrackSampleIndex > m_sampleIndex;
     mutable QMutex m_mutex;
 };
 
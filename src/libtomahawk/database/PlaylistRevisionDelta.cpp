@@ -0,0 +1,158 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlaylistRevisionDelta.h"
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+using namespace Tomahawk;
+
+
+QVariantMap
+PlaylistRevisionDelta::diff( const QStringList& from, const QStringList& to )
+{
+    QHash< QString, int > toPos;
+    toPos.reserve( to.count() );
+    for ( int i = 0; i < to.count(); i++ )
+        toPos.insert( to.at( i ), i );
+
+    if ( toPos.count() != to.count() || from.toSet().count() != from.count() )
+        return QVariantMap();
+
+    // Positions in the new list of all guids we keep, in their old order
+    QVariantList removed;
+    QVector< int > kept;
+    kept.reserve( from.count() );
+    foreach ( const QString& guid, from )
+    {
+        QHash< QString, int >::const_iterator it = toPos.constFind( guid );
+        if ( it == toPos.constEnd() )
+            removed << guid;
+        else
+            kept << it.value();
+    }
+
+    // The longest increasing run of those positions is the biggest set of guids
+    // that didn't move relative to each other. Everything else has to be placed.
+    QVector< int > tails; // index into kept of the smallest tail for each run length
+    QVector< int > prev( kept.count(), -1 );
+    for ( int i = 0; i < kept.count(); i++ )
+    {
+        int lo = 0, hi = tails.count();
+        while ( lo < hi )
+        {
+            const int mid = ( lo + hi ) / 2;
+            if ( kept.at( tails.at( mid ) ) < kept.at( i ) )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if ( lo > 0 )
+            prev[ i ] = tails.at( lo - 1 );
+        if ( lo == tails.count() )
+            tails << i;
+        else
+            tails[ lo ] = i;
+    }
+
+    QVector< bool > stable( to.count(), false );
+    for ( int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = prev.at( i ) )
+        stable[ kept.at( i ) ] = true;
+
+    QVariantList placed;
+    for ( int i = 0; i < to.count(); i++ )
+    {
+        if ( stable.at( i ) )
+            continue;
+
+        placed << QVariant( QVariantList() << to.at( i ) << ( i > 0 ? to.at( i - 1 ) : QString() ) );
+    }
+
+    QVariantMap delta;
+    delta[ "removed" ] = removed;
+    delta[ "placed" ] = placed;
+    return delta;
+}
+
+
+bool
+PlaylistRevisionDelta::apply( const QStringList& from, const QVariantMap& delta, QStringList& to )
+{
+    if ( !delta.contains( "removed" ) || !delta.contains( "placed" ) )
+        return false;
+
+    QSet< QString > dropped;
+    foreach ( const QVariant& guid, delta.value( "removed" ).toList() )
+        dropped << guid.toString();
+
+    // Every guid can only follow one other guid, placed guids form chains
+    QHash< QString, QString > followers;
+    const QVariantList placed = delta.value( "placed" ).toList();
+    foreach ( const QVariant& v, placed )
+    {
+        const QVariantList pair = v.toList();
+        if ( pair.count() != 2 )
+            return false;
+
+        const QString guid = pair.at( 0 ).toString();
+        const QString after = pair.at( 1 ).toString();
+        if ( followers.contains( after ) )
+            return false;
+
+        followers.insert( after, guid );
+        dropped << guid; // moved guids leave their old position
+    }
+
+    QStringList result;
+    result.reserve( from.count() + placed.count() );
+
+    int keptCount = 0;
+    QString guid;
+    for ( int i = -1; i < from.count(); i++ )
+    {
+        if ( i >= 0 )
+        {
+            guid = from.at( i );
+            if ( dropped.contains( guid ) )
+                continue;
+
+            result << guid;
+            keptCount++;
+        }
+
+        QHash< QString, QString >::const_iterator it = followers.constFind( guid );
+        while ( it != followers.constEnd() )
+        {
+            result << it.value();
+            it = followers.constFind( it.value() );
+
+            if ( result.count() > from.count() + placed.count() )
+                return false; // a cycle, this delta is broken
+        }
+    }
+
+    // Each placed guid needs an anchor that made it into the list
+    if ( result.count() != keptCount + placed.count() )
+        return false;
+
+    to = result;
+    return true;
+}
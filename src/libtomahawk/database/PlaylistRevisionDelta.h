@@ -0,0 +1,59 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLAYLISTREVISIONDELTA_H
+#define PLAYLISTREVISIONDELTA_H
+
+#include "DllMacro.h"
+
+#include <QStringList>
+#include <QVariantMap>
+
+namespace Tomahawk
+{
+
+/**
+ * Encodes the change between the ordered entry guids of two playlist
+ * revisions as a list of removed guids plus the guids that were inserted or
+ * moved, each placed right after another guid. Guids that kept their relative
+ * order aren't mentioned at all, so editing a few tracks of a huge playlist
+ * results in a tiny delta.
+ *
+ *   { "removed": [ guid, ... ], "placed": [ [ guid, after ], ... ] }
+ *
+ * An empty "after" places the guid at the top of the playlist.
+ */
+class DLLEXPORT PlaylistRevisionDelta
+{
+public:
+    /**
+     * Returns the delta turning from into to, or an empty map if the lists
+     * can't be diffed (e.g. because they contain a guid more than once).
+     */
+    static QVariantMap diff( const QStringList& from, const QStringList& to );
+
+    /**
+     * Applies delta to from and stores the result in to.
+     * Returns false if delta doesn't fit from.
+     */
+    static bool apply( const QStringList& from, const QVariantMap& delta, QStringList& to );
+};
+
+}
+
+#endif // PLAYLISTREVISIONDELTA_H
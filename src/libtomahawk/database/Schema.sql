@@ -98,7 +98,8 @@ CREATE INDEX playlist_item_artistname ON playlist_item(artistname);
 CREATE TABLE IF NOT EXISTS playlist_revision (
     guid TEXT PRIMARY KEY,
     playlist TEXT NOT NULL REFERENCES playlist(guid) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
-    entries TEXT, -- qlist( guid, guid... )
+    entries TEXT, -- qlist( guid, guid... ), NULL if stored as a delta
+    delta TEXT, -- changes against previous_revision, see PlaylistRevisionDelta
     author INTEGER REFERENCES source(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
     timestamp INTEGER NOT NULL DEFAULT 0,
     previous_revision TEXT REFERENCES playlist_revision(guid) DEFERRABLE INITIALLY DEFERRED
@@ -157,6 +158,7 @@ CREATE TABLE IF NOT EXISTS file (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
     source INTEGER REFERENCES source(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
     url TEXT NOT NULL,                   -- file:///music/foo/bar.mp3, <guid or hash?>
+    dir TEXT,                            -- file:///music/foo, NULL for remote files
     size INTEGER NOT NULL,               -- in bytes
     mtime INTEGER NOT NULL,              -- file mtime, so we know to rescan
     md5 TEXT,                            -- useful when comparing stuff p2p
@@ -167,6 +169,7 @@ CREATE TABLE IF NOT EXISTS file (
 CREATE UNIQUE INDEX file_url_src_uniq ON file(source, url);
 CREATE INDEX file_source ON file(source);
 CREATE INDEX file_mtime ON file(mtime);
+CREATE INDEX file_source_dir ON file(source, dir);
 
 -- mtime of dir when last scanned.
 -- load into memory when rescanning, skip stuff that's unchanged
@@ -278,6 +281,23 @@ CREATE INDEX playback_log_source ON playback_log(source);
 CREATE INDEX playback_log_track ON playback_log(track);
 CREATE INDEX playback_log_playtime ON playback_log(playtime);
 
+-- plays and playtime per source, track and day, kept up to date by
+-- DatabaseCommand_LogPlayback so charts don't have to scan playback_log
+
+CREATE TABLE IF NOT EXISTS playback_log_daily (
+    source INTEGER NOT NULL DEFAULT 0,      -- 0 for local plays, not a source(id)
+    track INTEGER REFERENCES track(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
+    artist INTEGER REFERENCES artist(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,
+    day INTEGER NOT NULL,                   -- playtime / 86400 (days since epoch, UTC)
+    plays INTEGER NOT NULL DEFAULT 0,
+    secs_played INTEGER NOT NULL DEFAULT 0,
+    UNIQUE(source, track, day)
+);
+
+CREATE INDEX playback_log_daily_track ON playback_log_daily(track, day);
+CREATE INDEX playback_log_daily_artist ON playback_log_daily(artist, day);
+CREATE INDEX playback_log_daily_day ON playback_log_daily(day);
+
 
 
 -- auth information for http clients
@@ -300,4 +320,4 @@ CREATE TABLE IF NOT EXISTS settings (
     v TEXT NOT NULL DEFAULT ''
 );
 
-INSERT INTO settings(k,v) VALUES('schema_version', '31');
+INSERT INTO settings(k,v) VALUES('schema_version', '34');
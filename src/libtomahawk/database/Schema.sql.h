@@ -1,5 +1,5 @@
 /*
-    This file was automatically generated from ./Schema.sql on Tue Jul 30 12:51:06 CEST 2013.
+    This file was automatically generated from ./Schema.sql on Sun Oct 18 17:51:03 UTC 2026.
 */
 
 static const char * tomahawk_schema_sql = 
@@ -75,6 +75,7 @@ static const char * tomahawk_schema_sql =
 "    guid TEXT PRIMARY KEY,"
 "    playlist TEXT NOT NULL REFERENCES playlist(guid) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,"
 "    entries TEXT, "
+"    delta TEXT, "
 "    author INTEGER REFERENCES source(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,"
 "    timestamp INTEGER NOT NULL DEFAULT 0,"
 "    previous_revision TEXT REFERENCES playlist_revision(guid) DEFERRABLE INITIALLY DEFERRED"
@@ -102,6 +103,7 @@ static const char * tomahawk_schema_sql =
 "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
 "    source INTEGER REFERENCES source(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,"
 "    url TEXT NOT NULL,                   "
+"    dir TEXT,                            "
 "    size INTEGER NOT NULL,               "
 "    mtime INTEGER NOT NULL,              "
 "    md5 TEXT,                            "
@@ -112,6 +114,7 @@ static const char * tomahawk_schema_sql =
 "CREATE UNIQUE INDEX file_url_src_uniq ON file(source, url);"
 "CREATE INDEX file_source ON file(source);"
 "CREATE INDEX file_mtime ON file(mtime);"
+"CREATE INDEX file_source_dir ON file(source, dir);"
 "CREATE TABLE IF NOT EXISTS dirs_scanned ("
 "    name TEXT PRIMARY KEY,"
 "    mtime INTEGER NOT NULL"
@@ -185,6 +188,18 @@ static const char * tomahawk_schema_sql =
 "CREATE INDEX playback_log_source ON playback_log(source);"
 "CREATE INDEX playback_log_track ON playback_log(track);"
 "CREATE INDEX playback_log_playtime ON playback_log(playtime);"
+"CREATE TABLE IF NOT EXISTS playback_log_daily ("
+"    source INTEGER NOT NULL DEFAULT 0,      "
+"    track INTEGER REFERENCES track(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,"
+"    artist INTEGER REFERENCES artist(id) ON DELETE CASCADE ON UPDATE CASCADE DEFERRABLE INITIALLY DEFERRED,"
+"    day INTEGER NOT NULL,                   "
+"    plays INTEGER NOT NULL DEFAULT 0,"
+"    secs_played INTEGER NOT NULL DEFAULT 0,"
+"    UNIQUE(source, track, day)"
+");"
+"CREATE INDEX playback_log_daily_track ON playback_log_daily(track, day);"
+"CREATE INDEX playback_log_daily_artist ON playback_log_daily(artist, day);"
+"CREATE INDEX playback_log_daily_day ON playback_log_daily(day);"
 "CREATE TABLE IF NOT EXISTS http_client_auth ("
 "    token TEXT NOT NULL PRIMARY KEY,"
 "    website TEXT NOT NULL,"
@@ -197,7 +212,7 @@ static const char * tomahawk_schema_sql =
 "    k TEXT NOT NULL PRIMARY KEY,"
 "    v TEXT NOT NULL DEFAULT ''"
 ");"
-"INSERT INTO settings(k,v) VALUES('schema_version', '31');"
+"INSERT INTO settings(k,v) VALUES('schema_version', '34');"
     ;
 
 const char * get_tomahawk_sql()
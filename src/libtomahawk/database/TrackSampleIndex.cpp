@@ -0,0 +1,371 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TrackSampleIndex.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <cstdlib>
+
+// Random draws per requested track before we give up and scan the candidates
+#define DRAWS_PER_TRACK 8
+
+using namespace Tomahawk;
+
+
+// qrand() may only give us 15 bits, combine a few calls for large collections
+static quint32
+randomBelow( quint32 n )
+{
+    const quint64 r = ( (quint64)qrand() * ( (quint64)RAND_MAX + 1 ) + (quint64)qrand() ) * ( (quint64)RAND_MAX + 1 ) + (quint64)qrand();
+    return (quint32)( r % n );
+}
+
+
+TrackSampleIndex::Constraints::Constraints()
+    : minYear( 0 )
+    , maxYear( 0 )
+    , minPlays( -1 )
+    , maxPlays( -1 )
+    , playedSince( 0 )
+    , notPlayedSince( 0 )
+{
+}
+
+
+TrackSampleIndex::TrackSampleIndex()
+    : m_loaded( false )
+{
+}
+
+
+bool
+TrackSampleIndex::isLoaded() const
+{
+    QReadLocker lock( &m_lock );
+    return m_loaded;
+}
+
+
+void
+TrackSampleIndex::setLoaded( bool loaded )
+{
+    QWriteLocker lock( &m_lock );
+    m_loaded = loaded;
+}
+
+
+void
+TrackSampleIndex::clear()
+{
+    QWriteLocker lock( &m_lock );
+
+    m_entries.clear();
+    m_rows.clear();
+    m_artistRows.clear();
+    m_albumRows.clear();
+    m_yearRows.clear();
+    m_loaded = false;
+}
+
+
+int
+TrackSampleIndex::count() const
+{
+    QReadLocker lock( &m_lock );
+    return m_entries.count();
+}
+
+
+void
+TrackSampleIndex::insert( int track, int artist, int album, int year )
+{
+    QWriteLocker lock( &m_lock );
+    if ( !m_loaded )
+        return;
+
+    insertUnlocked( track, artist, album, year );
+}
+
+
+void
+TrackSampleIndex::addPlayback( int track, uint playtime )
+{
+    QWriteLocker lock( &m_lock );
+    if ( !m_loaded )
+        return;
+
+    // Only tracks in a collection are sampled, we don't care about the rest
+    QHash< int, int >::const_iterator it = m_rows.constFind( track );
+    if ( it == m_rows.constEnd() )
+        return;
+
+    Entry& entry = m_entries[ it.value() ];
+    entry.plays++;
+    entry.lastPlayed = qMax( entry.lastPlayed, playtime );
+}
+
+
+void
+TrackSampleIndex::load( int track, int artist, int album, int year )
+{
+    QWriteLocker lock( &m_lock );
+    insertUnlocked( track, artist, album, year );
+}
+
+
+void
+TrackSampleIndex::loadPlays( int track, int plays, uint lastPlayed )
+{
+    QWriteLocker lock( &m_lock );
+
+    QHash< int, int >::const_iterator it = m_rows.constFind( track );
+    if ( it == m_rows.constEnd() )
+        return;
+
+    Entry& entry = m_entries[ it.value() ];
+    entry.plays = plays;
+    entry.lastPlayed = lastPlayed;
+}
+
+
+void
+TrackSampleIndex::insertUnlocked( int track, int artist, int album, int year )
+{
+    QHash< int, int >::const_iterator it = m_rows.constFind( track );
+    if ( it != m_rows.constEnd() )
+    {
+        // The same track in another file, maybe from another album or with a year this time
+        const int row = it.value();
+        Entry& entry = m_entries[ row ];
+
+        if ( album > 0 && !m_albumRows.value( album ).contains( row ) )
+        {
+            m_albumRows[ album ] << row;
+            if ( !entry.album )
+                entry.album = album;
+        }
+        if ( year > 0 && !entry.year )
+        {
+            entry.year = year;
+            m_yearRows[ year ] << row;
+        }
+
+        return;
+    }
+
+    Entry entry;
+    entry.track = track;
+    entry.artist = artist;
+    entry.album = qMax( 0, album );
+    entry.year = qMax( 0, year );
+    entry.plays = 0;
+    entry.lastPlayed = 0;
+
+    const int row = m_entries.count();
+    m_entries << entry;
+    m_rows.insert( track, row );
+
+    m_artistRows[ artist ] << row;
+    if ( entry.album )
+        m_albumRows[ entry.album ] << row;
+    if ( entry.year )
+        m_yearRows[ entry.year ] << row;
+}
+
+
+bool
+TrackSampleIndex::matches( const Entry& entry, const Constraints& c, const QSet< int >& artists ) const
+{
+    if ( !artists.isEmpty() && !artists.contains( entry.artist ) )
+        return false;
+    if ( c.minYear > 0 && entry.year < c.minYear )
+        return false;
+    if ( c.maxYear > 0 && ( !entry.year || entry.year > c.maxYear ) )
+        return false;
+    if ( c.minPlays >= 0 && entry.plays < c.minPlays )
+        return false;
+    if ( c.maxPlays >= 0 && entry.plays > c.maxPlays )
+        return false;
+    if ( c.playedSince > 0 && entry.lastPlayed < c.playedSince )
+        return false;
+    if ( c.notPlayedSince > 0 && entry.lastPlayed >= c.notPlayedSince )
+        return false;
+
+    return true;
+}
+
+
+QList< int >
+TrackSampleIndex::sample( const Constraints& c, int count, const QSet< int >& exclude ) const
+{
+    QReadLocker lock( &m_lock );
+
+    QList< int > result;
+    if ( count <= 0 || m_entries.isEmpty() )
+        return result;
+
+    // Pick the buckets every match has to be in. Albums and artists are
+    // lists of ids we can look up, years a range in the sorted map.
+    QList< const QVector< int >* > buckets;
+    bool allRows = false;
+    QSet< int > artists;
+
+    if ( !c.albums.isEmpty() )
+    {
+        foreach ( int album, c.albums )
+        {
+            QHash< int, QVector< int > >::const_iterator it = m_albumRows.constFind( album );
+            if ( it != m_albumRows.constEnd() )
+                buckets << &it.value();
+        }
+
+        // Albums are small, the artist is checked per track
+        artists = c.artists.toSet();
+    }
+    else if ( !c.artists.isEmpty() )
+    {
+        foreach ( int artist, c.artists )
+        {
+            QHash< int, QVector< int > >::const_iterator it = m_artistRows.constFind( artist );
+            if ( it != m_artistRows.constEnd() )
+                buckets << &it.value();
+        }
+    }
+    else if ( c.minYear > 0 || c.maxYear > 0 )
+    {
+        QMap< int, QVector< int > >::const_iterator it = m_yearRows.lowerBound( qMax( 1, c.minYear ) );
+        for ( ; it != m_yearRows.constEnd() && ( c.maxYear <= 0 || it.key() <= c.maxYear ); ++it )
+            buckets << &it.value();
+    }
+    else
+        allRows = true;
+
+    // Running totals, so a random position maps to a bucket with a binary search
+    QVector< int > offsets;
+    int total = 0;
+    if ( allRows )
+        total = m_entries.count();
+    else
+    {
+        foreach ( const QVector< int >* bucket, buckets )
+        {
+            offsets << total;
+            total += bucket->count();
+        }
+    }
+
+    if ( !total )
+        return result;
+
+    QSet< int > taken;
+
+    // Draw random candidates and keep the ones that match. Unless almost
+    // none of them do, this only looks at a few times count tracks.
+    if ( (qint64)total > (qint64)count * 4 )
+    {
+        const int draws = count * DRAWS_PER_TRACK;
+        for ( int i = 0; i < draws && result.count() < count; i++ )
+        {
+            const int pos = (int)randomBelow( total );
+
+            int row = pos;
+            if ( !allRows )
+            {
+                const int bucket = ( std::upper_bound( offsets.constBegin(), offsets.constEnd(), pos ) - offsets.constBegin() ) - 1;
+                row = buckets.at( bucket )->at( pos - offsets.at( bucket ) );
+            }
+
+            const Entry& entry = m_entries.at( row );
+            if ( taken.contains( row ) || exclude.contains( entry.track ) || !matches( entry, c, artists ) )
+                continue;
+
+            taken << row;
+            result << entry.track;
+        }
+
+        if ( result.count() >= count )
+            return result;
+    }
+
+    // Few candidates or few of them match, look at all of them and shuffle
+    // what's left over into the result.
+    QVector< int > left;
+    if ( allRows )
+    {
+        for ( int row = 0; row < m_entries.count(); row++ )
+        {
+            const Entry& entry = m_entries.at( row );
+            if ( !taken.contains( row ) && !exclude.contains( entry.track ) && matches( entry, c, artists ) )
+                left << row;
+        }
+    }
+    else
+    {
+        foreach ( const QVector< int >* bucket, buckets )
+        {
+            foreach ( int row, *bucket )
+            {
+                const Entry& entry = m_entries.at( row );
+                if ( taken.contains( row ) || exclude.contains( entry.track ) || !matches( entry, c, artists ) )
+                    continue;
+
+                // A track on several of the albums is in several buckets
+                taken << row;
+                left << row;
+            }
+        }
+    }
+
+    for ( int i = 0; i < left.count() && result.count() < count; i++ )
+    {
+        const int j = i + (int)randomBelow( left.count() - i );
+        qSwap( left[ i ], left[ j ] );
+        result << m_entries.at( left.at( i ) ).track;
+    }
+
+    return result;
+}
+
+
+int
+TrackSampleIndex::album( int track ) const
+{
+    QReadLocker lock( &m_lock );
+
+    QHash< int, int >::const_iterator it = m_rows.constFind( track );
+    if ( it == m_rows.constEnd() )
+        return 0;
+
+    return m_entries.at( it.value() ).album;
+}
+
+
+int
+TrackSampleIndex::artist( int track ) const
+{
+    QReadLocker lock( &m_lock );
+
+    QHash< int, int >::const_iterator it = m_rows.constFind( track );
+    if ( it == m_rows.constEnd() )
+        return 0;
+
+    return m_entries.at( it.value() ).artist;
+}
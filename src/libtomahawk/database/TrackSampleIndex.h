@@ -0,0 +1,127 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACKSAMPLEINDEX_H
+#define TRACKSAMPLEINDEX_H
+
+#include "DllMacro.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QVector>
+
+namespace Tomahawk
+{
+
+/**
+ * In-memory index over all tracks in the collections, for drawing random
+ * tracks that match a set of constraints.
+ *
+ * Every track is stored once with its artist, album, release year and how
+ * often and when it was last played. Tracks are bucketed by artist, album
+ * and year, so a sample only has to look at the tracks that can possibly
+ * match instead of scanning the whole collection with ORDER BY RANDOM().
+ *
+ * All methods are thread-safe.
+ */
+class DLLEXPORT TrackSampleIndex
+{
+public:
+    struct DLLEXPORT Constraints
+    {
+        Constraints();
+
+        QList< int > artists;   // by any of these artists, all if empty
+        QList< int > albums;    // on any of these albums, all if empty
+        int minYear;            // released in or after, 0 for any
+        int maxYear;            // released in or before, 0 for any
+        int minPlays;           // played at least that often, -1 for any
+        int maxPlays;           // played at most that often, -1 for any
+        uint playedSince;       // last played at or after that time, 0 for any
+        uint notPlayedSince;    // not played at or after that time, 0 for any
+    };
+
+    TrackSampleIndex();
+
+    bool isLoaded() const;
+    void setLoaded( bool loaded );
+    void clear();
+
+    int count() const;
+
+    /**
+     * Adds a track to the index. Does nothing until the index was loaded,
+     * the initial load will pick up the track from the database instead.
+     */
+    void insert( int track, int artist, int album, int year );
+
+    /**
+     * Counts a playback of track. Does nothing until the index was loaded.
+     */
+    void addPlayback( int track, uint playtime );
+
+    /**
+     * Add a track and its playbacks during the initial load, before
+     * setLoaded() got called.
+     */
+    void load( int track, int artist, int album, int year );
+    void loadPlays( int track, int plays, uint lastPlayed );
+
+    /**
+     * Returns the ids of up to count distinct random tracks that match
+     * constraints, leaving out the ones in exclude.
+     *
+     * Draws from the smallest set of buckets the constraints allow and only
+     * falls back to looking at every candidate if few of them match.
+     */
+    QList< int > sample( const Constraints& constraints, int count, const QSet< int >& exclude = QSet< int >() ) const;
+
+    // Album and artist a track was indexed with, 0 if unknown
+    int album( int track ) const;
+    int artist( int track ) const;
+
+private:
+    struct Entry
+    {
+        int track;
+        int artist;
+        int album;
+        int year;
+        int plays;
+        uint lastPlayed;
+    };
+
+    void insertUnlocked( int track, int artist, int album, int year );
+    bool matches( const Entry& entry, const Constraints& constraints, const QSet< int >& artists ) const;
+
+    QVector< Entry > m_entries;
+    QHash< int, int > m_rows; // track id -> row in m_entries
+    QHash< int, QVector< int > > m_artistRows;
+    QHash< int, QVector< int > > m_albumRows;
+    QMap< int, QVector< int > > m_yearRows;
+
+    bool m_loaded;
+    mutable QReadWriteLock m_lock;
+};
+
+}
+
+#endif // TRACKSAMPLEINDEX_H
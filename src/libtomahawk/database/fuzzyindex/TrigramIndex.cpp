@@ -0,0 +1,242 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TrigramIndex.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+
+using namespace Tomahawk;
+
+
+static bool
+shorterList( const QVector< int >* left, const QVector< int >* right )
+{
+    return left->count() < right->count();
+}
+
+
+TrigramIndex::TrigramIndex()
+    : m_loaded( false )
+{
+}
+
+
+bool
+TrigramIndex::isLoaded() const
+{
+    QReadLocker lock( &m_lock );
+    return m_loaded;
+}
+
+
+void
+TrigramIndex::setLoaded( bool loaded )
+{
+    QWriteLocker lock( &m_lock );
+    m_loaded = loaded;
+}
+
+
+void
+TrigramIndex::clear()
+{
+    QWriteLocker lock( &m_lock );
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        m_index[ i ].names.clear();
+        m_index[ i ].postings.clear();
+        m_index[ i ].loadedUpTo = 0;
+    }
+    m_loaded = false;
+}
+
+
+void
+TrigramIndex::insert( NameType type, int id, const QString& name )
+{
+    QWriteLocker lock( &m_lock );
+    if ( !m_loaded )
+        return;
+
+    insertUnlocked( type, id, name );
+}
+
+
+void
+TrigramIndex::load( NameType type, int id, const QString& name )
+{
+    QWriteLocker lock( &m_lock );
+    insertUnlocked( type, id, name );
+
+    m_index[ type ].loadedUpTo = qMax( m_index[ type ].loadedUpTo, id );
+}
+
+
+int
+TrigramIndex::loadedUpTo( NameType type ) const
+{
+    QReadLocker lock( &m_lock );
+    return m_index[ type ].loadedUpTo;
+}
+
+
+void
+TrigramIndex::insertUnlocked( NameType type, int id, const QString& name )
+{
+    TypeIndex& idx = m_index[ type ];
+
+    // A rolled back insert can leave its AUTOINCREMENT id to another name
+    QHash< int, QString >::iterator it = idx.names.find( id );
+    if ( it != idx.names.end() )
+    {
+        if ( it.value() == name )
+            return;
+
+        foreach ( quint64 gram, trigrams( it.value() ) )
+        {
+            QVector< int >& list = idx.postings[ gram ];
+            list.remove( list.indexOf( id ) );
+            if ( list.isEmpty() )
+                idx.postings.remove( gram );
+        }
+    }
+
+    idx.names.insert( id, name );
+    foreach ( quint64 gram, trigrams( name ) )
+        idx.postings[ gram ] << id;
+}
+
+
+QList< int >
+TrigramIndex::search( NameType type, const QString& term, bool fuzzy, int maxResults, bool* truncated ) const
+{
+    QReadLocker lock( &m_lock );
+    const TypeIndex& idx = m_index[ type ];
+
+    if ( truncated )
+        *truncated = false;
+
+    QList< int > result;
+    const QVector< quint64 > grams = trigrams( term );
+
+    if ( grams.isEmpty() )
+    {
+        // Too short to have any trigrams, we have to check every name.
+        // Callers with a faster way for those should not ask us.
+        QHash< int, QString >::const_iterator it = idx.names.constBegin();
+        for ( ; it != idx.names.constEnd(); ++it )
+        {
+            if ( !it.value().contains( term ) )
+                continue;
+
+            result << it.key();
+            if ( result.count() > maxResults )
+            {
+                if ( truncated )
+                    *truncated = true;
+                return QList< int >();
+            }
+        }
+
+        return result;
+    }
+
+    QList< const QVector< int >* > lists;
+    foreach ( quint64 gram, grams )
+    {
+        QHash< quint64, QVector< int > >::const_iterator it = idx.postings.constFind( gram );
+        if ( it != idx.postings.constEnd() )
+            lists << &it.value();
+    }
+
+    // Only names that contain all of the term's trigrams can contain the term.
+    // Checking the candidates of the rarest trigram is enough to find them.
+    if ( lists.count() == grams.count() )
+    {
+        std::sort( lists.begin(), lists.end(), shorterList );
+        foreach ( int id, *lists.first() )
+        {
+            if ( !idx.names.value( id ).contains( term ) )
+                continue;
+
+            result << id;
+            if ( result.count() > maxResults )
+            {
+                if ( truncated )
+                    *truncated = true;
+                return QList< int >();
+            }
+        }
+    }
+
+    if ( !result.isEmpty() || !fuzzy || lists.isEmpty() )
+        return result;
+
+    // No exact match, accept names that share at least half of the term's trigrams
+    QHash< int, int > hits;
+    foreach ( const QVector< int >* list, lists )
+    {
+        foreach ( int id, *list )
+            hits[ id ]++;
+    }
+
+    const int needed = qMax( 2, ( grams.count() + 1 ) / 2 );
+    QHash< int, int >::const_iterator it = hits.constBegin();
+    for ( ; it != hits.constEnd(); ++it )
+    {
+        if ( it.value() < needed )
+            continue;
+
+        result << it.key();
+        if ( result.count() > maxResults )
+        {
+            if ( truncated )
+                *truncated = true;
+            return QList< int >();
+        }
+    }
+
+    return result;
+}
+
+
+QVector< quint64 >
+TrigramIndex::trigrams( const QString& str )
+{
+    QVector< quint64 > grams;
+    if ( str.length() < 3 )
+        return grams;
+
+    grams.reserve( str.length() - 2 );
+    for ( int i = 0; i + 2 < str.length(); i++ )
+    {
+        grams << ( ( (quint64)str.at( i ).unicode() << 32 ) |
+                   ( (quint64)str.at( i + 1 ).unicode() << 16 ) |
+                     (quint64)str.at( i + 2 ).unicode() );
+    }
+
+    // A name must only show up once in each posting list
+    std::sort( grams.begin(), grams.end() );
+    grams.erase( std::unique( grams.begin(), grams.end() ), grams.end() );
+
+    return grams;
+}
@@ -0,0 +1,110 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include "DllMacro.h"
+
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+namespace Tomahawk
+{
+
+/**
+ * In-memory substring index over the names of artists, albums and tracks.
+ *
+ * Every name is split into overlapping three-character chunks, each of which
+ * maps to the ids of all names containing it. A substring search intersects
+ * the lists of the term's chunks, so it only has to look at names that can
+ * possibly match instead of scanning the whole table.
+ *
+ * Names are expected to be normalized with DatabaseImpl::sortname().
+ * All methods are thread-safe.
+ */
+class DLLEXPORT TrigramIndex
+{
+public:
+    enum NameType
+    {
+        Artist = 0,
+        Album = 1,
+        Track = 2
+    };
+
+    TrigramIndex();
+
+    bool isLoaded() const;
+    void setLoaded( bool loaded );
+    void clear();
+
+    /**
+     * Adds a name to the index, replacing what it had for id before. Does
+     * nothing until the index was loaded, the initial load will pick up the
+     * name from the database instead.
+     */
+    void insert( NameType type, int id, const QString& name );
+
+    /**
+     * Adds a name read from the database, during the initial load or when
+     * catching up with names the load couldn't see yet.
+     */
+    void load( NameType type, int id, const QString& name );
+
+    /**
+     * The highest id added with load(). Names inserted by a transaction
+     * that was still running during the load have higher ids than that.
+     */
+    int loadedUpTo( NameType type ) const;
+
+    /**
+     * Returns the ids of all names containing term. If there are none and
+     * fuzzy is true, names sharing most of the term's trigrams are returned
+     * instead, which tolerates small typos. Terms shorter than three
+     * characters have no trigrams and are matched against every name.
+     *
+     * Stops and returns an empty list with *truncated set if more than
+     * maxResults ids match.
+     */
+    QList< int > search( NameType type, const QString& term, bool fuzzy, int maxResults, bool* truncated = 0 ) const;
+
+private:
+    struct TypeIndex
+    {
+        TypeIndex() : loadedUpTo( 0 ) {}
+
+        QHash< int, QString > names;
+        QHash< quint64, QVector< int > > postings;
+        int loadedUpTo;
+    };
+
+    static QVector< quint64 > trigrams( const QString& str );
+    void insertUnlocked( NameType type, int id, const QString& name );
+
+    TypeIndex m_index[ 3 ];
+    bool m_loaded;
+    mutable QReadWriteLock m_lock;
+};
+
+}
+
+#endif // TRIGRAMINDEX_H
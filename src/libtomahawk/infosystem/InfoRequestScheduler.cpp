@@ -0,0 +1,470 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InfoRequestScheduler.h"
+
+#include "utils/Logger.h"
+#include "utils/NetworkAccessManager.h"
+
+#include <QDateTime>
+#include <QPointer>
+
+#include <string.h>
+
+#define DEFAULT_MAX_CONCURRENT 4
+#define PRIORITY_CLASSES ( InfoPriorityLow + 1 )
+
+namespace Tomahawk
+{
+
+namespace InfoSystem
+{
+
+/**
+ * What the caller of InfoRequestScheduler::get() holds on to. Gets the body,
+ * status and headers of the network request it waits for, which may be
+ * shared with other ScheduledReplies, once that is done.
+ */
+class ScheduledReply : public QNetworkReply
+{
+public:
+    ScheduledReply( InfoRequestScheduler* scheduler, const QNetworkRequest& request, quint64 requestId )
+        : QNetworkReply( scheduler )
+        , m_scheduler( scheduler )
+        , m_job( 0 )
+        , m_requestId( requestId )
+        , m_offset( 0 )
+    {
+        setRequest( request );
+        setUrl( request.url() );
+        setOperation( QNetworkAccessManager::GetOperation );
+        open( QIODevice::ReadOnly | QIODevice::Unbuffered );
+    }
+
+    virtual ~ScheduledReply()
+    {
+        if ( m_scheduler )
+            m_scheduler.data()->detach( this );
+    }
+
+    virtual void abort()
+    {
+        if ( !m_scheduler || !m_job )
+            return;
+
+        m_scheduler.data()->detach( this );
+        finish( OperationCanceledError, "Operation canceled" );
+    }
+
+    virtual bool isSequential() const
+    {
+        return true;
+    }
+
+    virtual qint64 bytesAvailable() const
+    {
+        return m_data.size() - m_offset + QNetworkReply::bytesAvailable();
+    }
+
+    void complete( QNetworkReply* reply, const QByteArray& data )
+    {
+        setUrl( reply->url() );
+        setAttribute( QNetworkRequest::HttpStatusCodeAttribute, reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ) );
+        setAttribute( QNetworkRequest::HttpReasonPhraseAttribute, reply->attribute( QNetworkRequest::HttpReasonPhraseAttribute ) );
+        setAttribute( QNetworkRequest::RedirectionTargetAttribute, reply->attribute( QNetworkRequest::RedirectionTargetAttribute ) );
+        setAttribute( QNetworkRequest::SourceIsFromCacheAttribute, reply->attribute( QNetworkRequest::SourceIsFromCacheAttribute ) );
+        foreach ( const RawHeaderPair& header, reply->rawHeaderPairs() )
+            setRawHeader( header.first, header.second );
+
+        m_data = data;
+        finish( reply->error(), reply->errorString() );
+    }
+
+    void finish( NetworkError code, const QString& errorString )
+    {
+        m_job = 0;
+
+        if ( code != NoError )
+        {
+            setError( code, errorString );
+            emit error( code );
+        }
+        if ( !m_data.isEmpty() )
+            emit readyRead();
+
+#if QT_VERSION >= QT_VERSION_CHECK( 4, 8, 0 )
+        setFinished( true );
+#endif
+        emit finished();
+    }
+
+    QPointer< InfoRequestScheduler > m_scheduler;
+    InfoRequestScheduler::Job* m_job;
+    quint64 m_requestId;
+
+protected:
+    virtual qint64 readData( char* data, qint64 maxSize )
+    {
+        const qint64 count = qMin( maxSize, (qint64)m_data.size() - m_offset );
+        memcpy( data, m_data.constData() + m_offset, count );
+        m_offset += count;
+        return count;
+    }
+
+private:
+    QByteArray m_data;
+    qint64 m_offset;
+};
+
+
+struct InfoRequestScheduler::Job
+{
+    QString key;
+    QString host;
+    QNetworkRequest request;
+    InfoRequestPriority priority;
+    QNetworkReply* reply; // 0 while queued
+    QList< ScheduledReply* > waiters;
+};
+
+
+struct InfoRequestScheduler::Host
+{
+    int maxConcurrent;
+    qreal rate;
+    qreal burst;
+    qreal tokens;
+    qint64 refilled;
+    int running;
+    QQueue< Job* > queues[ PRIORITY_CLASSES ];
+};
+
+
+InfoRequestScheduler* InfoRequestScheduler::s_instance = 0;
+
+
+InfoRequestScheduler*
+InfoRequestScheduler::instance()
+{
+    return s_instance;
+}
+
+
+InfoRequestScheduler::InfoRequestScheduler( QObject* parent )
+    : QObject( parent )
+    , m_defaultMaxConcurrent( DEFAULT_MAX_CONCURRENT )
+    , m_defaultRate( 0 )
+    , m_defaultBurst( 1 )
+    , m_timerDue( 0 )
+{
+    s_instance = this;
+
+    m_timer.setSingleShot( true );
+    connect( &m_timer, SIGNAL( timeout() ), SLOT( pumpAll() ) );
+}
+
+
+InfoRequestScheduler::~InfoRequestScheduler()
+{
+    if ( s_instance == this )
+        s_instance = 0;
+
+    foreach ( Job* job, m_jobs )
+    {
+        if ( job->reply )
+        {
+            job->reply->disconnect( this );
+            job->reply->abort();
+            delete job->reply;
+        }
+        foreach ( ScheduledReply* reply, job->waiters )
+            reply->m_job = 0;
+
+        delete job;
+    }
+
+    qDeleteAll( m_hosts );
+}
+
+
+QNetworkReply*
+InfoRequestScheduler::get( const QNetworkRequest& request, const InfoRequestData& requestData )
+{
+    return enqueue( request, requestData.internalId, requestData.priority );
+}
+
+
+QNetworkReply*
+InfoRequestScheduler::get( const QNetworkRequest& request, InfoRequestPriority priority )
+{
+    return enqueue( request, 0, priority );
+}
+
+
+void
+InfoRequestScheduler::cancel( quint64 requestId )
+{
+    const QList< ScheduledReply* > replies = m_requests.take( requestId );
+    if ( replies.isEmpty() )
+        return;
+
+    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Canceling" << replies.count() << "requests for" << requestId;
+    foreach ( ScheduledReply* reply, replies )
+        reply->abort();
+}
+
+
+void
+InfoRequestScheduler::setHostLimits( const QString& name, int maxConcurrent, qreal ratePerSecond, int burst )
+{
+    Host& h = host( name.toLower() );
+    h.maxConcurrent = qMax( 1, maxConcurrent );
+    h.rate = qMax( (qreal)0, ratePerSecond );
+    h.burst = qMax( 1, burst );
+    h.tokens = h.burst;
+    h.refilled = QDateTime::currentMSecsSinceEpoch();
+
+    pump( h );
+}
+
+
+void
+InfoRequestScheduler::setDefaultLimits( int maxConcurrent, qreal ratePerSecond, int burst )
+{
+    m_defaultMaxConcurrent = qMax( 1, maxConcurrent );
+    m_defaultRate = qMax( (qreal)0, ratePerSecond );
+    m_defaultBurst = qMax( 1, burst );
+}
+
+
+int
+InfoRequestScheduler::running( const QString& name ) const
+{
+    const Host* h = m_hosts.value( name.toLower() );
+    return h ? h->running : 0;
+}
+
+
+int
+InfoRequestScheduler::queued( const QString& name ) const
+{
+    const Host* h = m_hosts.value( name.toLower() );
+    if ( !h )
+        return 0;
+
+    int count = 0;
+    for ( int i = 0; i < PRIORITY_CLASSES; i++ )
+        count += h->queues[ i ].count();
+
+    return count;
+}
+
+
+QNetworkReply*
+InfoRequestScheduler::enqueue( const QNetworkRequest& request, quint64 requestId, InfoRequestPriority priority )
+{
+    priority = (InfoRequestPriority)qBound( (int)InfoPriorityHigh, (int)priority, (int)InfoPriorityLow );
+
+    ScheduledReply* reply = new ScheduledReply( this, request, requestId );
+    if ( requestId )
+        m_requests[ requestId ] << reply;
+
+    const QString key = QString::fromLatin1( request.url().toEncoded() );
+    Job* job = m_jobs.value( key );
+    if ( !job )
+    {
+        job = new Job;
+        job->key = key;
+        job->host = request.url().host().toLower();
+        job->request = request;
+        job->priority = priority;
+        job->reply = 0;
+        m_jobs.insert( key, job );
+
+        host( job->host ).queues[ priority ].enqueue( job );
+    }
+    else if ( !job->reply && priority < job->priority )
+    {
+        // Someone needs the queued request sooner now
+        Host& h = host( job->host );
+        h.queues[ job->priority ].removeOne( job );
+        job->priority = priority;
+        h.queues[ priority ].enqueue( job );
+    }
+
+    job->waiters << reply;
+    reply->m_job = job;
+
+    pump( host( job->host ) );
+    return reply;
+}
+
+
+InfoRequestScheduler::Host&
+InfoRequestScheduler::host( const QString& name )
+{
+    Host* h = m_hosts.value( name );
+    if ( !h )
+    {
+        h = new Host;
+        h->maxConcurrent = m_defaultMaxConcurrent;
+        h->rate = m_defaultRate;
+        h->burst = m_defaultBurst;
+        h->tokens = h->burst;
+        h->refilled = QDateTime::currentMSecsSinceEpoch();
+        h->running = 0;
+        m_hosts.insert( name, h );
+    }
+
+    return *h;
+}
+
+
+void
+InfoRequestScheduler::pump( Host& h )
+{
+    while ( h.running < h.maxConcurrent )
+    {
+        int priority = InfoPriorityHigh;
+        while ( priority < PRIORITY_CLASSES && h.queues[ priority ].isEmpty() )
+            priority++;
+        if ( priority == PRIORITY_CLASSES )
+            return;
+
+        if ( h.rate > 0 )
+        {
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            h.tokens = qMin( h.burst, h.tokens + (qreal)( now - h.refilled ) * h.rate / 1000 );
+            h.refilled = now;
+
+            if ( h.tokens < 1 )
+            {
+                const qint64 due = now + (qint64)( ( 1 - h.tokens ) * 1000 / h.rate ) + 1;
+                if ( !m_timer.isActive() || due < m_timerDue )
+                {
+                    m_timerDue = due;
+                    m_timer.start( due - now );
+                }
+                return;
+            }
+            h.tokens -= 1;
+        }
+
+        Job* job = h.queues[ priority ].dequeue();
+        h.running++;
+        start( job );
+    }
+}
+
+
+void
+InfoRequestScheduler::pumpAll()
+{
+    foreach ( Host* h, m_hosts )
+        pump( *h );
+}
+
+
+void
+InfoRequestScheduler::start( Job* job )
+{
+    job->reply = Tomahawk::Utils::nam()->get( job->request );
+    m_running.insert( job->reply, job );
+
+    connect( job->reply, SIGNAL( finished() ), SLOT( onFinished() ) );
+}
+
+
+void
+InfoRequestScheduler::onFinished()
+{
+    QNetworkReply* reply = qobject_cast< QNetworkReply* >( sender() );
+    Job* job = m_running.take( reply );
+    if ( !job )
+        return;
+
+    const QByteArray data = reply->readAll();
+    reply->deleteLater();
+
+    m_jobs.remove( job->key );
+    Host& h = host( job->host );
+    h.running--;
+
+    // Everyone is done before the first of them hears about it, so answering
+    // one of them can't cancel or join the others
+    const QList< ScheduledReply* > waiters = job->waiters;
+    foreach ( ScheduledReply* waiter, waiters )
+    {
+        waiter->m_job = 0;
+        detach( waiter );
+    }
+    delete job;
+
+    pump( h );
+
+    foreach ( ScheduledReply* waiter, waiters )
+        waiter->complete( reply, data );
+}
+
+
+void
+InfoRequestScheduler::detach( ScheduledReply* reply )
+{
+    if ( reply->m_requestId && m_requests.contains( reply->m_requestId ) )
+    {
+        QList< ScheduledReply* >& replies = m_requests[ reply->m_requestId ];
+        replies.removeOne( reply );
+        if ( replies.isEmpty() )
+            m_requests.remove( reply->m_requestId );
+    }
+
+    Job* job = reply->m_job;
+    if ( !job )
+        return;
+
+    reply->m_job = 0;
+    job->waiters.removeOne( reply );
+    if ( job->waiters.isEmpty() )
+        drop( job );
+}
+
+
+void
+InfoRequestScheduler::drop( Job* job )
+{
+    m_jobs.remove( job->key );
+    Host& h = host( job->host );
+
+    if ( job->reply )
+    {
+        m_running.remove( job->reply );
+        job->reply->disconnect( this );
+        job->reply->abort();
+        job->reply->deleteLater();
+        h.running--;
+    }
+    else
+        h.queues[ job->priority ].removeOne( job );
+
+    delete job;
+    pump( h );
+}
+
+} // namespace InfoSystem
+
+} // namespace Tomahawk
@@ -0,0 +1,120 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_INFOREQUESTSCHEDULER_H
+#define TOMAHAWK_INFOREQUESTSCHEDULER_H
+
+#include "infosystem/InfoSystem.h"
+#include "DllMacro.h"
+
+#include <QHash>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QQueue>
+#include <QTimer>
+
+namespace Tomahawk
+{
+
+namespace InfoSystem
+{
+
+class ScheduledReply;
+
+/**
+ * Sends the HTTP requests of info plugins, instead of them calling
+ * Tomahawk::Utils::nam() directly.
+ *
+ * Every host gets at most maxConcurrent requests at a time and, if it has a
+ * rate set, a token bucket allowing burst requests at once and rate requests
+ * per second after that. Requests waiting for their host go out by priority
+ * first, then in the order they were made. GETs for a URL that is already
+ * queued or running share the network request made for it.
+ *
+ * The returned replies behave like the ones from QNetworkAccessManager, the
+ * caller owns them. Requests made for an InfoRequestData are dropped with
+ * cancel() once nobody waits for its answer anymore; their replies then
+ * finish with QNetworkReply::OperationCanceledError.
+ *
+ * Lives in the InfoSystemWorker thread, like the plugins using it.
+ */
+class DLLEXPORT InfoRequestScheduler : public QObject
+{
+Q_OBJECT
+
+public:
+    static InfoRequestScheduler* instance();
+
+    explicit InfoRequestScheduler( QObject* parent = 0 );
+    virtual ~InfoRequestScheduler();
+
+    QNetworkReply* get( const QNetworkRequest& request, const Tomahawk::InfoSystem::InfoRequestData& requestData );
+    // For requests that don't answer an InfoRequestData, e.g. refreshing a plugin's own data
+    QNetworkReply* get( const QNetworkRequest& request, Tomahawk::InfoSystem::InfoRequestPriority priority = InfoPriorityNormal );
+
+    /**
+     * Aborts every request made for the InfoRequestData with this internalId.
+     * Network requests shared with others keep running for them.
+     */
+    void cancel( quint64 requestId );
+
+    // A ratePerSecond of 0 means no rate limit
+    void setHostLimits( const QString& host, int maxConcurrent, qreal ratePerSecond = 0, int burst = 1 );
+    void setDefaultLimits( int maxConcurrent, qreal ratePerSecond = 0, int burst = 1 );
+
+    int running( const QString& host ) const;
+    int queued( const QString& host ) const;
+
+private slots:
+    void onFinished();
+    void pumpAll();
+
+private:
+    friend class ScheduledReply;
+
+    struct Job;
+    struct Host;
+
+    QNetworkReply* enqueue( const QNetworkRequest& request, quint64 requestId, InfoRequestPriority priority );
+    Host& host( const QString& name );
+    void pump( Host& host );
+    void start( Job* job );
+    void detach( ScheduledReply* reply );
+    void drop( Job* job );
+
+    QHash< QString, Host* > m_hosts;
+    QHash< QString, Job* > m_jobs;
+    QHash< QNetworkReply*, Job* > m_running;
+    QHash< quint64, QList< ScheduledReply* > > m_requests;
+
+    int m_defaultMaxConcurrent;
+    qreal m_defaultRate;
+    int m_defaultBurst;
+
+    // Wakes us up once the next rate limited host has a token again
+    QTimer m_timer;
+    qint64 m_timerDue;
+
+    static InfoRequestScheduler* s_instance;
+};
+
+} // namespace InfoSystem
+
+} // namespace Tomahawk
+
+#endif // TOMAHAWK_INFOREQUESTSCHEDULER_H
@@ -60,6 +60,7 @@ InfoRequestData::init( const QString& callr, const InfoType typ, const QVariant&
     customData = custom;
     timeoutMillis = DEFAULT_TIMEOUT_MILLIS;
     allSources = false;
+    priority = InfoPriorityNormal;
 }
 
 
@@ -49,6 +49,12 @@ enum PushInfoFlags { // must be powers of 2
     PushShortUrlFlag = 2
 };
 
+enum InfoRequestPriority {
+    InfoPriorityHigh = 0, // for something the user is looking at right now
+    InfoPriorityNormal = 1,
+    InfoPriorityLow = 2 // prefetching and other background work
+};
+
 
 struct DLLEXPORT InfoRequestData {
     quint64 requestId;
@@ -59,6 +65,7 @@ struct DLLEXPORT InfoRequestData {
     QVariantMap customData;
     uint timeoutMillis;
     bool allSources;
+    Tomahawk::InfoSystem::InfoRequestPriority priority;
 
     InfoRequestData();
 
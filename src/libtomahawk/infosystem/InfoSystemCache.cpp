@@ -23,10 +23,14 @@
 #include "InfoSystemCache.h"
 #include "TomahawkSettings.h"
 #include "utils/Logger.h"
+#include "utils/TomahawkUtils.h"
 #include "Source.h"
 
+#include <QDataStream>
 #include <QDir>
 #include <QSettings>
+#include <QSqlError>
+#include <QSqlQuery>
 #include <QCryptographicHash>
 
 namespace Tomahawk
@@ -43,12 +47,42 @@ InfoSystemCache::InfoSystemCache( QObject* parent )
 {
     tDebug() << Q_FUNC_INFO;
 
+    const QString dbPath = TomahawkSettings::instance()->storageCacheLocation() + "/InfoSystemCache.db";
     if ( TomahawkSettings::instance()->infoSystemCacheVersion() < s_infosystemCacheVersion )
     {
         TomahawkUtils::removeDirectory( m_cacheBaseDir );
+        QFile::remove( dbPath );
         TomahawkSettings::instance()->setInfoSystemCacheVersion( s_infosystemCacheVersion );
     }
 
+    QDir().mkpath( TomahawkSettings::instance()->storageCacheLocation() );
+
+    // We live in our own thread, so we get our own connection
+    m_db = QSqlDatabase::addDatabase( "QSQLITE", "InfoSystemCache" );
+    m_db.setDatabaseName( dbPath );
+    if ( !m_db.open() )
+    {
+        tLog() << "Failed to open infosystem cache" << dbPath << m_db.lastError().text();
+    }
+    else
+    {
+        // It's only a cache, losing the last few writes on a crash is fine
+        QSqlQuery query( m_db );
+        query.exec( "PRAGMA synchronous = OFF" );
+        query.exec( "PRAGMA journal_mode = WAL" );
+        query.exec( "CREATE TABLE IF NOT EXISTS infocache ("
+                    "    type INTEGER NOT NULL,"
+                    "    hash TEXT NOT NULL,"
+                    "    expires INTEGER NOT NULL,"
+                    "    data BLOB,"
+                    "    PRIMARY KEY( type, hash )"
+                    ")" );
+        query.exec( "CREATE INDEX IF NOT EXISTS infocache_expires ON infocache(expires)" );
+
+        if ( QDir( m_cacheBaseDir ).exists() )
+            migrateCacheDirectory();
+    }
+
     m_pruneTimer.setInterval( 300000 );
     m_pruneTimer.setSingleShot( false );
     connect( &m_pruneTimer, SIGNAL( timeout() ), SLOT( pruneTimerFired() ) );
@@ -59,36 +93,54 @@ InfoSystemCache::InfoSystemCache( QObject* parent )
 InfoSystemCache::~InfoSystemCache()
 {
     tDebug() << Q_FUNC_INFO;
+
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase( "InfoSystemCache" );
 }
 
 
 void
-InfoSystemCache::pruneTimerFired()
+InfoSystemCache::migrateCacheDirectory()
 {
-    qDebug() << Q_FUNC_INFO << "Pruning infosystemcache";
-    qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    // Older versions stored every entry in its own file: <type>/<md5>.<expiry>
+    tLog() << "Migrating infosystem cache directory" << m_cacheBaseDir;
+    const qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
 
+    m_db.transaction();
     for ( int i = InfoNoInfo; i <= InfoLastInfo; i++ )
     {
-        InfoType type = (InfoType)(i);
-        QHash< QString, QString > fileLocationHash = m_fileLocationCache[type];
-        const QString cacheDirName = m_cacheBaseDir + QString::number( (int)type );
+        const QString cacheDirName = m_cacheBaseDir + QString::number( i );
         QFileInfoList fileList = QDir( cacheDirName ).entryInfoList( QDir::Files | QDir::NoDotAndDotDot );
-        foreach ( QFileInfo file, fileList )
+        foreach ( const QFileInfo& file, fileList )
         {
-            QString baseName = file.baseName();
-            if ( file.suffix().toLongLong() < currentMSecsSinceEpoch )
-            {
-                if ( !QFile::remove( file.canonicalFilePath() ) )
-                    tLog() << "Failed to remove stale cache file" << file.canonicalFilePath();
-                else
-                    qDebug() << "Removed stale cache file" << file.canonicalFilePath();
-            }
-            if ( fileLocationHash.contains( baseName ) )
-                fileLocationHash.remove( baseName );
+            const qlonglong expires = file.suffix().toLongLong();
+            if ( expires < currentMSecsSinceEpoch )
+                continue;
+
+            QSettings cachedSettings( file.absoluteFilePath(), QSettings::IniFormat );
+            store( (InfoType)i, file.baseName(), expires, cachedSettings.value( "data" ) );
         }
-        m_fileLocationCache[type] = fileLocationHash;
     }
+    m_db.commit();
+
+    if ( !TomahawkUtils::removeDirectory( m_cacheBaseDir ) )
+        tLog() << "Failed to remove old infosystem cache directory" << m_cacheBaseDir;
+}
+
+
+void
+InfoSystemCache::pruneTimerFired()
+{
+    qDebug() << Q_FUNC_INFO << "Pruning infosystemcache";
+
+    QSqlQuery query( m_db );
+    query.prepare( "DELETE FROM infocache WHERE expires < ?" );
+    query.addBindValue( QDateTime::currentMSecsSinceEpoch() );
+    if ( !query.exec() )
+        tLog() << "Failed to prune infosystem cache" << query.lastError().text();
+    else
+        qDebug() << "Removed" << query.numRowsAffected() << "stale cache entries";
 }
 
 
@@ -98,90 +150,54 @@ InfoSystemCache::getCachedInfoSlot( Tomahawk::InfoSystem::InfoStringHash criteri
     QObject* sendingObj = sender();
     const QString criteriaHashVal = criteriaMd5( criteria );
     const QString criteriaHashValWithType = criteriaMd5( criteria, requestData.type );
-    QHash< QString, QString > fileLocationHash = m_fileLocationCache[ requestData.type ];
-    if ( !fileLocationHash.contains( criteriaHashVal ) )
-    {
-        if ( !fileLocationHash.isEmpty() )
-        {
-            //We already know of some values, so no need to re-read the directory again as it's already happened
-            //qDebug() << Q_FUNC_INFO << "notInCache -- filelocationhash empty";
-            notInCache( sendingObj, criteria, requestData );
-            return;
-        }
 
-        const QString cacheDir = m_cacheBaseDir + QString::number( (int)requestData.type );
-        QDir dir( cacheDir );
-        if ( !dir.exists() )
-        {
-            //Dir doesn't exist so clearly not in cache
-            //qDebug() << Q_FUNC_INFO << "notInCache -- dir doesn't exist";
-            notInCache( sendingObj, criteria, requestData );
-            return;
-        }
-
-        QFileInfoList fileList = dir.entryInfoList( QDir::Files | QDir::NoDotAndDotDot );
-        foreach ( QFileInfo file, fileList )
-        {
-            QString baseName = file.baseName();
-            fileLocationHash[ baseName ] = file.canonicalFilePath();
-        }
-
-        //Store what we've loaded up
-        m_fileLocationCache[ requestData.type ] = fileLocationHash;
-        if ( !fileLocationHash.contains( criteriaHashVal ) )
-        {
-            //Still didn't find it? It's really not in the cache then
-            //qDebug() << Q_FUNC_INFO << "notInCache -- filelocationhash doesn't contain criteria val";
-            notInCache( sendingObj, criteria, requestData );
-            return;
-        }
+    QSqlQuery query( m_db );
+    query.prepare( "SELECT expires, data FROM infocache WHERE type = ? AND hash = ?" );
+    query.addBindValue( (int)requestData.type );
+    query.addBindValue( criteriaHashVal );
+    if ( !query.exec() || !query.next() )
+    {
+        //qDebug() << Q_FUNC_INFO << "notInCache -- no such entry";
+        notInCache( sendingObj, criteria, requestData );
+        return;
     }
 
-    QFileInfo file( fileLocationHash[ criteriaHashVal ] );
-    qlonglong currMaxAge = file.suffix().toLongLong();
-
+    const qlonglong currMaxAge = query.value( 0 ).toLongLong();
     if ( currMaxAge < QDateTime::currentMSecsSinceEpoch() )
     {
-        if ( !QFile::remove( file.canonicalFilePath() ) )
-            tLog() << "Failed to remove stale cache file" << file.canonicalFilePath();
-        else
-            qDebug() << "Removed stale cache file" << file.canonicalFilePath();
-
-        fileLocationHash.remove( criteriaHashVal );
-        m_fileLocationCache[ requestData.type ] = fileLocationHash;
+        query.finish();
+        remove( requestData.type, criteriaHashVal );
         m_dataCache.remove( criteriaHashValWithType );
 
-        qDebug() << Q_FUNC_INFO << "notInCache -- file was stale";
+        qDebug() << Q_FUNC_INFO << "notInCache -- entry was stale";
         notInCache( sendingObj, criteria, requestData );
         return;
     }
-    else if ( newMaxAge > 0 )
-    {
-        const QString newFilePath = QString( file.dir().canonicalPath() + '/' + criteriaHashVal + '.' + QString::number( QDateTime::currentMSecsSinceEpoch() + newMaxAge ) );
 
-        if ( !QFile::rename( file.canonicalFilePath(), newFilePath ) )
-        {
-            qDebug() << Q_FUNC_INFO << "notInCache -- failed to move old cache file to new location";
-            notInCache( sendingObj, criteria, requestData );
-            return;
-        }
-
-        fileLocationHash[ criteriaHashVal ] = newFilePath;
-        m_fileLocationCache[ requestData.type ] = fileLocationHash;
+    QVariant output;
+    if ( m_dataCache.contains( criteriaHashValWithType ) )
+    {
+        output = *( m_dataCache[ criteriaHashValWithType ] );
     }
-
-    if ( !m_dataCache.contains( criteriaHashValWithType ) )
+    else
     {
-        QSettings cachedSettings( fileLocationHash[ criteriaHashVal ], QSettings::IniFormat );
-        QVariant output = cachedSettings.value( "data" );
+        QDataStream stream( query.value( 1 ).toByteArray() );
+        stream >> output;
         m_dataCache.insert( criteriaHashValWithType, new QVariant( output ) );
-
-        emit info( requestData, output );
     }
-    else
+    query.finish();
+
+    if ( newMaxAge > 0 )
     {
-        emit info( requestData, QVariant( *( m_dataCache[ criteriaHashValWithType ] ) ) );
+        QSqlQuery update( m_db );
+        update.prepare( "UPDATE infocache SET expires = ? WHERE type = ? AND hash = ?" );
+        update.addBindValue( QDateTime::currentMSecsSinceEpoch() + newMaxAge );
+        update.addBindValue( (int)requestData.type );
+        update.addBindValue( criteriaHashVal );
+        update.exec();
     }
+
+    emit info( requestData, output );
 }
 
 
@@ -197,50 +213,46 @@ InfoSystemCache::updateCacheSlot( Tomahawk::InfoSystem::InfoStringHash criteria,
 {
     const QString criteriaHashVal = criteriaMd5( criteria );
     const QString criteriaHashValWithType = criteriaMd5( criteria, type );
-    const QString cacheDir = m_cacheBaseDir + QString::number( (int)type );
-    const QString settingsFilePath( cacheDir + '/' + criteriaHashVal + '.' + QString::number( QDateTime::currentMSecsSinceEpoch() + maxAge ) );
-
-    QHash< QString, QString > fileLocationHash = m_fileLocationCache[ type ];
-    if ( fileLocationHash.contains( criteriaHashVal ) )
-    {
-        if ( !QFile::rename( fileLocationHash[ criteriaHashVal ], settingsFilePath ) )
-        {
-            tLog() << "Failed to move old cache file to new location!";
-            return;
-        }
-        fileLocationHash[ criteriaHashVal ] = settingsFilePath;
-        m_fileLocationCache[ type ] = fileLocationHash;
 
-        QSettings cachedSettings( fileLocationHash[ criteriaHashVal ], QSettings::IniFormat );
-        cachedSettings.setValue( "data", output );
+    if ( !store( type, criteriaHashVal, QDateTime::currentMSecsSinceEpoch() + maxAge, output ) )
+        return;
 
-        m_dataCache.insert( criteriaHashValWithType, new QVariant( output ) );
+    m_dataCache.insert( criteriaHashValWithType, new QVariant( output ) );
+}
 
-        return;
-    }
 
-    QDir dir( cacheDir );
-    if( !dir.exists( cacheDir ) )
+bool
+InfoSystemCache::store( Tomahawk::InfoSystem::InfoType type, const QString& hash, qlonglong expires, const QVariant& output )
+{
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream << output;
+
+    QSqlQuery query( m_db );
+    query.prepare( "INSERT OR REPLACE INTO infocache( type, hash, expires, data ) VALUES( ?, ?, ?, ? )" );
+    query.addBindValue( (int)type );
+    query.addBindValue( hash );
+    query.addBindValue( expires );
+    query.addBindValue( data );
+    if ( !query.exec() )
     {
-        qDebug() << "Creating cache directory" << cacheDir;
-        if( !dir.mkpath( cacheDir ) )
-        {
-            tLog() << "Failed to create cache dir! Bailing...";
-            return;
-        }
+        tLog() << "Failed to store infosystem cache entry" << query.lastError().text();
+        return false;
     }
 
-    QSettings cachedSettings( settingsFilePath, QSettings::IniFormat );
-    QStringList keys = criteria.keys();
-    cachedSettings.beginGroup( "criteria" );
-    for( int i = 0; i < criteria.size(); i++ )
-        cachedSettings.setValue( keys.at( i ), criteria[keys.at( i )] );
-    cachedSettings.endGroup();
-    cachedSettings.setValue( "data", output );
-
-    fileLocationHash[criteriaHashVal] = settingsFilePath;
-    m_fileLocationCache[type] = fileLocationHash;
-    m_dataCache.insert( criteriaHashValWithType, new QVariant( output ) );
+    return true;
+}
+
+
+void
+InfoSystemCache::remove( Tomahawk::InfoSystem::InfoType type, const QString& hash )
+{
+    QSqlQuery query( m_db );
+    query.prepare( "DELETE FROM infocache WHERE type = ? AND hash = ?" );
+    query.addBindValue( (int)type );
+    query.addBindValue( hash );
+    if ( !query.exec() )
+        tLog() << "Failed to remove stale cache entry" << query.lastError().text();
 }
 
 
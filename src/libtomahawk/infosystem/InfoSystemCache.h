@@ -23,6 +23,7 @@
 #include <QCache>
 #include <QDateTime>
 #include <QObject>
+#include <QSqlDatabase>
 #include <QtDebug>
 #include <QTimer>
 
@@ -64,8 +65,14 @@ private:
     void notInCache( QObject *receiver, Tomahawk::InfoSystem::InfoStringHash criteria, Tomahawk::InfoSystem::InfoRequestData requestData );
     const QString criteriaMd5( const Tomahawk::InfoSystem::InfoStringHash &criteria, Tomahawk::InfoSystem::InfoType type = Tomahawk::InfoSystem::InfoNoInfo ) const;
 
+    bool store( Tomahawk::InfoSystem::InfoType type, const QString& hash, qlonglong expires, const QVariant& output );
+    void remove( Tomahawk::InfoSystem::InfoType type, const QString& hash );
+    void migrateCacheDirectory();
+
+    // Used to be the location of the one-file-per-entry cache, only kept around for migrating it
     QString m_cacheBaseDir;
-    QHash< InfoType, QHash< QString, QString > > m_fileLocationCache;
+    // Entries are indexed by ( type, hash ), with a second index on their expiry time for pruning
+    QSqlDatabase m_db;
     QTimer m_pruneTimer;
     QCache< QString, QVariant > m_dataCache;
 };
@@ -26,11 +26,11 @@
 #include "config.h"
 #include "GlobalActionManager.h"
 #include "InfoSystemCache.h"
+#include "InfoRequestScheduler.h"
 #include "PlaylistEntry.h"
 #include "utils/TomahawkUtils.h"
 #include "utils/Logger.h"
 #include "utils/PluginLoader.h"
-#include "utils/Closure.h"
 #include "Source.h"
 
 #include <QCoreApplication>
@@ -43,16 +43,91 @@ namespace Tomahawk
 namespace InfoSystem
 {
 
+namespace
+{
+    // Appends an unambiguous representation of v to key. Returns false for
+    // types we can't compare, requests containing them are never shared.
+    bool
+    appendVariantKey( const QVariant& v, QString& key )
+    {
+        if ( v.userType() == qMetaTypeId< Tomahawk::InfoSystem::InfoStringHash >() )
+        {
+            const InfoStringHash hash = v.value< Tomahawk::InfoSystem::InfoStringHash >();
+            QStringList keys = hash.keys();
+            keys.sort();
+
+            key += QString( "h%1:" ).arg( keys.count() );
+            foreach ( const QString& k, keys )
+                key += QString( "%1:%2%3:%4" ).arg( k.length() ).arg( k ).arg( hash.value( k ).length() ).arg( hash.value( k ) );
+            return true;
+        }
+
+        switch ( v.type() )
+        {
+            case QVariant::Invalid:
+                key += "n";
+                return true;
+
+            case QVariant::Bool:
+            case QVariant::Int:
+            case QVariant::UInt:
+            case QVariant::LongLong:
+            case QVariant::ULongLong:
+            case QVariant::Double:
+            case QVariant::String:
+            {
+                const QString str = v.toString();
+                key += QString( "%1/%2:%3" ).arg( (int)v.type() ).arg( str.length() ).arg( str );
+                return true;
+            }
+
+            case QVariant::StringList:
+            case QVariant::List:
+            {
+                const QVariantList list = v.toList();
+                key += QString( "l%1:" ).arg( list.count() );
+                foreach ( const QVariant& item, list )
+                {
+                    if ( !appendVariantKey( item, key ) )
+                        return false;
+                }
+                return true;
+            }
+
+            case QVariant::Map:
+            {
+                const QVariantMap map = v.toMap();
+                key += QString( "m%1:" ).arg( map.count() );
+                for ( QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it )
+                {
+                    key += QString( "%1:%2" ).arg( it.key().length() ).arg( it.key() );
+                    if ( !appendVariantKey( it.value(), key ) )
+                        return false;
+                }
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+}
+
+
 InfoSystemWorker::InfoSystemWorker()
     : QObject()
     , m_cache( 0 )
+    , m_timeouts( QDateTime::currentMSecsSinceEpoch() )
 {
     tDebug() << Q_FUNC_INFO;
 
-    m_checkTimeoutsTimer.setInterval( 1000 );
+    // Only runs while there are timeouts pending
+    m_checkTimeoutsTimer.setInterval( m_timeouts.resolution() );
     m_checkTimeoutsTimer.setSingleShot( false );
     connect( &m_checkTimeoutsTimer, SIGNAL( timeout() ), SLOT( checkTimeoutsTimerFired() ) );
-    m_checkTimeoutsTimer.start();
+
+    // Created here so it lives in our thread, next to the plugins using it
+    new InfoRequestScheduler( this );
 }
 
 
@@ -136,6 +211,17 @@ InfoSystemWorker::addInfoPlugin( Tomahawk::InfoSystem::InfoPluginPtr plugin )
 
     emit updatedSupportedGetTypes( QSet< InfoType >::fromList( m_infoGetMap.keys() ) );
     emit updatedSupportedPushTypes( QSet< InfoType >::fromList( m_infoPushMap.keys() ) );
+
+    // Dispatch everything that was waiting for a plugin like this one. Requests
+    // for types it doesn't support simply go back to the queue.
+    if ( !m_pendingRequests.isEmpty() )
+    {
+        const QList< InfoRequestData > pending = m_pendingRequests;
+        m_pendingRequests.clear();
+
+        foreach ( const InfoRequestData& requestData, pending )
+            getInfo( requestData );
+    }
 }
 
 
@@ -226,12 +312,8 @@ InfoSystemWorker::getInfo( Tomahawk::InfoSystem::InfoRequestData requestData )
     QList< InfoPluginPtr > providers = determineOrderedMatches( requestData.type );
     if ( providers.isEmpty() )
     {
-        // We're not ready yet, retry this request in a bit
-        QTimer* timer = new QTimer();
-        timer->setInterval( 500 );
-        timer->setSingleShot( true );
-        NewClosure( timer, SIGNAL( timeout() ), this, SLOT( getInfo( Tomahawk::InfoSystem::InfoRequestData ) ), requestData );
-        timer->start();
+        // We're not ready yet, addInfoPlugin will dispatch this request once we are
+        m_pendingRequests << requestData;
 
 /*        emit info( requestData, QVariant() );
         checkFinished( requestData );*/
@@ -241,6 +323,9 @@ InfoSystemWorker::getInfo( Tomahawk::InfoSystem::InfoRequestData requestData )
     if ( !requestData.allSources )
         providers = QList< InfoPluginPtr >( providers.mid( 0, 1 ) );
 
+    // Identical requests for a single provider share one plugin call
+    const QString key = requestData.allSources ? QString() : requestKey( requestData );
+
     bool foundOne = false;
     foreach ( InfoPluginPtr ptr, providers )
     {
@@ -264,18 +349,32 @@ InfoSystemWorker::getInfo( Tomahawk::InfoSystem::InfoRequestData requestData )
         if ( requestData.timeoutMillis != 0 )
         {
             qint64 currMs = QDateTime::currentMSecsSinceEpoch();
-            m_timeRequestMapper.insert( currMs + requestData.timeoutMillis, requestId );
+            m_timeouts.schedule( requestId, currMs + requestData.timeoutMillis, currMs );
+            if ( !m_checkTimeoutsTimer.isActive() )
+                m_checkTimeoutsTimer.start();
         }
     //    qDebug() << "Assigning request with requestId" << requestId << "and type" << requestData.type;
         m_dataTracker[ requestData.caller ][ requestData.type ] = m_dataTracker[ requestData.caller ][ requestData.type ] + 1;
     //    qDebug() << "Current count in dataTracker for target" << requestData.caller << "and type" << requestData.type << "is" << m_dataTracker[ requestData.caller ][ requestData.type ];
 
-        InfoRequestData* data = new InfoRequestData;
-        data->caller = requestData.caller;
-        data->type = requestData.type;
-        data->input = requestData.input;
-        data->customData = requestData.customData;
-        m_savedRequestMap[ requestId ] = data;
+        m_savedRequestMap[ requestId ] = new InfoRequestData( requestData );
+
+        if ( !key.isEmpty() )
+        {
+            QHash< QString, quint64 >::const_iterator it = m_inFlight.constFind( key );
+            if ( it != m_inFlight.constEnd() )
+            {
+                // tDebug() << "Joining plugin call" << it.value() << "for request" << requestId;
+                m_callWaiters[ it.value() ] << requestId;
+                m_waitingFor[ requestId ] = it.value();
+                continue;
+            }
+
+            m_inFlight[ key ] = requestId;
+            m_callKeys[ requestId ] = key;
+            m_callWaiters[ requestId ] << requestId;
+            m_waitingFor[ requestId ] = requestId;
+        }
 
         QMetaObject::invokeMethod( ptr.data(), "getInfo", Qt::QueuedConnection, Q_ARG( Tomahawk::InfoSystem::InfoRequestData, requestData ) );
     }
@@ -384,6 +483,36 @@ InfoSystemWorker::infoSlot( Tomahawk::InfoSystem::InfoRequestData requestData, Q
 {
 //    qDebug() << Q_FUNC_INFO << "with requestId" << requestId;
 
+    const quint64 callId = requestData.internalId;
+    if ( m_callWaiters.contains( callId ) )
+    {
+        // Hand the answer to everyone who asked the same question in the meantime
+        const QList< quint64 > waiters = m_callWaiters.take( callId );
+        m_inFlight.remove( m_callKeys.take( callId ) );
+
+        foreach ( quint64 requestId, waiters )
+        {
+            m_waitingFor.remove( requestId );
+            if ( requestId == callId )
+            {
+                satisfy( requestData, output );
+            }
+            else if ( m_savedRequestMap.contains( requestId ) )
+            {
+                satisfy( *m_savedRequestMap.value( requestId ), output );
+            }
+        }
+
+        return;
+    }
+
+    satisfy( requestData, output );
+}
+
+
+void
+InfoSystemWorker::satisfy( const Tomahawk::InfoSystem::InfoRequestData& requestData, const QVariant& output )
+{
     quint64 requestId = requestData.internalId;
 
     if ( m_dataTracker[ requestData.caller ][ requestData.type ] == 0 )
@@ -397,14 +526,48 @@ InfoSystemWorker::infoSlot( Tomahawk::InfoSystem::InfoRequestData requestData, Q
         return;
     }
 
+    // requestData may point into m_savedRequestMap, don't free it before we're done
+    InfoRequestData* saved = m_savedRequestMap.take( requestId );
+
     m_requestSatisfiedMap[ requestId ] = true;
     emit info( requestData, output );
 
     m_dataTracker[ requestData.caller ][ requestData.type ] = m_dataTracker[ requestData.caller ][ requestData.type ] - 1;
 //    qDebug() << "Current count in dataTracker for target" << requestData.caller << "and type" << requestData.type << "is" << m_dataTracker[ requestData.caller ][ requestData.type ];
-    delete m_savedRequestMap[ requestId ];
-    m_savedRequestMap.remove( requestId );
     checkFinished( requestData );
+    delete saved;
+}
+
+
+quint64
+InfoSystemWorker::leaveCall( quint64 requestId )
+{
+    if ( !m_waitingFor.contains( requestId ) )
+        return requestId;
+
+    const quint64 callId = m_waitingFor.take( requestId );
+    QList< quint64 >& waiters = m_callWaiters[ callId ];
+    waiters.removeOne( requestId );
+
+    if ( waiters.isEmpty() )
+    {
+        m_callWaiters.remove( callId );
+        m_inFlight.remove( m_callKeys.take( callId ) );
+        return callId;
+    }
+
+    return 0;
+}
+
+
+QString
+InfoSystemWorker::requestKey( const Tomahawk::InfoSystem::InfoRequestData& requestData )
+{
+    QString key = QString::number( requestData.type ) + ":";
+    if ( !appendVariantKey( requestData.input, key ) || !appendVariantKey( requestData.customData, key ) )
+        return QString();
+
+    return key;
 }
 
 
@@ -427,53 +590,42 @@ InfoSystemWorker::checkFinished( const Tomahawk::InfoSystem::InfoRequestData &re
 void
 InfoSystemWorker::checkTimeoutsTimerFired()
 {
-    qint64 currTime = QDateTime::currentMSecsSinceEpoch();
-    Q_FOREACH( qint64 time, m_timeRequestMapper.keys() )
+    const QList< quint64 > expired = m_timeouts.advance( QDateTime::currentMSecsSinceEpoch() );
+    foreach ( quint64 requestId, expired )
     {
-        Q_FOREACH( quint64 requestId, m_timeRequestMapper.values( time ) )
+        if ( m_requestSatisfiedMap.value( requestId, true ) || !m_savedRequestMap.contains( requestId ) )
         {
-            if ( time < currTime )
-            {
-                if ( m_requestSatisfiedMap[ requestId ] )
-                {
-//                    qDebug() << Q_FUNC_INFO << "Removing mapping of" << requestId << "which expired at time" << time << "and was already satisfied";
-                    m_timeRequestMapper.remove( time, requestId );
-                    if ( !m_timeRequestMapper.count( time ) )
-                        m_timeRequestMapper.remove( time );
-                    continue;
-                }
+//            qDebug() << Q_FUNC_INFO << "Ignoring timeout of" << requestId << "which was already satisfied";
+            continue;
+        }
 
-                //doh, timed out
-//                qDebug() << Q_FUNC_INFO << "Doh, timed out for requestId" << requestId;
-                InfoRequestData *savedData = m_savedRequestMap[ requestId ];
+        //doh, timed out
+//        qDebug() << Q_FUNC_INFO << "Doh, timed out for requestId" << requestId;
+        InfoRequestData *savedData = m_savedRequestMap.take( requestId );
 
-                InfoRequestData returnData;
-                returnData.caller = savedData->caller;
-                returnData.type = savedData->type;
-                returnData.input = savedData->input;
-                returnData.customData = savedData->customData;
-                emit info( returnData, QVariant() );
+        // Nobody waits for the plugin's answer anymore, stop its network requests
+        const quint64 abandonedCall = leaveCall( requestId );
+        if ( abandonedCall && InfoRequestScheduler::instance() )
+            InfoRequestScheduler::instance()->cancel( abandonedCall );
 
-                delete savedData;
-                m_savedRequestMap.remove( requestId );
+        InfoRequestData returnData;
+        returnData.caller = savedData->caller;
+        returnData.type = savedData->type;
+        returnData.input = savedData->input;
+        returnData.customData = savedData->customData;
+        emit info( returnData, QVariant() );
 
-                m_dataTracker[ returnData.caller ][ returnData.type ] = m_dataTracker[ returnData.caller ][ returnData.type ] - 1;
-//                qDebug() << "Current count in dataTracker for target" << returnData.caller << "is" << m_dataTracker[ returnData.caller ][ returnData.type ];
+        delete savedData;
 
-                m_requestSatisfiedMap[ requestId ] = true;
-                m_timeRequestMapper.remove( time, requestId );
-                if ( !m_timeRequestMapper.count( time ) )
-                    m_timeRequestMapper.remove( time );
+        m_dataTracker[ returnData.caller ][ returnData.type ] = m_dataTracker[ returnData.caller ][ returnData.type ] - 1;
+//        qDebug() << "Current count in dataTracker for target" << returnData.caller << "is" << m_dataTracker[ returnData.caller ][ returnData.type ];
 
-                checkFinished( returnData );
-            }
-            else
-            {
-                //we've caught up, the remaining requets still have time to work
-                return;
-            }
-        }
+        m_requestSatisfiedMap[ requestId ] = true;
+        checkFinished( returnData );
     }
+
+    if ( m_timeouts.isEmpty() )
+        m_checkTimeoutsTimer.stop();
 }
 
 
@@ -21,6 +21,7 @@
 #define TOMAHAWK_INFOSYSTEMWORKER_H
 
 #include "infosystem/InfoSystem.h"
+#include "utils/TimerWheel.h"
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtCore/QObject>
@@ -83,11 +84,34 @@ private:
     void checkFinished( const Tomahawk::InfoSystem::InfoRequestData &target );
     QList< InfoPluginPtr > determineOrderedMatches( const InfoType type ) const;
 
+    void satisfy( const Tomahawk::InfoSystem::InfoRequestData& requestData, const QVariant& output );
+
+    /**
+     * Stops requestId from waiting on a shared plugin call. Once nobody waits
+     * for the call anymore, new identical requests get their own call again.
+     * Returns the id of the plugin call nobody waits for anymore, or 0.
+     */
+    quint64 leaveCall( quint64 requestId );
+
+    /**
+     * Returns the key identical requests share, or an empty string if the
+     * request can't be compared with others.
+     */
+    static QString requestKey( const Tomahawk::InfoSystem::InfoRequestData& requestData );
+
     QHash< QString, QHash< InfoType, int > > m_dataTracker;
-    QMultiMap< qint64, quint64 > m_timeRequestMapper;
     QHash< uint, bool > m_requestSatisfiedMap;
     QHash< uint, InfoRequestData* > m_savedRequestMap;
 
+    // Requests waiting for a plugin supporting their type
+    QList< InfoRequestData > m_pendingRequests;
+
+    // Plugin calls in flight: request key -> id the plugin was called with -> ids of all requests waiting for it
+    QHash< QString, quint64 > m_inFlight;
+    QHash< quint64, QString > m_callKeys;
+    QHash< quint64, QList< quint64 > > m_callWaiters;
+    QHash< quint64, quint64 > m_waitingFor;
+
     // NOTE Cache object lives in a different thread, do not call methods on it directly
     InfoSystemCache* m_cache;
 
@@ -98,6 +122,7 @@ private:
     QMap< InfoType, QList< InfoPluginPtr > > m_infoPushMap;
 
     QTimer m_checkTimeoutsTimer;
+    TimerWheel m_timeouts;
 
     quint64 m_shortLinksWaiting;
 };
@@ -34,7 +34,7 @@
 #include <QTime>
 #include <QThread>
 
-#define PROTOVER "4" // must match remote peer, or we can't talk.
+#define PROTOVER "5" // must match remote peer, or we can't talk.
 
 
 Connection::Connection( Servent* parent )
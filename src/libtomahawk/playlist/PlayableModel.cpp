@@ -853,7 +853,8 @@ PlayableModel::ensureResolved()
             ql << query;
     }
 
-    Pipeline::instance()->resolve( ql );
+    // Views bump whatever is on screen to the front of the queue
+    Pipeline::instance()->resolve( ql, false );
 }
 
 
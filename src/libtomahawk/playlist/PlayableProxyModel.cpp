@@ -25,12 +25,15 @@
 #include "Album.h"
 #include "PlayableItem.h"
 #include "PlayableProxyModelPlaylistInterface.h"
+#include "Pipeline.h"
 #include "Query.h"
 #include "Result.h"
 #include "Source.h"
 
 #include <QTreeView>
 
+#define VISIBLE_LOOKAHEAD 10
+
 PlayableProxyModel::PlayableProxyModel( QObject* parent )
     : QSortFilterProxyModel( parent )
     , m_model( 0 )
@@ -123,6 +126,11 @@ PlayableProxyModel::setSourcePlayableModel( PlayableModel* sourceModel )
         disconnect( m_model, SIGNAL( currentIndexChanged( QModelIndex, QModelIndex ) ), this, SLOT( onCurrentIndexChanged( QModelIndex, QModelIndex ) ) );
         disconnect( m_model, SIGNAL( expandRequest( QPersistentModelIndex ) ), this, SLOT( expandRequested( QPersistentModelIndex ) ) );
         disconnect( m_model, SIGNAL( selectRequest( QPersistentModelIndex ) ), this, SLOT( selectRequested( QPersistentModelIndex ) ) );
+        disconnect( m_model, SIGNAL( rowsInserted( QModelIndex, int, int ) ), this, SLOT( onSourceRowsInserted( QModelIndex, int, int ) ) );
+        disconnect( m_model, SIGNAL( rowsRemoved( QModelIndex, int, int ) ), this, SLOT( onSourceRowsRemoved( QModelIndex, int, int ) ) );
+        disconnect( m_model, SIGNAL( dataChanged( QModelIndex, QModelIndex ) ), this, SLOT( onSourceDataChanged( QModelIndex, QModelIndex ) ) );
+        disconnect( m_model, SIGNAL( modelReset() ), this, SLOT( onSourceModelReset() ) );
+        disconnect( m_model, SIGNAL( layoutChanged() ), this, SLOT( onSourceModelReset() ) );
     }
 
     m_model = sourceModel;
@@ -136,8 +144,17 @@ PlayableProxyModel::setSourcePlayableModel( PlayableModel* sourceModel )
         connect( m_model, SIGNAL( currentIndexChanged( QModelIndex, QModelIndex ) ), SLOT( onCurrentIndexChanged( QModelIndex, QModelIndex ) ) );
         connect( m_model, SIGNAL( expandRequest( QPersistentModelIndex ) ), SLOT( expandRequested( QPersistentModelIndex ) ) );
         connect( m_model, SIGNAL( selectRequest( QPersistentModelIndex ) ), SLOT( selectRequested( QPersistentModelIndex ) ) );
+
+        // These have to be connected before QSortFilterProxyModel connects itself, so the filter cache is up to date when it filters
+        connect( m_model, SIGNAL( rowsInserted( QModelIndex, int, int ) ), SLOT( onSourceRowsInserted( QModelIndex, int, int ) ) );
+        connect( m_model, SIGNAL( rowsRemoved( QModelIndex, int, int ) ), SLOT( onSourceRowsRemoved( QModelIndex, int, int ) ) );
+        connect( m_model, SIGNAL( dataChanged( QModelIndex, QModelIndex ) ), SLOT( onSourceDataChanged( QModelIndex, QModelIndex ) ) );
+        connect( m_model, SIGNAL( modelReset() ), SLOT( onSourceModelReset() ) );
+        connect( m_model, SIGNAL( layoutChanged() ), SLOT( onSourceModelReset() ) );
     }
 
+    clearFilterCache();
+
     QSortFilterProxyModel::setSourceModel( m_model );
 }
 
@@ -145,62 +162,179 @@ PlayableProxyModel::setSourcePlayableModel( PlayableModel* sourceModel )
 bool
 PlayableProxyModel::filterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const
 {
-    bool dupeFilter = true;
-    bool visibilityFilter = true;
+    if ( !m_hideDupeItems && m_maxVisibleItems <= 0 )
+        return nameFilterAcceptsRow( sourceRow, sourceParent );
 
-    if ( m_hideDupeItems )
-        dupeFilter = dupeFilterAcceptsRow( sourceRow, sourceParent );
-    if ( m_maxVisibleItems > 0 )
-        visibilityFilter = visibilityFilterAcceptsRow( sourceRow, sourceParent );
+    const FilterState& state = filterState( sourceParent );
+    if ( sourceRow >= state.accepted.count() )
+        return false;
 
-    return ( dupeFilter && visibilityFilter && nameFilterAcceptsRow( sourceRow, sourceParent ) );
+    return state.accepted.at( sourceRow );
 }
 
 
-bool
-PlayableProxyModel::dupeFilterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const
+const PlayableProxyModel::FilterState&
+PlayableProxyModel::filterState( const QModelIndex& sourceParent ) const
 {
-    if ( !m_hideDupeItems )
-        return true;
+    updateFilterTerms();
 
-    PlayableItem* pi = itemFromIndex( sourceModel()->index( sourceRow, 0, sourceParent ) );
+    PlayableItem* parentItem = itemFromIndex( sourceParent );
+    QHash< PlayableItem*, FilterState >::iterator it = m_filterStates.find( parentItem );
+    if ( it == m_filterStates.end() || it->accepted.count() != sourceModel()->rowCount( sourceParent ) )
+    {
+        FilterState state;
+        appendToFilterState( state, sourceParent, 0, sourceModel()->rowCount( sourceParent ) - 1 );
+        it = m_filterStates.insert( parentItem, state );
+    }
+
+    return it.value();
+}
+
+
+void
+PlayableProxyModel::appendToFilterState( FilterState& state, const QModelIndex& sourceParent, int first, int last ) const
+{
+    // A row is a dupe if an earlier row with the same key passed the name filter.
+    // Earlier dupes hidden by the visibility limit don't matter, as the limit also hides every row after them.
+    for ( int i = first; i <= last; i++ )
+    {
+        bool accepted = nameFilterAcceptsRow( i, sourceParent );
+        state.nameAccepted << accepted;
+
+        if ( accepted && m_hideDupeItems )
+        {
+            const QString key = dupeKey( itemFromIndex( sourceModel()->index( i, 0, sourceParent ) ) );
+            if ( !key.isEmpty() )
+            {
+                if ( state.keys.contains( key ) )
+                    accepted = false;
+                else
+                    state.keys.insert( key );
+            }
+        }
+
+        state.accepted << ( accepted && ( m_maxVisibleItems <= 0 || state.visibleCount < m_maxVisibleItems ) );
+        if ( accepted )
+            state.visibleCount++;
+    }
+}
+
+
+QString
+PlayableProxyModel::dupeKey( PlayableItem* pi ) const
+{
     if ( !pi )
-        return false;
+        return QString();
 
-    for ( int i = 0; i < sourceRow; i++ )
+    if ( pi->query() )
     {
-        PlayableItem* di = itemFromIndex( sourceModel()->index( i, 0, sourceParent ) );
-        if ( !di )
-            continue;
+        const Tomahawk::track_ptr& t = pi->query()->queryTrack();
+        return QString( "q\t" ) + t->artist() + "\t" + t->album() + "\t" + t->track();
+    }
+    if ( pi->album() )
+        return QString( "al\t" ) + QString::number( (qulonglong)pi->album().data() );
+    if ( pi->artist() )
+        return QString( "ar\t" ) + pi->artist()->name();
+
+    return QString();
+}
 
-        bool b = ( pi->query() && pi->query()->equals( di->query() ) ) ||
-                 ( pi->album() && pi->album() == di->album() ) ||
-                 ( pi->artist() && pi->artist()->name() == di->artist()->name() );
 
-        if ( b && filterAcceptsRow( i, sourceParent ) )
-            return false;
+const QString&
+PlayableProxyModel::filterString( PlayableItem* pi ) const
+{
+    const Tomahawk::track_ptr& track = pi->query()->track();
+
+    // The track of a query changes once it gets resolved, so remember which one we normalized
+    QHash< PlayableItem*, FilterString >::iterator it = m_filterStrings.find( pi );
+    if ( it == m_filterStrings.end() || it->track != track )
+    {
+        FilterString fs;
+        fs.track = track;
+        fs.text = ( track->artist() + "\n" + track->album() + "\n" + track->track() ).toLower();
+        it = m_filterStrings.insert( pi, fs );
     }
 
-    return true;
+    return it->text;
 }
 
 
-bool
-PlayableProxyModel::visibilityFilterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const
+void
+PlayableProxyModel::updateFilterTerms() const
 {
-    if ( m_maxVisibleItems <= 0 )
-        return true;
+    // setFilterRegExp() isn't virtual, so we notice filter changes lazily
+    if ( filterRegExp().pattern() == m_filterPattern )
+        return;
+
+    m_filterPattern = filterRegExp().pattern();
+    m_filterTerms = m_filterPattern.toLower().split( " ", QString::SkipEmptyParts );
+    m_filterStates.clear();
+}
 
-    int items = 0;
-    for ( int i = 0; i < sourceRow; i++ )
+
+void
+PlayableProxyModel::clearFilterCache()
+{
+    m_filterStates.clear();
+    m_filterStrings.clear();
+}
+
+
+void
+PlayableProxyModel::onSourceRowsInserted( const QModelIndex& parent, int first, int last )
+{
+    updateFilterTerms();
+
+    QHash< PlayableItem*, FilterState >::iterator it = m_filterStates.find( itemFromIndex( parent ) );
+    if ( it == m_filterStates.end() )
+        return;
+
+    // Appended rows can't change the outcome for any earlier row
+    if ( first == it->accepted.count() )
+        appendToFilterState( it.value(), parent, first, last );
+    else
+        m_filterStates.erase( it );
+}
+
+
+void
+PlayableProxyModel::onSourceRowsRemoved( const QModelIndex& parent, int first, int last )
+{
+    Q_UNUSED( parent );
+    Q_UNUSED( first );
+    Q_UNUSED( last );
+
+    // Removed items may have been parents themselves and their pointers can get reused
+    clearFilterCache();
+}
+
+
+void
+PlayableProxyModel::onSourceDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    const QModelIndex parent = topLeft.parent();
+    updateFilterTerms();
+
+    QHash< PlayableItem*, FilterState >::iterator it = m_filterStates.find( itemFromIndex( parent ) );
+    if ( it == m_filterStates.end() )
+        return;
+
+    // Only start over if the change actually affects the name filter
+    for ( int i = topLeft.row(); i <= bottomRight.row() && i < it->nameAccepted.count(); i++ )
     {
-        if ( dupeFilterAcceptsRow( i, sourceParent ) && nameFilterAcceptsRow( i, sourceParent ) )
+        if ( nameFilterAcceptsRow( i, parent ) != it->nameAccepted.at( i ) )
         {
-            items++;
+            m_filterStates.erase( it );
+            return;
         }
     }
+}
+
 
-    return ( items < m_maxVisibleItems );
+void
+PlayableProxyModel::onSourceModelReset()
+{
+    clearFilterCache();
 }
 
 
@@ -231,16 +365,13 @@ PlayableProxyModel::nameFilterAcceptsRow( int sourceRow, const QModelIndex& sour
         if ( filterRegExp().isEmpty() )
             return true;
 
-        QStringList sl = filterRegExp().pattern().split( " ", QString::SkipEmptyParts );
-        foreach( QString s, sl )
+        updateFilterTerms();
+
+        const QString& text = filterString( pi );
+        foreach ( const QString& s, m_filterTerms )
         {
-            s = s.toLower();
-            if ( !pi->query()->track()->artist().toLower().contains( s ) &&
-                 !pi->query()->track()->album().toLower().contains( s ) &&
-                 !pi->query()->track()->track().toLower().contains( s ) )
-            {
+            if ( !text.contains( s ) )
                 return false;
-            }
         }
     }
 
@@ -332,6 +463,7 @@ void
 PlayableProxyModel::setShowOfflineResults( bool b )
 {
     m_showOfflineResults = b;
+    m_filterStates.clear();
     invalidateFilter();
 }
 
@@ -340,6 +472,7 @@ void
 PlayableProxyModel::setHideDupeItems( bool b )
 {
     m_hideDupeItems = b;
+    m_filterStates.clear();
     invalidateFilter();
 }
 
@@ -351,6 +484,7 @@ PlayableProxyModel::setMaxVisibleItems( int items )
         return;
 
     m_maxVisibleItems = items;
+    m_filterStates.clear();
     invalidateFilter();
 }
 
@@ -686,6 +820,41 @@ PlayableProxyModel::updateDetailedInfo( const QModelIndex& index )
 }
 
 
+void
+PlayableProxyModel::setVisibleRange( int first, int last )
+{
+    const int margin = qMax( VISIBLE_LOOKAHEAD, last - first + 1 );
+    first = qMax( 0, first - margin );
+    last = qMin( rowCount( QModelIndex() ) - 1, last + margin );
+
+    QList< Tomahawk::query_ptr > visible;
+    for ( int i = first; i <= last; i++ )
+    {
+        PlayableItem* item = itemFromIndex( mapToSource( index( i, 0 ) ) );
+        if ( !item || !item->query() || item->query()->resolvingFinished() )
+            continue;
+
+        visible << item->query();
+    }
+
+    QList< Tomahawk::query_ptr > hidden;
+    foreach ( const Tomahawk::query_ptr& query, m_visibleQueries )
+    {
+        if ( !query->resolvingFinished() && !visible.contains( query ) )
+            hidden << query;
+    }
+    m_visibleQueries = visible;
+
+    if ( !hidden.isEmpty() )
+    {
+        Tomahawk::Pipeline::instance()->cancel( hidden );
+        Tomahawk::Pipeline::instance()->resolve( hidden, false );
+    }
+    if ( !visible.isEmpty() )
+        Tomahawk::Pipeline::instance()->resolve( visible, true );
+}
+
+
 void
 PlayableProxyModel::setFilter( const QString& pattern )
 {
@@ -21,6 +21,8 @@
 #define TRACKPROXYMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <QSet>
+#include <QVector>
 
 #include "PlaylistInterface.h"
 #include "playlist/PlayableModel.h"
@@ -84,6 +86,13 @@ public:
     virtual void setFilter( const QString& pattern );
     virtual void updateDetailedInfo( const QModelIndex& index );
 
+    /**
+     * Tells the model which rows are currently on screen. Their queries (plus
+     * a look-ahead margin) get resolved first, queries that scrolled out of
+     * view are moved back to the end of the Pipeline's queue.
+     */
+    virtual void setVisibleRange( int first, int last );
+
 signals:
     void filterChanged( const QString& filter );
 
@@ -116,10 +125,39 @@ private slots:
     void selectRequested( const QPersistentModelIndex& index );
     void onCurrentIndexChanged( const QModelIndex& newIndex, const QModelIndex& oldIndex );
 
+    void onSourceRowsInserted( const QModelIndex& parent, int first, int last );
+    void onSourceRowsRemoved( const QModelIndex& parent, int first, int last );
+    void onSourceDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+    void onSourceModelReset();
+
 private:
+    /**
+     * Outcome of the dupe & visibility filters for all children of one parent,
+     * computed in a single pass over its rows.
+     */
+    struct FilterState
+    {
+        FilterState() : visibleCount( 0 ) {}
+
+        QVector< bool > nameAccepted;
+        QVector< bool > accepted;
+        QSet< QString > keys;
+        int visibleCount;
+    };
+
+    struct FilterString
+    {
+        Tomahawk::track_ptr track;
+        QString text;
+    };
+
     bool nameFilterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const;
-    bool dupeFilterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const;
-    bool visibilityFilterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const;
+    const FilterState& filterState( const QModelIndex& sourceParent ) const;
+    void appendToFilterState( FilterState& state, const QModelIndex& sourceParent, int first, int last ) const;
+    QString dupeKey( PlayableItem* pi ) const;
+    const QString& filterString( PlayableItem* pi ) const;
+    void updateFilterTerms() const;
+    void clearFilterCache();
     bool lessThan( int column, const Tomahawk::query_ptr& left, const Tomahawk::query_ptr& right ) const;
 
     PlayableModel* m_model;
@@ -129,6 +167,13 @@ private:
     bool m_hideDupeItems;
     int m_maxVisibleItems;
 
+    QList< Tomahawk::query_ptr > m_visibleQueries;
+
+    mutable QHash< PlayableItem*, FilterState > m_filterStates;
+    mutable QHash< PlayableItem*, FilterString > m_filterStrings;
+    mutable QString m_filterPattern;
+    mutable QStringList m_filterTerms;
+
     QHash< PlayableItemStyle, QList<PlayableModel::Columns> > m_headerStyle;
     PlayableItemStyle m_style;
 };
@@ -202,10 +202,12 @@ PlaylistItemDelegate::paintShort( QPainter* painter, const QStyleOptionViewItem&
         painter->setPen( opt.palette.text().color() );
 
         QRect ir = r.adjusted( 4, 0, -option.rect.width() + option.rect.height() - 8 + r.left(), 0 );
-        pixmap = item->query()->track()->cover( ir.size() );
+        pixmap = track->cover( ir.size() );
 
         if ( pixmap.isNull() )
         {
+            // Repaint once the cover is fetched or scaled
+            connect( track.data(), SIGNAL( coverChanged() ), m_view->viewport(), SLOT( update() ), Qt::UniqueConnection );
             pixmap = TomahawkUtils::defaultPixmap( TomahawkUtils::DefaultTrackImage, TomahawkUtils::RoundedCorners, ir.size() );
         }
 
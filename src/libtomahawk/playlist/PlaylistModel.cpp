@@ -322,7 +322,7 @@ PlaylistModel::insertEntries( const QList< Tomahawk::plentry_ptr >& entries, int
     if ( !d->waitingForResolved.isEmpty() )
     {
         startLoading();
-        Pipeline::instance()->resolve( queries );
+        Pipeline::instance()->resolve( queries, false );
     }
     else
     {
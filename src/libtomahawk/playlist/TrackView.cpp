@@ -321,6 +321,8 @@ TrackView::onScrollTimeout()
     if ( !max )
         return;
 
+    m_proxyModel->setVisibleRange( qMax( 0, left.row() ), max );
+
     //FIXME
     for ( int i = left.row(); i <= max; i++ )
     {
@@ -48,8 +48,7 @@ DatabaseControl::DatabaseControl( const QString& sql, const QString& summary, co
 
 QString DatabaseControl::input() const
 {
-    // TODO
-    return QString();
+    return m_inputData;
 }
 
 QWidget* DatabaseControl::inputField()
@@ -74,8 +73,9 @@ QString DatabaseControl::matchString() const
 
 void DatabaseControl::setInput ( const QString& input )
 {
-    Q_UNUSED( input );
-    // TODO
+    m_inputData = input;
+
+    calculateSummary();
     updateWidgets();
 }
 
@@ -83,6 +83,7 @@ void DatabaseControl::setMatch ( const QString& match )
 {
     m_matchData = match;
 
+    calculateSummary();
     updateWidgets();
 }
 
@@ -95,6 +96,7 @@ void DatabaseControl::setSelectedType ( const QString& type )
             delete m_match.data();
 
         Tomahawk::DynamicControl::setSelectedType ( type );
+        calculateSummary();
         updateWidgets();
         updateData();
         //        qDebug() << "Setting new type, set data to:" << m_data.first << m_data.second;
@@ -131,6 +133,41 @@ void DatabaseControl::calculateSummary()
     if( !m_sqlSummary.isEmpty() )
         return;
 
+    // Matches as understood by DatabaseGenerator, see there
+    const QString type = selectedType();
+    if ( type == "Artist" )
+        m_summary = tr( "by %1" ).arg( m_inputData );
+    else if ( type == "Album" )
+        m_summary = tr( "from the album %1" ).arg( m_inputData );
+    else if ( type == "Title" )
+        m_summary = tr( "called %1" ).arg( m_inputData );
+    else if ( type == "Year" )
+    {
+        if ( m_matchData == ">=" )
+            m_summary = tr( "released in or after %1" ).arg( m_inputData );
+        else if ( m_matchData == "<=" )
+            m_summary = tr( "released in or before %1" ).arg( m_inputData );
+        else
+            m_summary = tr( "released in %1" ).arg( m_inputData );
+    }
+    else if ( type == "Play Count" )
+    {
+        if ( m_matchData == "<=" )
+            m_summary = tr( "played at most %n time(s)", "", m_inputData.toInt() );
+        else if ( m_matchData == "=" )
+            m_summary = tr( "played exactly %n time(s)", "", m_inputData.toInt() );
+        else
+            m_summary = tr( "played at least %n time(s)", "", m_inputData.toInt() );
+    }
+    else if ( type == "Recently Played" )
+    {
+        if ( m_matchData == "not played" )
+            m_summary = tr( "not played in the last %n day(s)", "", m_inputData.toInt() );
+        else
+            m_summary = tr( "played in the last %n day(s)", "", m_inputData.toInt() );
+    }
+    else
+        m_summary.clear();
 }
 
 QString
@@ -65,6 +65,7 @@ namespace Tomahawk
         QPointer< QWidget > m_input;
         QPointer< QWidget > m_match;
         QString m_matchData;
+        QString m_inputData;
         QString m_matchString;
         QString m_summary;
 
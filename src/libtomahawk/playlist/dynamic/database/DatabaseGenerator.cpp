@@ -19,6 +19,7 @@
 #include "DatabaseGenerator.h"
 
 #include "database/DatabaseCommand_GenericSelect.h"
+#include "database/DatabaseCommand_SampleTracks.h"
 #include "database/Database.h"
 #include "utils/Logger.h"
 
@@ -26,6 +27,13 @@
 #include "PlaylistEntry.h"
 #include "Source.h"
 
+#include <QDateTime>
+
+#include <climits>
+
+// Tracks a station draws at once, it only goes back to the database when they're used up
+#define REFILL_SIZE 25
+
 using namespace Tomahawk;
 
 
@@ -55,12 +63,14 @@ DatabaseFactory::createControl ( const QString& sql, DatabaseCommand_GenericSele
 QStringList
 DatabaseFactory::typeSelectors() const
 {
-    return QStringList() << "SQL" << "Artist" << "Album" << "Title";
+    return QStringList() << "SQL" << "Artist" << "Album" << "Title" << "Year" << "Play Count" << "Recently Played";
 }
 
 
 DatabaseGenerator::DatabaseGenerator ( QObject* parent )
     : GeneratorInterface ( parent )
+    , m_wanted( 0 )
+    , m_startedOver( false )
 {
     // defaults
     m_type = "database";
@@ -141,6 +151,78 @@ DatabaseGenerator::generate( int number )
         return;
     }
 
+    QStringList artists, albums;
+    TrackSampleIndex::Constraints c;
+    QString errorMsg;
+    if ( !constraints( artists, albums, c, errorMsg ) )
+    {
+        qWarning() << "Invalid controls:" << errorMsg;
+        emit error( "Failed to generate tracks", errorMsg );
+        return;
+    }
+
+    DatabaseCommand_SampleTracks* cmd = new DatabaseCommand_SampleTracks( artists, albums, c, number < 0 ? INT_MAX : number );
+    connect( cmd, SIGNAL( tracks( QList<Tomahawk::query_ptr>, QList<uint> ) ), this, SLOT( tracksSampled( QList<Tomahawk::query_ptr>, QList<uint> ) ) );
+    Database::instance()->enqueue( Tomahawk::dbcmd_ptr( cmd ) );
+}
+
+
+bool
+DatabaseGenerator::constraints( QStringList& artists, QStringList& albums, TrackSampleIndex::Constraints& c, QString& errorMsg ) const
+{
+    const uint now = QDateTime::currentDateTimeUtc().toTime_t();
+
+    foreach ( const dyncontrol_ptr& ctrl, m_controls )
+    {
+        const QString type = ctrl->selectedType();
+        const QString match = ctrl->match();
+        const QString input = ctrl->input().trimmed();
+
+        bool ok = true;
+        const int value = input.toInt( &ok );
+
+        if ( type == "Artist" )
+            artists << input;
+        else if ( type == "Album" )
+            albums << input;
+        else if ( type == "Year" && ok && value > 0 )
+        {
+            if ( match != "<=" )
+                c.minYear = qMax( c.minYear, value );
+            if ( match != ">=" )
+                c.maxYear = c.maxYear > 0 ? qMin( c.maxYear, value ) : value;
+        }
+        else if ( type == "Play Count" && ok && value >= 0 )
+        {
+            if ( match != "<=" )
+                c.minPlays = qMax( c.minPlays, value );
+            if ( match == "<=" || match == "=" )
+                c.maxPlays = c.maxPlays >= 0 ? qMin( c.maxPlays, value ) : value;
+        }
+        else if ( type == "Recently Played" && ok && value > 0 )
+        {
+            const uint since = now - (uint)qMin( (quint64)now, (quint64)value * 86400 );
+            if ( match == "not played" )
+                c.notPlayedSince = c.notPlayedSince > 0 ? qMin( c.notPlayedSince, since ) : since;
+            else
+                c.playedSince = qMax( c.playedSince, since );
+        }
+        else
+        {
+            errorMsg = QString( "Unsupported filter: %1 %2 %3" ).arg( type ).arg( match ).arg( input );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void
+DatabaseGenerator::tracksSampled( const QList< query_ptr >& tracks, const QList< uint >& trackIds )
+{
+    Q_UNUSED( trackIds );
+    emit generated( tracks );
 }
 
 
@@ -171,6 +253,78 @@ DatabaseGenerator::createControl ( const QString& sql, DatabaseCommand_GenericSe
 void
 DatabaseGenerator::fetchNext( int /* rating */ )
 {
+    if ( !m_buffer.isEmpty() )
+    {
+        emit nextTrackGenerated( m_buffer.takeFirst() );
+        return;
+    }
+
+    m_wanted++;
+    refill();
+}
+
+
+void
+DatabaseGenerator::refill()
+{
+    if ( !m_refillCmd.isNull() )
+        return;
+
+    QStringList artists, albums;
+    TrackSampleIndex::Constraints c;
+    QString errorMsg;
+    if ( !constraints( artists, albums, c, errorMsg ) )
+    {
+        qWarning() << "Invalid controls:" << errorMsg;
+        m_wanted = 0;
+        emit error( "Failed to generate tracks", errorMsg );
+        return;
+    }
+
+    // Leaving out what we already had is all it takes to continue where we left off
+    DatabaseCommand_SampleTracks* cmd = new DatabaseCommand_SampleTracks( artists, albums, c, qMax( REFILL_SIZE, m_wanted ), m_drawn );
+    connect( cmd, SIGNAL( tracks( QList<Tomahawk::query_ptr>, QList<uint> ) ), this, SLOT( stationTracksSampled( QList<Tomahawk::query_ptr>, QList<uint> ) ) );
+
+    m_refillCmd = dbcmd_ptr( cmd );
+    Database::instance()->enqueue( m_refillCmd );
+}
+
+
+void
+DatabaseGenerator::stationTracksSampled( const QList< query_ptr >& tracks, const QList< uint >& trackIds )
+{
+    // Drawn for the station before it got restarted
+    if ( m_refillCmd.isNull() || sender() != m_refillCmd.data() )
+        return;
+
+    m_refillCmd.clear();
+
+    if ( tracks.isEmpty() )
+    {
+        if ( !m_drawn.isEmpty() && !m_startedOver )
+        {
+            // Played everything that matches, start over
+            m_drawn.clear();
+            m_startedOver = true;
+            refill();
+            return;
+        }
+
+        if ( m_wanted > 0 )
+        {
+            m_wanted = 0;
+            emit error( "Failed to generate tracks", "No tracks in your collection match these filters" );
+        }
+        return;
+    }
+
+    m_startedOver = false;
+    foreach ( uint id, trackIds )
+        m_drawn << (int)id;
+    m_buffer << tracks;
+
+    for ( ; m_wanted > 0 && !m_buffer.isEmpty(); m_wanted-- )
+        emit nextTrackGenerated( m_buffer.takeFirst() );
 }
 
 
@@ -180,12 +334,28 @@ DatabaseGenerator::sentenceSummary()
     if( m_controls.count() && m_controls.first()->type() == "SQL" )
         return m_controls.first()->summary();
 
-    // TODO
-    return QString();
+    QStringList summaries;
+    foreach ( const dyncontrol_ptr& ctrl, m_controls )
+    {
+        if ( !ctrl->summary().isEmpty() )
+            summaries << ctrl->summary();
+    }
+
+    if ( summaries.isEmpty() )
+        return tr( "Random tracks from your collection." );
+
+    return tr( "Tracks %1." ).arg( summaries.join( tr( " and " ) ) );
 }
 
 
 void
 DatabaseGenerator::startOnDemand()
 {
+    m_refillCmd.clear();
+    m_buffer.clear();
+    m_drawn.clear();
+    m_wanted = 0;
+    m_startedOver = false;
+
+    fetchNext();
 }
@@ -25,8 +25,11 @@
 #include "playlist/dynamic/GeneratorFactory.h"
 #include "playlist/dynamic/DynamicControl.h"
 #include "database/DatabaseCommand_GenericSelect.h"
+#include "database/TrackSampleIndex.h"
 #include "DllMacro.h"
 
+#include <QSet>
+
 namespace Tomahawk
 {
 
@@ -47,6 +50,13 @@ namespace Tomahawk
     /**
      * Generator based on the database. Can filter the database based on some user-controllable options,
      *  or just be the front-facing part of any given SQL query to fake an interesting read-only playlist.
+     *
+     * Non-SQL controls are constraints on the tracks drawn at random from the collections:
+     *  - Artist, Album: input is the name, several of them match any
+     *  - Year, Play Count: input is a number, match is one of "=", ">=" or "<="
+     *  - Recently Played: input is a number of days, match is "played" or "not played"
+     *
+     * Stations draw tracks in batches and don't repeat one until they ran out of matching tracks.
      */
     class DatabaseGenerator : public GeneratorInterface
     {
@@ -68,11 +78,23 @@ namespace Tomahawk
 
     private slots:
         void tracksGenerated( const QList< Tomahawk::query_ptr >& tracks );
+        void tracksSampled( const QList< Tomahawk::query_ptr >& tracks, const QList< uint >& trackIds );
+        void stationTracksSampled( const QList< Tomahawk::query_ptr >& tracks, const QList< uint >& trackIds );
         void dynamicStarted();
         void dynamicFetched();
 
     private:
+        bool constraints( QStringList& artists, QStringList& albums, TrackSampleIndex::Constraints& constraints, QString& error ) const;
+        void refill();
+
         QPixmap m_logo;
+
+        // Station state
+        dbcmd_ptr m_refillCmd;
+        QList< Tomahawk::query_ptr > m_buffer;
+        QSet< int > m_drawn;
+        int m_wanted;
+        bool m_startedOver;
     };
 
 };
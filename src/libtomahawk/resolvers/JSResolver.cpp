@@ -500,46 +500,48 @@ JSResolver::error() const
 
 void
 JSResolver::resolve( const Tomahawk::query_ptr& query )
+{
+    resolve( QList< Tomahawk::query_ptr >() << query );
+}
+
+
+void
+JSResolver::resolve( const QList< Tomahawk::query_ptr >& queries )
 {
     Q_D( JSResolver );
 
     if ( QThread::currentThread() != thread() )
     {
-        QMetaObject::invokeMethod( this, "resolve", Qt::QueuedConnection, Q_ARG(Tomahawk::query_ptr, query) );
+        QMetaObject::invokeMethod( this, "resolve", Qt::QueuedConnection, Q_ARG(QList<Tomahawk::query_ptr>, queries) );
         return;
     }
 
-    QString eval;
-    if ( !query->isFullTextQuery() )
+    // Queries are handed over as plain objects, one script call covers the whole batch
+    QVariantList batch;
+    foreach ( const Tomahawk::query_ptr& query, queries )
     {
-        eval = QString( "Tomahawk.resolver.instance.resolve( '%1', '%2', '%3', '%4' );" )
-                  .arg( query->id().replace( "\\", "\\\\" ).replace( "'", "\\'" ) )
-                  .arg( query->queryTrack()->artist().replace( "\\", "\\\\" ).replace( "'", "\\'" ) )
-                  .arg( query->queryTrack()->album().replace( "\\", "\\\\" ).replace( "'", "\\'" ) )
-                  .arg( query->queryTrack()->track().replace( "\\", "\\\\" ).replace( "'", "\\'" ) );
-    }
-    else
-    {
-        eval = QString( "Tomahawk.resolver.instance.search( '%1', '%2' );" )
-                  .arg( query->id().replace( "\\", "\\\\" ).replace( "'", "\\'" ) )
-                  .arg( query->fullTextQuery().replace( "\\", "\\\\" ).replace( "'", "\\'" ) );
-    }
+        QVariantMap q;
+        q[ "qid" ] = query->id();
+        if ( !query->isFullTextQuery() )
+        {
+            q[ "artist" ] = query->queryTrack()->artist();
+            q[ "album" ] = query->queryTrack()->album();
+            q[ "track" ] = query->queryTrack()->track();
+        }
+        else
+        {
+            q[ "fullText" ] = query->fullTextQuery();
+        }
 
-    QVariantMap m = d->engine->mainFrame()->evaluateJavaScript( eval ).toMap();
-    if ( m.isEmpty() )
-    {
-        // if the resolver doesn't return anything, async api is used
-        return;
+        batch << q;
     }
 
-    qDebug() << "JavaScript Result:" << m;
-
-    const QString qid = query->id();
-    const QVariantList reslist = m.value( "results" ).toList();
-
-    QList< Tomahawk::result_ptr > results = parseResultVariantList( reslist );
+    d->resolverHelper->setQueryBatch( batch );
+    const QVariantList reslist = d->engine->mainFrame()->evaluateJavaScript( "Tomahawk.resolveBatch( Tomahawk.takeQueryBatch() );" ).toList();
 
-    Tomahawk::Pipeline::instance()->reportResults( qid, results );
+    // if the resolver doesn't return anything, async api is used
+    if ( !reslist.isEmpty() )
+        d->resolverHelper->addTrackResultsBatch( reslist );
 }
 
 
@@ -62,6 +62,7 @@ public:
 
 public slots:
     void resolve( const Tomahawk::query_ptr& query ) Q_DECL_OVERRIDE;
+    void resolve( const QList< Tomahawk::query_ptr >& queries ) Q_DECL_OVERRIDE;
     void stop() Q_DECL_OVERRIDE;
     void start() Q_DECL_OVERRIDE;
 
@@ -138,7 +138,39 @@ JSResolverHelper::addTrackResults( const QVariantMap& results )
 
     QString qid = results.value("qid").toString();
 
-    Tomahawk::Pipeline::instance()->reportResults( qid, tracks );
+    Tomahawk::Pipeline::instance()->reportResults( qid, m_resolver, tracks );
+}
+
+
+void
+JSResolverHelper::addTrackResultsBatch( const QVariantList& results )
+{
+    tDebug( LOGVERBOSE ) << "Resolver reporting results for" << results.count() << "queries";
+    foreach ( const QVariant& v, results )
+    {
+        const QVariantMap m = v.toMap();
+        const QString qid = m.value( "qid" ).toString();
+        if ( qid.isEmpty() )
+            continue;
+
+        Tomahawk::Pipeline::instance()->reportResults( qid, m_resolver, m_resolver->parseResultVariantList( m.value( "results" ).toList() ) );
+    }
+}
+
+
+void
+JSResolverHelper::setQueryBatch( const QVariantList& queries )
+{
+    m_queryBatch = queries;
+}
+
+
+QVariantList
+JSResolverHelper::takeQueryBatch()
+{
+    QVariantList queries = m_queryBatch;
+    m_queryBatch.clear();
+    return queries;
 }
 
 
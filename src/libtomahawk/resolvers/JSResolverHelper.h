@@ -56,6 +56,15 @@ public:
      */
     Q_INVOKABLE QString acountId();
 
+    /**
+     * Queries JSResolver wants resolved next, already marshalled into maps.
+     * Handed to Tomahawk.resolveBatch() through takeQueryBatch().
+     *
+     * INTERNAL USE ONLY!
+     */
+    void setQueryBatch( const QVariantList& queries );
+    Q_INVOKABLE QVariantList takeQueryBatch();
+
     Q_INVOKABLE void addCustomUrlHandler( const QString& protocol, const QString& callbackFuncName, const QString& isAsynchronous = "false" );
     Q_INVOKABLE void reportStreamUrl( const QString& qid, const QString& streamUrl );
     Q_INVOKABLE void reportStreamUrl( const QString& qid, const QString& streamUrl, const QVariantMap& headers );
@@ -124,6 +133,7 @@ public slots:
     bool fakeEnv() { return false; }
 
     void addTrackResults( const QVariantMap& results );
+    void addTrackResultsBatch( const QVariantList& results );
 
     void addArtistResults( const QVariantMap& results );
     void addAlbumResults( const QVariantMap& results );
@@ -148,6 +158,7 @@ private:
     QVariantList searchInFuzzyIndex( const Tomahawk::query_ptr& query );
 
     QVariantMap m_resolverConfig;
+    QVariantList m_queryBatch;
     JSResolver* m_resolver;
     QString m_scriptPath, m_urlCallback, m_urlTranslator;
     QHash< QString, boost::function< void( const QString&, QSharedPointer< QIODevice >& ) > > m_streamCallbacks;
@@ -0,0 +1,252 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResolveCache.h"
+
+#include "collection/Collection.h"
+#include "resolvers/ExternalResolver.h"
+#include "resolvers/ScriptCollection.h"
+#include "utils/TomahawkCache.h"
+#include "utils/Logger.h"
+
+#include "Query.h"
+#include "Source.h"
+#include "SourceList.h"
+#include "Track.h"
+
+#include <QMutexLocker>
+
+#define CACHE_IDENTIFIER "ResolveCache"
+#define DEFAULT_FOUND_TTL 7 * 24 * 3600 * Q_INT64_C( 1000 )
+#define DEFAULT_NOTFOUND_TTL 24 * 3600 * Q_INT64_C( 1000 )
+// Has to outlive every entry, or entries from before the first invalidation come back
+#define GENERATION_TTL 10 * 365 * 24 * 3600 * Q_INT64_C( 1000 )
+
+// As named by DatabaseResolver::name(), it searches all collections but the script ones
+#define DATABASE_RESOLVER "DatabaseResolver"
+
+using namespace Tomahawk;
+
+ResolveCache* ResolveCache::s_instance = 0;
+
+
+ResolveCache*
+ResolveCache::instance()
+{
+    return s_instance;
+}
+
+
+ResolveCache::ResolveCache( TomahawkUtils::Cache* cache, QObject* parent )
+    : QObject( parent )
+    , m_cache( cache ? cache : TomahawkUtils::Cache::instance() )
+    , m_defaultTimeToLive( DEFAULT_FOUND_TTL, DEFAULT_NOTFOUND_TTL )
+    , m_localChanged( false )
+{
+    s_instance = this;
+
+    // It only answers from sources online right now, a miss before our
+    // friends connected or finished syncing says nothing about later
+    m_timeToLive.insert( DATABASE_RESOLVER, qMakePair( DEFAULT_FOUND_TTL, Q_INT64_C( 0 ) ) );
+
+    connect( SourceList::instance(), SIGNAL( sourceAdded( Tomahawk::source_ptr ) ),
+                                       SLOT( onSourceAdded( Tomahawk::source_ptr ) ) );
+    connect( SourceList::instance(), SIGNAL( scriptCollectionAdded( Tomahawk::collection_ptr ) ),
+                                       SLOT( onCollectionAdded( Tomahawk::collection_ptr ) ) );
+
+    foreach ( const source_ptr& source, SourceList::instance()->sources() )
+        onSourceAdded( source );
+    foreach ( const collection_ptr& collection, SourceList::instance()->scriptCollections() )
+        onCollectionAdded( collection );
+}
+
+
+ResolveCache::~ResolveCache()
+{
+    if ( s_instance == this )
+        s_instance = 0;
+}
+
+
+ResolveCache::State
+ResolveCache::state( const query_ptr& query, const QString& resolver, QString* resultHint )
+{
+    if ( query->isFullTextQuery() )
+        return Unknown;
+
+    const QVariantList entry = m_cache->getData( CACHE_IDENTIFIER, key( query, resolver ) ).toList();
+    if ( entry.count() != 2 || entry.first().toInt() != generation( resolver ) )
+        return Unknown;
+
+    const QString url = entry.last().toString();
+    if ( url.isEmpty() )
+        return NotFound;
+
+    if ( resultHint )
+        *resultHint = url;
+
+    return Found;
+}
+
+
+void
+ResolveCache::setFound( const query_ptr& query, const QString& resolver, const QString& url )
+{
+    if ( url.isEmpty() )
+        return;
+
+    store( query, resolver, url, timeToLive( resolver ).first );
+}
+
+
+void
+ResolveCache::setNotFound( const query_ptr& query, const QString& resolver )
+{
+    store( query, resolver, QString(), timeToLive( resolver ).second );
+}
+
+
+void
+ResolveCache::setTimeToLive( const QString& resolver, qint64 found, qint64 notFound )
+{
+    QMutexLocker lock( &m_mutex );
+    m_timeToLive.insert( resolver, qMakePair( found, notFound ) );
+}
+
+
+void
+ResolveCache::setDefaultTimeToLive( qint64 found, qint64 notFound )
+{
+    QMutexLocker lock( &m_mutex );
+    m_defaultTimeToLive = qMakePair( found, notFound );
+}
+
+
+void
+ResolveCache::invalidate( const QString& resolver )
+{
+    const int next = generation( resolver ) + 1;
+    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << resolver << next;
+
+    QMutexLocker lock( &m_mutex );
+    m_generations.insert( resolver, next );
+    m_cache->putData( CACHE_IDENTIFIER, GENERATION_TTL, "generation\t" + resolver, next );
+}
+
+
+void
+ResolveCache::onScanFinished()
+{
+    if ( !m_localChanged )
+        return;
+
+    m_localChanged = false;
+    invalidate( DATABASE_RESOLVER );
+}
+
+
+void
+ResolveCache::onSourceAdded( const source_ptr& source )
+{
+    if ( !source->isLocal() )
+        return;
+
+    connect( source.data(), SIGNAL( collectionAdded( Tomahawk::collection_ptr ) ),
+                              SLOT( onCollectionAdded( Tomahawk::collection_ptr ) ), Qt::UniqueConnection );
+
+    foreach ( const collection_ptr& collection, source->collections() )
+        onCollectionAdded( collection );
+}
+
+
+void
+ResolveCache::onCollectionAdded( const collection_ptr& collection )
+{
+    if ( !qobject_cast< ScriptCollection* >( collection.data() ) )
+    {
+        // A scan adds the local tracks in batches, only its end counts
+        connect( collection.data(), SIGNAL( tracksAdded( QList<unsigned int> ) ),
+                                      SLOT( onLocalCollectionChanged() ), Qt::UniqueConnection );
+        connect( collection.data(), SIGNAL( tracksRemoved( QList<unsigned int> ) ),
+                                      SLOT( onLocalCollectionChanged() ), Qt::UniqueConnection );
+        return;
+    }
+
+    connect( collection.data(), SIGNAL( tracksAdded( QList<unsigned int> ) ),
+                                  SLOT( onCollectionChanged() ), Qt::UniqueConnection );
+    connect( collection.data(), SIGNAL( tracksRemoved( QList<unsigned int> ) ),
+                                  SLOT( onCollectionChanged() ), Qt::UniqueConnection );
+    connect( collection.data(), SIGNAL( changed() ),
+                                  SLOT( onCollectionChanged() ), Qt::UniqueConnection );
+}
+
+
+void
+ResolveCache::onCollectionChanged()
+{
+    ScriptCollection* scriptCollection = qobject_cast< ScriptCollection* >( sender() );
+    if ( scriptCollection && scriptCollection->resolver() )
+        invalidate( scriptCollection->resolver()->name() );
+}
+
+
+void
+ResolveCache::onLocalCollectionChanged()
+{
+    m_localChanged = true;
+}
+
+
+QString
+ResolveCache::key( const query_ptr& query, const QString& resolver ) const
+{
+    const track_ptr track = query->queryTrack();
+    return QString( "%1\t%2\t%3\t%4" ).arg( resolver )
+                                      .arg( track->artistSortname() )
+                                      .arg( track->albumSortname() )
+                                      .arg( track->trackSortname() );
+}
+
+
+QPair< qint64, qint64 >
+ResolveCache::timeToLive( const QString& resolver ) const
+{
+    QMutexLocker lock( &m_mutex );
+    return m_timeToLive.value( resolver, m_defaultTimeToLive );
+}
+
+
+int
+ResolveCache::generation( const QString& resolver )
+{
+    QMutexLocker lock( &m_mutex );
+    if ( !m_generations.contains( resolver ) )
+        m_generations.insert( resolver, m_cache->getData( CACHE_IDENTIFIER, "generation\t" + resolver ).toInt() );
+
+    return m_generations.value( resolver );
+}
+
+
+void
+ResolveCache::store( const query_ptr& query, const QString& resolver, const QString& url, qint64 ttl )
+{
+    if ( ttl <= 0 || query->isFullTextQuery() )
+        return;
+
+    m_cache->putData( CACHE_IDENTIFIER, ttl, key( query, resolver ), QVariantList() << generation( resolver ) << url );
+}
@@ -0,0 +1,126 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_RESOLVECACHE_H
+#define TOMAHAWK_RESOLVECACHE_H
+
+#include "DllMacro.h"
+#include "Typedefs.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+
+namespace TomahawkUtils
+{
+    class Cache;
+}
+
+namespace Tomahawk
+{
+
+/**
+ * Remembers across sessions what every resolver answered for a track, so
+ * the Pipeline doesn't have to ask again.
+ *
+ * Entries are keyed on the resolver's name and the normalized artist, album
+ * and track of the query. A resolver that found the track leaves the url of
+ * its result, which the Pipeline hands back as result hint. A resolver that
+ * didn't find it isn't asked again until the entry expired.
+ *
+ * Every resolver can have its own time to live for both. Changes to a
+ * script collection drop everything cached for its resolver. Changes to
+ * the local collection drop what the DatabaseResolver answered, once the
+ * scan making them finished. Peers' collections aren't followed, which is
+ * why misses of the DatabaseResolver aren't cached at all: it only answers
+ * from the sources online at the time.
+ */
+class DLLEXPORT ResolveCache : public QObject
+{
+Q_OBJECT
+
+public:
+    enum State
+    {
+        Unknown = 0,
+        Found,
+        NotFound
+    };
+
+    static ResolveCache* instance();
+
+    /**
+     * Stores its entries in cache, Cache::instance() unless given a separate
+     * one, e.g. in tests. The Pipeline only consults the cache once created.
+     */
+    explicit ResolveCache( TomahawkUtils::Cache* cache = 0, QObject* parent = 0 );
+    virtual ~ResolveCache();
+
+    /**
+     * What resolver answered for query when last asked, Unknown if it wasn't
+     * asked yet or its answer expired. For Found the url of its result is
+     * returned in resultHint.
+     */
+    State state( const Tomahawk::query_ptr& query, const QString& resolver, QString* resultHint = 0 );
+
+    void setFound( const Tomahawk::query_ptr& query, const QString& resolver, const QString& url );
+    void setNotFound( const Tomahawk::query_ptr& query, const QString& resolver );
+
+    // In milliseconds, a time to live of 0 disables caching that answer
+    void setTimeToLive( const QString& resolver, qint64 found, qint64 notFound );
+    void setDefaultTimeToLive( qint64 found, qint64 notFound );
+
+    /**
+     * Forgets everything cached for resolver.
+     */
+    void invalidate( const QString& resolver );
+
+public slots:
+    /**
+     * Forgets what the DatabaseResolver answered if the local collection
+     * changed since the last scan finished.
+     */
+    void onScanFinished();
+
+private slots:
+    void onSourceAdded( const Tomahawk::source_ptr& source );
+    void onCollectionAdded( const Tomahawk::collection_ptr& collection );
+    void onCollectionChanged();
+    void onLocalCollectionChanged();
+
+private:
+    QString key( const Tomahawk::query_ptr& query, const QString& resolver ) const;
+    QPair< qint64, qint64 > timeToLive( const QString& resolver ) const;
+    int generation( const QString& resolver );
+    void store( const Tomahawk::query_ptr& query, const QString& resolver, const QString& url, qint64 ttl );
+
+    TomahawkUtils::Cache* m_cache;
+
+    mutable QMutex m_mutex;
+    QHash< QString, QPair< qint64, qint64 > > m_timeToLive;
+    QPair< qint64, qint64 > m_defaultTimeToLive;
+    QHash< QString, int > m_generations;
+    bool m_localChanged;
+
+    static ResolveCache* s_instance;
+};
+
+} // namespace Tomahawk
+
+#endif // TOMAHAWK_RESOLVECACHE_H
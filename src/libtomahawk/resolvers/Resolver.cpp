@@ -18,4 +18,19 @@
 
 #include "Resolver.h"
 
-#include "Source.h"
\ No newline at end of file
+#include "Source.h"
+
+
+void
+Tomahawk::Resolver::resolve( const QList< Tomahawk::query_ptr >& queries )
+{
+    foreach ( const Tomahawk::query_ptr& query, queries )
+        resolve( query );
+}
+
+
+void
+Tomahawk::Resolver::cancel( const Tomahawk::query_ptr& query )
+{
+    Q_UNUSED( query );
+}
@@ -50,6 +50,20 @@ public:
 
 public slots:
     virtual void resolve( const Tomahawk::query_ptr& query ) = 0;
+
+    /**
+     * Resolves several queries at once. Resolvers that can answer a whole
+     * batch cheaper than one query at a time should reimplement this,
+     * the default just calls resolve() for every query.
+     */
+    virtual void resolve( const QList< Tomahawk::query_ptr >& queries );
+
+    /**
+     * The Pipeline doesn't need an answer for query anymore, e.g. because
+     * another resolver asked at the same time found a perfect result.
+     * Resolvers that can drop queued work should reimplement this.
+     */
+    virtual void cancel( const Tomahawk::query_ptr& query );
 };
 
 } //ns
@@ -35,7 +35,6 @@
 #include "SourceList.h"
 #include "Track.h"
 
-#include <QtEndian>
 #include <QFileInfo>
 #include <QNetworkAccessManager>
 #include <QNetworkProxy>
@@ -47,7 +46,7 @@
 ScriptResolver::ScriptResolver( const QString& exe )
     : Tomahawk::ExternalResolverGui( exe )
     , m_num_restarts( 0 )
-    , m_msgsize( 0 )
+    , m_channel( &m_proc )
     , m_ready( false )
     , m_stopped( true )
     , m_configSent( false )
@@ -56,7 +55,7 @@ ScriptResolver::ScriptResolver( const QString& exe )
 {
     tLog() << Q_FUNC_INFO << "Created script resolver:" << exe;
     connect( &m_proc, SIGNAL( readyReadStandardError() ), SLOT( readStderr() ) );
-    connect( &m_proc, SIGNAL( readyReadStandardOutput() ), SLOT( readStdout() ) );
+    connect( &m_channel, SIGNAL( message( QVariantMap ) ), SLOT( handleMsg( QVariantMap ) ) );
     connect( &m_proc, SIGNAL( finished( int, QProcess::ExitStatus ) ), SLOT( cmdExited( int, QProcess::ExitStatus ) ) );
 
     startProcess();
@@ -205,67 +204,21 @@ ScriptResolver::error() const
 }
 
 
-void
-ScriptResolver::readStdout()
-{
-    if ( m_msgsize == 0 )
-    {
-        if ( m_proc.bytesAvailable() < 4 )
-            return;
-
-        quint32 len_nbo;
-        m_proc.read( (char*) &len_nbo, 4 );
-        m_msgsize = qFromBigEndian( len_nbo );
-    }
-
-    if ( m_msgsize > 0 )
-    {
-        m_msg.append( m_proc.read( m_msgsize - m_msg.length() ) );
-    }
-
-    if ( m_msgsize == (quint32) m_msg.length() )
-    {
-        handleMsg( m_msg );
-        m_msgsize = 0;
-        m_msg.clear();
-
-        if ( m_proc.bytesAvailable() )
-            QTimer::singleShot( 0, this, SLOT( readStdout() ) );
-    }
-}
-
-
 void
 ScriptResolver::sendMsg( const QByteArray& msg )
 {
 //     qDebug() << Q_FUNC_INFO << m_ready << msg << msg.length();
-    if ( !m_proc.isOpen() )
-        return;
-
-    quint32 len;
-    qToBigEndian( msg.length(), (uchar*) &len );
-    m_proc.write( (const char*) &len, 4 );
-    m_proc.write( msg );
+    m_channel.send( msg );
 }
 
 
 void
-ScriptResolver::handleMsg( const QByteArray& msg )
+ScriptResolver::handleMsg( const QVariantMap& m )
 {
-//    qDebug() << Q_FUNC_INFO << msg.size() << QString::fromAscii( msg );
-
     // Might be called from waitForFinished() in ~ScriptResolver, no database in that case, abort.
     if ( m_deleting )
         return;
 
-    bool ok;
-    QVariant v = TomahawkUtils::parseJson( msg, &ok );
-    if ( !ok || v.type() != QVariant::Map )
-    {
-        Q_ASSERT( false );
-        return;
-    }
-    QVariantMap m = v.toMap();
     QString msgtype = m.value( "_msgtype" ).toString();
 
     if ( msgtype == "settings" )
@@ -324,7 +277,7 @@ ScriptResolver::handleMsg( const QByteArray& msg )
             results << rp;
         }
 
-        Tomahawk::Pipeline::instance()->reportResults( qid, results );
+        Tomahawk::Pipeline::instance()->reportResults( qid, this, results );
     }
     else
     {
@@ -338,6 +291,7 @@ void
 ScriptResolver::cmdExited( int code, QProcess::ExitStatus status )
 {
     m_ready = false;
+    m_channel.reset();
     tLog() << Q_FUNC_INFO << "SCRIPT EXITED, code" << code << "status" << status << filePath();
     Tomahawk::Pipeline::instance()->removeResolver( this );
 
@@ -388,8 +342,15 @@ ScriptResolver::resolve( const Tomahawk::query_ptr& query )
             m.insert( "resultHint", query->resultHint() );
     }
 
-    const QByteArray msg = TomahawkUtils::toJson( QVariant( m ) );
-    sendMsg( msg );
+    m_channel.request( query->id(), TomahawkUtils::toJson( QVariant( m ) ) );
+}
+
+
+void
+ScriptResolver::cancel( const Tomahawk::query_ptr& query )
+{
+    // Requests already sent just get their answer ignored
+    m_channel.cancel( query->id() );
 }
 
 
@@ -401,6 +362,9 @@ ScriptResolver::doSetup( const QVariantMap& m )
     m_name    = m.value( "name" ).toString();
     m_weight  = m.value( "weight", 0 ).toUInt();
     m_timeout = m.value( "timeout", 5 ).toUInt() * 1000;
+    m_channel.setTimeout( m_timeout );
+    if ( m.contains( "maxinflight" ) )
+        m_channel.setWindow( m.value( "maxinflight" ).toInt() );
     bool compressed = m.value( "compressed", "false" ).toString() == "true";
 
     bool ok = 0;
@@ -432,7 +396,7 @@ ScriptResolver::doSetup( const QVariantMap& m )
         success = m_icon.load( iconPath );
     }
 
-    qDebug() << "SCRIPT" << filePath() << "READY," << "name" << m_name << "weight" << m_weight << "timeout" << m_timeout << "icon received" << success;
+    qDebug() << "SCRIPT" << filePath() << "READY," << "name" << m_name << "weight" << m_weight << "timeout" << m_timeout << "window" << m_channel.window() << "icon received" << success;
 
     m_ready = true;
     m_configSent = false;
@@ -27,6 +27,7 @@
 #include "collection/Collection.h"
 #include "ExternalResolverGui.h"
 #include "DllMacro.h"
+#include "ScriptResolverChannel.h"
 
 #include <QProcess>
 
@@ -69,6 +70,7 @@ signals:
 public slots:
     void stop() Q_DECL_OVERRIDE;
     void resolve( const Tomahawk::query_ptr& query ) Q_DECL_OVERRIDE;
+    void cancel( const Tomahawk::query_ptr& query ) Q_DECL_OVERRIDE;
     void start() Q_DECL_OVERRIDE;
 
     // TODO: implement. Or not. Not really an issue while Spotify doesn't do browsable personal cloud storage.
@@ -80,13 +82,12 @@ public slots:
 
 private slots:
     void readStderr();
-    void readStdout();
+    void handleMsg( const QVariantMap& m );
     void cmdExited( int code, QProcess::ExitStatus status );
 
 private:
     void sendConfig();
 
-    void handleMsg( const QByteArray& msg );
     void sendMsg( const QByteArray& msg );
     void doSetup( const QVariantMap& m );
     void setupConfWidget( const QVariantMap& m );
@@ -100,8 +101,7 @@ private:
     Capabilities m_capabilities;
     QPointer< AccountConfigWidget > m_configWidget;
 
-    quint32 m_msgsize;
-    QByteArray m_msg;
+    ScriptResolverChannel m_channel;
 
     bool m_ready, m_stopped, m_configSent, m_deleting;
     ExternalResolver::ErrorState m_error;
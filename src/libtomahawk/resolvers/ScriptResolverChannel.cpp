@@ -0,0 +1,184 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ScriptResolverChannel.h"
+
+#include "utils/Json.h"
+#include "utils/Logger.h"
+
+#include <QDateTime>
+#include <QtEndian>
+
+#define DEFAULT_WINDOW 32
+#define DEFAULT_TIMEOUT 5000
+
+
+ScriptResolverChannel::ScriptResolverChannel( QIODevice* device, QObject* parent )
+    : QObject( parent )
+    , m_device( device )
+    , m_window( DEFAULT_WINDOW )
+    , m_timeout( DEFAULT_TIMEOUT )
+    , m_nextId( 0 )
+    , m_timeouts( QDateTime::currentMSecsSinceEpoch(), 100 )
+{
+    m_timer.setInterval( m_timeouts.resolution() );
+    connect( &m_timer, SIGNAL( timeout() ), SLOT( onTimer() ) );
+    connect( m_device, SIGNAL( readyRead() ), SLOT( readFrames() ) );
+}
+
+
+void
+ScriptResolverChannel::send( const QByteArray& msg )
+{
+    sendFrame( msg );
+}
+
+
+void
+ScriptResolverChannel::request( const QString& qid, const QByteArray& msg )
+{
+    m_queue.enqueue( qMakePair( qid, msg ) );
+    sendQueued();
+}
+
+
+void
+ScriptResolverChannel::cancel( const QString& qid )
+{
+    for ( int i = m_queue.count() - 1; i >= 0; i-- )
+    {
+        if ( m_queue.at( i ).first == qid )
+            m_queue.removeAt( i );
+    }
+}
+
+
+void
+ScriptResolverChannel::setWindow( int window )
+{
+    m_window = qMax( 1, window );
+    sendQueued();
+}
+
+
+void
+ScriptResolverChannel::reset()
+{
+    m_buffer.clear();
+    m_queue.clear();
+    m_inFlight.clear();
+    m_requestIds.clear();
+    m_timer.stop();
+}
+
+
+void
+ScriptResolverChannel::sendFrame( const QByteArray& msg )
+{
+    if ( !m_device->isOpen() )
+        return;
+
+    quint32 len;
+    qToBigEndian( msg.length(), (uchar*) &len );
+    m_device->write( (const char*) &len, 4 );
+    m_device->write( msg );
+}
+
+
+void
+ScriptResolverChannel::sendQueued()
+{
+    while ( !m_queue.isEmpty() && m_inFlight.count() < m_window )
+    {
+        const QPair< QString, QByteArray > rq = m_queue.dequeue();
+
+        const quint64 id = ++m_nextId;
+        m_requestIds.remove( m_inFlight.value( rq.first ) ); // asked again, only the latest counts
+        m_inFlight.insert( rq.first, id );
+        m_requestIds.insert( id, rq.first );
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        m_timeouts.schedule( id, now + m_timeout, now );
+
+        sendFrame( rq.second );
+    }
+
+    if ( !m_inFlight.isEmpty() && !m_timer.isActive() )
+        m_timer.start();
+}
+
+
+void
+ScriptResolverChannel::readFrames()
+{
+    m_buffer.append( m_device->readAll() );
+
+    // Handle every complete frame we've got, the rest waits for the next readyRead
+    int pos = 0;
+    while ( m_buffer.length() - pos >= 4 )
+    {
+        const quint32 size = qFromBigEndian< quint32 >( (const uchar*) m_buffer.constData() + pos );
+        if ( (quint32)( m_buffer.length() - pos - 4 ) < size )
+            break;
+
+        const QByteArray frame = m_buffer.mid( pos + 4, size );
+        pos += 4 + size;
+
+        bool ok;
+        const QVariant v = TomahawkUtils::parseJson( frame, &ok );
+        if ( !ok || v.type() != QVariant::Map )
+        {
+            tLog() << Q_FUNC_INFO << "Dropping invalid message:" << frame;
+            continue;
+        }
+
+        const QVariantMap m = v.toMap();
+        if ( m.value( "_msgtype" ).toString() == "results" )
+        {
+            const QString qid = m.value( "qid" ).toString();
+            m_requestIds.remove( m_inFlight.take( qid ) );
+        }
+
+        emit message( m );
+    }
+    m_buffer.remove( 0, pos );
+
+    sendQueued();
+}
+
+
+void
+ScriptResolverChannel::onTimer()
+{
+    foreach ( quint64 id, m_timeouts.advance( QDateTime::currentMSecsSinceEpoch() ) )
+    {
+        if ( !m_requestIds.contains( id ) )
+            continue;
+
+        const QString qid = m_requestIds.take( id );
+        m_inFlight.remove( qid );
+
+        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Request timed out:" << qid;
+    }
+
+    // Answered requests stay in the wheel until they would have timed out. Stop only
+    // once it's empty, so it never has to catch up on ticks nobody advanced it by.
+    if ( m_timeouts.isEmpty() )
+        m_timer.stop();
+
+    sendQueued();
+}
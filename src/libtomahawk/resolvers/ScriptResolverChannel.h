@@ -0,0 +1,89 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTRESOLVERCHANNEL_H
+#define SCRIPTRESOLVERCHANNEL_H
+
+#include "utils/TimerWheel.h"
+#include "DllMacro.h"
+
+#include <QHash>
+#include <QIODevice>
+#include <QQueue>
+#include <QTimer>
+#include <QVariantMap>
+
+/**
+ * Length-prefixed JSON messages between a ScriptResolver and its process.
+ *
+ * Requests are pipelined: up to window() of them are out at the same time,
+ * each correlated with its answer by its qid. A request is done once a
+ * "results" message with its qid arrives or its timeout passes, whichever
+ * comes first. A resolver that never answers one query therefore only holds
+ * up a single slot of the window, and only until the timeout. Giving up on
+ * the query itself is left to the Pipeline, which times it out on its own.
+ */
+class DLLEXPORT ScriptResolverChannel : public QObject
+{
+Q_OBJECT
+
+public:
+    explicit ScriptResolverChannel( QIODevice* device, QObject* parent = 0 );
+
+    // Sent right away, not part of the request window
+    void send( const QByteArray& msg );
+    void request( const QString& qid, const QByteArray& msg );
+    // Drops the request for qid if it's still waiting for the window
+    void cancel( const QString& qid );
+
+    int window() const { return m_window; }
+    void setWindow( int window );
+    void setTimeout( int msecs ) { m_timeout = msecs; }
+
+    int inFlight() const { return m_inFlight.count(); }
+    int queued() const { return m_queue.count(); }
+
+    // Forgets everything in flight and half read, e.g. after the process restarted
+    void reset();
+
+signals:
+    void message( const QVariantMap& msg );
+
+private slots:
+    void readFrames();
+    void onTimer();
+
+private:
+    void sendFrame( const QByteArray& msg );
+    void sendQueued();
+
+    QIODevice* m_device;
+    QByteArray m_buffer;
+
+    int m_window;
+    int m_timeout;
+    QQueue< QPair< QString, QByteArray > > m_queue;
+    QHash< QString, quint64 > m_inFlight;
+    QHash< quint64, QString > m_requestIds;
+    quint64 m_nextId;
+
+    Tomahawk::TimerWheel m_timeouts;
+    QTimer m_timer;
+};
+
+#endif // SCRIPTRESOLVERCHANNEL_H
@@ -0,0 +1,180 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CoverLoader.h"
+
+#include "utils/Logger.h"
+#include "utils/TomahawkUtils.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QRunnable>
+#include <QThread>
+
+// Bigger ones are rare and not worth the disk space
+#define MAX_THUMBNAIL_SIZE 512
+
+using namespace Tomahawk;
+
+CoverLoader* CoverLoader::s_instance = 0;
+
+
+class CoverLoaderJob : public QRunnable
+{
+public:
+    CoverLoaderJob( CoverLoader* loader, const QString& cacheKey, const QByteArray& data, const QSize& size, const QDir& dir )
+        : m_loader( loader )
+        , m_cacheKey( cacheKey )
+        , m_data( data )
+        , m_size( size )
+        , m_dir( dir )
+    {
+    }
+
+    void run()
+    {
+        const bool persist = m_size.width() <= MAX_THUMBNAIL_SIZE && m_size.height() <= MAX_THUMBNAIL_SIZE;
+        const QString hash = QCryptographicHash::hash( m_data, QCryptographicHash::Md5 ).toHex();
+        const QString path = m_dir.filePath( QString( "%1_%2x%3.png" ).arg( hash ).arg( m_size.width() ).arg( m_size.height() ) );
+
+        QImage image;
+        if ( !persist || !image.load( path ) )
+        {
+            image = CoverLoader::squareThumbnail( m_data, m_size );
+
+            // Written under a temporary name, another job could be saving the same cover
+            if ( persist && !image.isNull() && image.save( path + ".tmp", "PNG" ) && !QFile::rename( path + ".tmp", path ) )
+                QFile::remove( path + ".tmp" );
+        }
+
+        if ( m_loader )
+        {
+            QMetaObject::invokeMethod( m_loader, "onLoaded", Qt::QueuedConnection,
+                                       Q_ARG( QString, m_cacheKey ), Q_ARG( QImage, image ) );
+        }
+    }
+
+private:
+    QPointer< CoverLoader > m_loader;
+    QString m_cacheKey;
+    QByteArray m_data;
+    QSize m_size;
+    QDir m_dir;
+};
+
+
+CoverLoader*
+CoverLoader::instance()
+{
+    if ( !s_instance )
+        new CoverLoader( QCoreApplication::instance() );
+
+    return s_instance;
+}
+
+
+CoverLoader::CoverLoader( QObject* parent )
+    : QObject( parent )
+{
+    s_instance = this;
+
+    setThumbnailDir( QDir( TomahawkUtils::appDataDir().absoluteFilePath( "thumbnails" ) ) );
+    m_pool.setMaxThreadCount( qMax( 2, QThread::idealThreadCount() ) );
+}
+
+
+CoverLoader::~CoverLoader()
+{
+    m_pool.waitForDone();
+
+    if ( s_instance == this )
+        s_instance = 0;
+}
+
+
+void
+CoverLoader::setThumbnailDir( const QDir& dir )
+{
+    m_thumbnailDir = dir;
+    m_thumbnailDir.mkpath( "." );
+}
+
+
+void
+CoverLoader::load( const QString& cacheKey, const QByteArray& data, const QSize& size, QObject* receiver )
+{
+    if ( m_failed.contains( cacheKey ) )
+        return;
+
+    const bool pending = m_pending.contains( cacheKey );
+    QList< QPointer< QObject > >& receivers = m_pending[ cacheKey ];
+    if ( !receivers.contains( receiver ) )
+        receivers << QPointer< QObject >( receiver );
+
+    if ( !pending )
+        m_pool.start( new CoverLoaderJob( this, cacheKey, data, size, m_thumbnailDir ) );
+}
+
+
+QImage
+CoverLoader::squareThumbnail( const QByteArray& data, const QSize& size )
+{
+    QImage image = QImage::fromData( data );
+    if ( image.isNull() )
+        return image;
+
+    if ( image.width() != image.height() )
+    {
+        const int sqwidth = qMin( image.width(), image.height() );
+        const int delta = qAbs( image.width() - image.height() );
+
+        if ( image.width() > image.height() )
+            image = image.copy( delta / 2, 0, sqwidth, sqwidth );
+        else
+            image = image.copy( 0, delta / 2, sqwidth, sqwidth );
+    }
+
+    return image.scaled( size, Qt::KeepAspectRatio, Qt::SmoothTransformation );
+}
+
+
+void
+CoverLoader::onLoaded( const QString& cacheKey, const QImage& image )
+{
+    const QList< QPointer< QObject > > receivers = m_pending.take( cacheKey );
+    if ( image.isNull() )
+    {
+        tDebug() << Q_FUNC_INFO << "Could not decode cover for" << cacheKey;
+        m_failed << cacheKey;
+        return;
+    }
+
+    // QPixmaps can only be made here, on the GUI thread
+    QPixmapCache::insert( cacheKey, QPixmap::fromImage( image ) );
+
+    foreach ( const QPointer< QObject >& receiver, receivers )
+    {
+        if ( receiver )
+            QMetaObject::invokeMethod( receiver.data(), "coverChanged" );
+    }
+
+    emit loaded( cacheKey );
+}
@@ -0,0 +1,84 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_COVERLOADER_H
+#define TOMAHAWK_COVERLOADER_H
+
+#include "DllMacro.h"
+
+#include <QDir>
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QSet>
+#include <QThreadPool>
+
+namespace Tomahawk
+{
+
+/**
+ * Turns the raw bytes of album and artist covers into square thumbnails,
+ * away from the GUI thread.
+ *
+ * Decoding and scaling happens on a pool of worker threads. The result is
+ * put into QPixmapCache under the key it was requested with, after which the
+ * requester's coverChanged() signal is emitted. Thumbnails are also written
+ * to disk, keyed by a hash of the cover bytes and the size, so a cover
+ * seen in an earlier session is never decoded at full size again.
+ */
+class DLLEXPORT CoverLoader : public QObject
+{
+Q_OBJECT
+
+public:
+    static CoverLoader* instance();
+
+    explicit CoverLoader( QObject* parent = 0 );
+    virtual ~CoverLoader();
+
+    /**
+     * Scales the cover in data to size for cacheKey. Returns right away,
+     * receiver gets its coverChanged() signal emitted once the thumbnail is
+     * in QPixmapCache. Asking again while a request is pending does nothing.
+     */
+    void load( const QString& cacheKey, const QByteArray& data, const QSize& size, QObject* receiver );
+
+    QDir thumbnailDir() const { return m_thumbnailDir; }
+    void setThumbnailDir( const QDir& dir );
+
+    // Decodes data, crops it to a square and scales it, as done by the workers
+    static QImage squareThumbnail( const QByteArray& data, const QSize& size );
+
+signals:
+    void loaded( const QString& cacheKey );
+
+private slots:
+    void onLoaded( const QString& cacheKey, const QImage& image );
+
+private:
+    QThreadPool m_pool;
+    QDir m_thumbnailDir;
+    QHash< QString, QList< QPointer< QObject > > > m_pending;
+    QSet< QString > m_failed;
+
+    static CoverLoader* s_instance;
+};
+
+}
+
+#endif // TOMAHAWK_COVERLOADER_H
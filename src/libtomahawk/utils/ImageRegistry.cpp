@@ -23,34 +23,41 @@
 
 #include "utils/Logger.h"
 
-static QHash< QString, QHash< int, QHash< qint64, QPixmap > > > s_cache;
+#define DEFAULT_CACHE_LIMIT 32768
+#define MAX_SVG_RENDERERS 64
+
 ImageRegistry* ImageRegistry::s_instance = 0;
 
 
 ImageRegistry*
 ImageRegistry::instance()
 {
+    if ( !s_instance )
+        new ImageRegistry();
+
     return s_instance;
 }
 
 
 ImageRegistry::ImageRegistry()
+    : m_cache( DEFAULT_CACHE_LIMIT )
+    , m_svgRenderers( MAX_SVG_RENDERERS )
 {
     s_instance = this;
 }
 
 
-QIcon
-ImageRegistry::icon( const QString& image, TomahawkUtils::ImageMode mode )
+ImageRegistry::~ImageRegistry()
 {
-    return pixmap( image, TomahawkUtils::defaultIconSize(), mode );
+    if ( s_instance == this )
+        s_instance = 0;
 }
 
 
-qint64
-ImageRegistry::cacheKey( const QSize& size, float opacity, QColor tint )
+QIcon
+ImageRegistry::icon( const QString& image, TomahawkUtils::ImageMode mode )
 {
-    return size.width() * 100 + size.height() * 10 + ( opacity * 100.0 ) + tint.value();
+    return pixmap( image, TomahawkUtils::defaultIconSize(), mode );
 }
 
 
@@ -63,41 +70,113 @@ ImageRegistry::pixmap( const QString& image, const QSize& size, TomahawkUtils::I
         return QPixmap();
     }
 
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
+    // Opacity and tint only apply to SVGs
+    const bool svg = image.endsWith( ".svg", Qt::CaseInsensitive );
+    const bool plain = !svg || ( opacity >= 1.0 && tint.alpha() == 0 );
+
+    ImageCacheKey key;
+    key.image = image;
+    key.mode = mode;
+    key.size = size;
+    key.opacity = plain ? 1000 : qRound( opacity * 1000.0 );
+    key.tint = plain || tint.alpha() == 0 ? 0 : tint.rgba();
 
-    if ( s_cache.contains( image ) )
     {
-        subcache = s_cache.value( image );
+        QMutexLocker lock( &m_mutex );
+        if ( QPixmap* cached = m_cache.object( key ) )
+            return *cached;
+    }
+
+    // Image not found in cache. Let's load it, or derive it from its plain version.
+    QPixmap pixmap;
+    if ( plain )
+    {
+        pixmap = render( image, size, mode );
+    }
+    else
+    {
+        pixmap = this->pixmap( image, size, mode );
+        if ( pixmap.isNull() )
+            return pixmap;
 
-        if ( subcache.contains( mode ) )
+        if ( opacity < 1.0 )
         {
-            subsubcache = subcache.value( mode );
+            QPixmap p( pixmap.size() );
+            p.fill( Qt::transparent );
 
-            const qint64 ck = cacheKey( size, opacity, tint );
-            if ( subsubcache.contains( ck ) )
-            {
-                return subsubcache.value( ck );
-            }
+            QPainter pixPainter( &p );
+            pixPainter.setOpacity( opacity );
+            pixPainter.drawPixmap( 0, 0, pixmap );
+            pixPainter.end();
+
+            pixmap = p;
         }
+
+        if ( tint.alpha() > 0 )
+            pixmap = TomahawkUtils::tinted( pixmap, tint );
     }
 
-    // Image not found in cache. Let's load it.
+    if ( !pixmap.isNull() )
+        putInCache( key, pixmap );
+
+    return pixmap;
+}
+
+
+int
+ImageRegistry::cacheLimit() const
+{
+    QMutexLocker lock( &m_mutex );
+    return m_cache.maxCost();
+}
+
+
+void
+ImageRegistry::setCacheLimit( int kilobytes )
+{
+    QMutexLocker lock( &m_mutex );
+    m_cache.setMaxCost( kilobytes );
+}
+
+
+int
+ImageRegistry::cacheSize() const
+{
+    QMutexLocker lock( &m_mutex );
+    return m_cache.totalCost();
+}
+
+
+QPixmap
+ImageRegistry::render( const QString& image, const QSize& size, TomahawkUtils::ImageMode mode )
+{
     QPixmap pixmap;
-    if ( image.toLower().endsWith( ".svg" ) )
+    if ( image.endsWith( ".svg", Qt::CaseInsensitive ) )
     {
-        QSvgRenderer svgRenderer( image );
-        QPixmap p( size.isNull() ? svgRenderer.defaultSize() : size );
+        // Keep the parsed SVG around, it's going to be rendered at other sizes, too.
+        // Parsing and rendering happen without holding the lock, the shared
+        // pointer keeps the renderer alive should the cache evict it meanwhile.
+        QSharedPointer< QSvgRenderer > svgRenderer;
+        {
+            QMutexLocker lock( &m_mutex );
+            if ( QSharedPointer< QSvgRenderer >* cached = m_svgRenderers.object( image ) )
+                svgRenderer = *cached;
+        }
+        if ( !svgRenderer )
+        {
+            svgRenderer = QSharedPointer< QSvgRenderer >( new QSvgRenderer( image ) );
+
+            QMutexLocker lock( &m_mutex );
+            m_svgRenderers.insert( image, new QSharedPointer< QSvgRenderer >( svgRenderer ) );
+        }
+
+        QPixmap p( size.isNull() ? svgRenderer->defaultSize() : size );
         p.fill( Qt::transparent );
 
         QPainter pixPainter( &p );
-        pixPainter.setOpacity( opacity );
-        svgRenderer.render( &pixPainter );
+        svgRenderer->render( &pixPainter );
         pixPainter.end();
 
-        if ( tint.alpha() > 0 )
-            p = TomahawkUtils::tinted( p, tint );
-
         pixmap = p;
     }
     else
@@ -117,8 +196,6 @@ ImageRegistry::pixmap( const QString& image, const QSize& size, TomahawkUtils::I
 
         if ( !size.isNull() && pixmap.size() != size )
             pixmap = pixmap.scaled( size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
-
-        putInCache( image, size, mode, opacity, pixmap, tint );
     }
 
     return pixmap;
@@ -126,29 +203,13 @@ ImageRegistry::pixmap( const QString& image, const QSize& size, TomahawkUtils::I
 
 
 void
-ImageRegistry::putInCache( const QString& image, const QSize& size, TomahawkUtils::ImageMode mode, float opacity, const QPixmap& pixmap, QColor tint )
+ImageRegistry::putInCache( const ImageCacheKey& key, const QPixmap& pixmap )
 {
-    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Adding to image cache:" << image << size << mode;
+    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Adding to image cache:" << key.image << key.size << key.mode;
 
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
-
-    if ( s_cache.contains( image ) )
-    {
-        subcache = s_cache.value( image );
-
-        if ( subcache.contains( mode ) )
-        {
-            subsubcache = subcache.value( mode );
-
-/*            if ( subsubcache.contains( size.width() * size.height() ) )
-            {
-                Q_ASSERT( false );
-            }*/
-        }
-    }
+    // The cost is the memory taken up, in kilobytes
+    const int cost = qMax( 1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024 );
 
-    subsubcache.insert( cacheKey( size, opacity, tint ), pixmap );
-    subcache.insert( mode, subsubcache );
-    s_cache.insert( image, subcache );
+    QMutexLocker lock( &m_mutex );
+    m_cache.insert( key, new QPixmap( pixmap ), cost );
 }
@@ -18,24 +18,70 @@
 #ifndef IMAGE_REGISTRY_H
 #define IMAGE_REGISTRY_H
 
+#include <QCache>
+#include <QColor>
+#include <QMutex>
 #include <QPixmap>
+#include <QSharedPointer>
 
 #include "utils/TomahawkUtilsGui.h"
 #include "DllMacro.h"
 
+class QSvgRenderer;
+
+struct ImageCacheKey
+{
+    QString image;
+    int mode;
+    QSize size;
+    int opacity; // in thousandths
+    QRgb tint;
+
+    bool operator==( const ImageCacheKey& other ) const
+    {
+        return image == other.image && mode == other.mode && size == other.size &&
+               opacity == other.opacity && tint == other.tint;
+    }
+};
+
+inline uint qHash( const ImageCacheKey& key )
+{
+    return qHash( key.image ) ^ ( key.mode << 28 ) ^ ( key.size.width() << 16 ) ^ key.size.height() ^
+           ( key.opacity << 8 ) ^ key.tint;
+}
+
+/**
+ * Loads, renders and caches the images and icons of the UI.
+ *
+ * Rendered pixmaps are kept in a least-recently-used cache that is bounded
+ * by the memory they take up. Variants of an image with a different opacity
+ * or tint are derived from its plain rendering at the same size, so an SVG
+ * only gets rendered once per size. The parsed SVGs of the most recently
+ * used images are kept, too.
+ */
 class DLLEXPORT ImageRegistry
 {
 public:
     static ImageRegistry* instance();
 
     explicit ImageRegistry();
+    ~ImageRegistry();
 
     QIcon icon( const QString& image, TomahawkUtils::ImageMode mode = TomahawkUtils::Original );
     QPixmap pixmap( const QString& image, const QSize& size, TomahawkUtils::ImageMode mode = TomahawkUtils::Original, float opacity = 1.0, QColor tint = QColor( 0, 0, 0, 0 ) );
 
+    // Limit and current size of the cache, in kilobytes
+    int cacheLimit() const;
+    void setCacheLimit( int kilobytes );
+    int cacheSize() const;
+
 private:
-    qint64 cacheKey( const QSize& size, float opacity, QColor tint );
-    void putInCache( const QString& image, const QSize& size, TomahawkUtils::ImageMode mode, float opacity, const QPixmap& pixmap, QColor tint );
+    QPixmap render( const QString& image, const QSize& size, TomahawkUtils::ImageMode mode );
+    void putInCache( const ImageCacheKey& key, const QPixmap& pixmap );
+
+    mutable QMutex m_mutex;
+    QCache< ImageCacheKey, QPixmap > m_cache;
+    QCache< QString, QSharedPointer< QSvgRenderer > > m_svgRenderers;
 
     static ImageRegistry* s_instance;
 };
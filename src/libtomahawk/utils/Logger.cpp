@@ -22,15 +22,22 @@
 #include <fstream>
 
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include <QMutex>
+#include <QThread>
 #include <QTime>
 #include <QVariant>
+#include <QWaitCondition>
 
 #include "utils/TomahawkUtils.h"
 
 #define LOGFILE_SIZE 1024 * 256
+#define LOGFILE_MAX_SIZE LOGFILE_SIZE * 16  // Trim the logfile while running once it grew this big
+
+#define RING_SIZE 16384     // Number of messages the writer thread can lag behind, has to be a power of two
+#define RING_RETRIES 64     // How often a producer yields on a full ring before dropping its message
 
 #define RELEASE_LEVEL_THRESHOLD 0
 #define DEBUG_LEVEL_THRESHOLD LOGEXTRA
@@ -46,86 +53,345 @@ bool shutdownInProgress = false;
 namespace Logger
 {
 
-static void
-log( const char *msg, unsigned int debugLevel, bool toDisk = true )
+struct LogLine
 {
-    if ( s_threshold < 0 )
-    {
-        if ( qApp->arguments().contains( "--verbose" ) )
-            s_threshold = LOGTHIRDPARTY;
-        else
-            #ifdef QT_NO_DEBUG
-            s_threshold = RELEASE_LEVEL_THRESHOLD;
-            #else
-            s_threshold = DEBUG_LEVEL_THRESHOLD;
-            #endif
-    }
+    QByteArray msg;
+    qint64 timestamp;
+    unsigned int debugLevel;
+    bool toDisk;
+    bool toConsole;
+};
+
+/*
+ * Messages are passed to the writer thread through a bounded multi-producer
+ * ring. Each slot carries a sequence number telling whether it is free for
+ * the producer claiming position n (sequence == n) or holds a message ready
+ * for the consumer (sequence == n + 1), so producers never take a lock.
+ *
+ * When the ring is full, producers yield a few times to let the writer catch
+ * up and then drop their message. The number of dropped messages is written
+ * to the log with the next batch.
+ */
+struct LogSlot
+{
+    QAtomicInt sequence;
+    LogLine line;
+};
+
+static LogSlot s_ring[ RING_SIZE ];
+static QAtomicInt s_enqueuePos;
+static QAtomicInt s_dropped;
+static QAtomicInt s_async;
+
+// Consumer side, only touched while holding s_drainMutex
+static QMutex s_drainMutex;
+static uint s_dequeuePos = 0;
+static qint64 s_logfileSize = 0;
+
+static QMutex s_wakeMutex;
+static QWaitCondition s_wakeCondition;
+static QAtomicInt s_writerSleeping;
+
+static QString s_logfilePath;
 
-    if ( debugLevel > LOGTHIRDPARTY )
-        toDisk = false;
+
+static QByteArray
+formatLine( const LogLine& line, bool console )
+{
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch( line.timestamp );
+    QByteArray out;
+    out.reserve( line.msg.size() + 64 );
 
     #ifdef LOG_SQL_QUERIES
-    if ( debugLevel == LOGSQL )
-        toDisk = true;
+    if ( !console && line.debugLevel == LOGSQL )
+        out += "TSQLQUERY: ";
     #endif
 
-    if ( toDisk || (int)debugLevel <= s_threshold )
+    if ( shutdownInProgress )
     {
-        QMutexLocker lock( &s_mutex );
+        // Do not use locales anymore in shutdown
+        if ( !console )
+        {
+            out += QByteArray::number( time.date().day() ) + "."
+                 + QByteArray::number( time.date().month() ) + "."
+                 + QByteArray::number( time.date().year() ) + " - ";
+        }
+        out += QByteArray::number( time.time().hour() ) + ":"
+             + QByteArray::number( time.time().minute() ) + ":"
+             + QByteArray::number( time.time().second() );
+    }
+    else
+    {
+        if ( !console )
+            out += time.date().toString().toUtf8() + " - ";
+        out += time.time().toString().toUtf8();
+    }
+
+    out += " [" + QByteArray::number( line.debugLevel ) + "]: ";
+    out += line.msg;
+    out += '\n';
+    return out;
+}
 
-        #ifdef LOG_SQL_QUERIES
-        if ( debugLevel == LOGSQL )
-            logfile << "TSQLQUERY: ";
-        #endif
 
-        if ( shutdownInProgress )
+static void
+trimLogfile()
+{
+    if ( QFileInfo( logFile() ).size() > LOGFILE_SIZE )
+    {
+        QByteArray lc;
         {
-            // Do not use locales anymore in shutdown
-            logfile << QDate::currentDate().day() << "."
-                    << QDate::currentDate().month() << "."
-                    << QDate::currentDate().year() << " - "
-                    << QTime::currentTime().hour() << ":"
-                    << QTime::currentTime().minute() << ":"
-                    << QTime::currentTime().second()
-                    << " [" << QString::number( debugLevel ).toUtf8().data() << "]: "
-                    << msg << endl;
+            QFile f( logFile() );
+            f.open( QIODevice::ReadOnly | QIODevice::Text );
+            f.seek( f.size() - ( LOGFILE_SIZE - ( LOGFILE_SIZE / 4 ) ) );
+            lc = f.readAll();
+            f.close();
         }
-        else
+
+        QFile::remove( logFile() );
+
         {
-            logfile << QDate::currentDate().toString().toUtf8().data()
-                    << " - "
-                    << QTime::currentTime().toString().toUtf8().data()
-                    << " [" << QString::number( debugLevel ).toUtf8().data() << "]: "
-                    << msg << endl;
+            QFile f( logFile() );
+            f.open( QIODevice::WriteOnly | QIODevice::Text );
+            f.write( lc );
+            f.close();
         }
+    }
+}
+
+
+/*
+ * Writes out everything currently in the ring as one batch.
+ * Must only be called while holding s_drainMutex.
+ */
+static void
+drainRing()
+{
+    QByteArray diskBatch;
+    QByteArray consoleBatch;
+
+    for ( int i = 0; i < RING_SIZE; i++ )
+    {
+        LogSlot& slot = s_ring[ s_dequeuePos & ( RING_SIZE - 1 ) ];
+        if ( (uint)slot.sequence.fetchAndAddAcquire( 0 ) != s_dequeuePos + 1 )
+            break;
+
+        if ( slot.line.toDisk )
+            diskBatch += formatLine( slot.line, false );
+        if ( slot.line.toConsole )
+            consoleBatch += formatLine( slot.line, true );
+        slot.line.msg.clear();
+
+        // Hand the slot back to the producer claiming it on the next lap
+        slot.sequence.fetchAndStoreRelease( s_dequeuePos + RING_SIZE );
+        s_dequeuePos++;
+    }
+
+    const int dropped = s_dropped.fetchAndStoreRelaxed( 0 );
+    if ( dropped > 0 )
+    {
+        LogLine line;
+        line.msg = "Logger: dropped " + QByteArray::number( dropped ) + " messages, the log buffer was full";
+        line.timestamp = QDateTime::currentMSecsSinceEpoch();
+        line.debugLevel = 0;
+        diskBatch += formatLine( line, false );
+        consoleBatch += formatLine( line, true );
+    }
+
+    if ( diskBatch.isEmpty() && consoleBatch.isEmpty() )
+        return;
 
+    QMutexLocker lock( &s_mutex );
+    if ( !diskBatch.isEmpty() )
+    {
+        logfile.write( diskBatch.constData(), diskBatch.size() );
         logfile.flush();
+
+        s_logfileSize += diskBatch.size();
+        if ( s_logfileSize > LOGFILE_MAX_SIZE )
+        {
+            logfile.close();
+            trimLogfile();
+            logfile.open( logFile().toUtf8().constData(), ios::app );
+            s_logfileSize = QFileInfo( logFile() ).size();
+        }
     }
 
-    if ( debugLevel <= LOGEXTRA || (int)debugLevel <= s_threshold )
+    if ( !consoleBatch.isEmpty() )
+    {
+        cout.write( consoleBatch.constData(), consoleBatch.size() );
+        cout.flush();
+    }
+}
+
+
+static bool
+ringEmpty()
+{
+    QMutexLocker lock( &s_drainMutex );
+    return (uint)s_ring[ s_dequeuePos & ( RING_SIZE - 1 ) ].sequence.fetchAndAddAcquire( 0 ) != s_dequeuePos + 1;
+}
+
+
+static void
+wakeWriter()
+{
+    // Only pay for the mutex if the writer actually went to sleep
+    if ( s_writerSleeping.fetchAndAddOrdered( 0 ) )
     {
-        QMutexLocker lock( &s_mutex );
+        QMutexLocker lock( &s_wakeMutex );
+        s_wakeCondition.wakeOne();
+    }
+}
 
-        if ( shutdownInProgress )
+
+static bool
+enqueue( const LogLine& line )
+{
+    for ( int attempt = 0; attempt < RING_RETRIES; attempt++ )
+    {
+        uint pos = s_enqueuePos.fetchAndAddRelaxed( 0 );
+        forever
         {
-            cout << QTime::currentTime().hour() << ":"
-                 << QTime::currentTime().minute() << ":"
-                 << QTime::currentTime().second()
-                 << " [" << QString::number( debugLevel ).toUtf8().data() << "]: "
-                 << msg << endl;
+            LogSlot& slot = s_ring[ pos & ( RING_SIZE - 1 ) ];
+            const int diff = (int)( (uint)slot.sequence.fetchAndAddAcquire( 0 ) - pos );
+
+            if ( diff == 0 )
+            {
+                if ( s_enqueuePos.testAndSetRelaxed( pos, pos + 1 ) )
+                {
+                    slot.line = line;
+                    slot.sequence.fetchAndStoreRelease( pos + 1 );
+                    wakeWriter();
+                    return true;
+                }
+            }
+            else if ( diff < 0 )
+            {
+                // The writer hasn't freed this slot yet, the ring is full
+                break;
+            }
+
+            pos = s_enqueuePos.fetchAndAddRelaxed( 0 );
         }
-        else
+
+        wakeWriter();
+        QThread::yieldCurrentThread();
+    }
+
+    s_dropped.ref();
+    return false;
+}
+
+
+class LogWriter : public QThread
+{
+public:
+    LogWriter() : m_stop( false ) {}
+
+    void stop()
+    {
         {
-            cout << QTime::currentTime().toString().toUtf8().data()
-                 << " [" << QString::number( debugLevel ).toUtf8().data() << "]: "
-                 << msg << endl;
+            QMutexLocker lock( &s_wakeMutex );
+            m_stop = true;
+            s_wakeCondition.wakeOne();
         }
+        wait();
+    }
+
+protected:
+    void run()
+    {
+        forever
+        {
+            {
+                QMutexLocker lock( &s_drainMutex );
+                drainRing();
+            }
+
+            QMutexLocker lock( &s_wakeMutex );
+            if ( m_stop )
+                break;
+
+            s_writerSleeping.fetchAndStoreOrdered( 1 );
+            if ( ringEmpty() )
+                s_wakeCondition.wait( &s_wakeMutex, 250 );
+            s_writerSleeping.fetchAndStoreOrdered( 0 );
+        }
+
+        QMutexLocker lock( &s_drainMutex );
+        drainRing();
+    }
+
+private:
+    bool m_stop;
+};
+
+static LogWriter* s_writer = 0;
+
+
+static void
+writeSync( const LogLine& line )
+{
+    QMutexLocker lock( &s_mutex );
+
+    if ( line.toDisk )
+    {
+        const QByteArray out = formatLine( line, false );
+        logfile.write( out.constData(), out.size() );
+        logfile.flush();
+    }
 
+    if ( line.toConsole )
+    {
+        const QByteArray out = formatLine( line, true );
+        cout.write( out.constData(), out.size() );
         cout.flush();
     }
 }
 
 
+static void
+log( const char *msg, unsigned int debugLevel, bool toDisk = true )
+{
+    if ( s_threshold < 0 )
+    {
+        if ( qApp->arguments().contains( "--verbose" ) )
+            s_threshold = LOGTHIRDPARTY;
+        else
+            #ifdef QT_NO_DEBUG
+            s_threshold = RELEASE_LEVEL_THRESHOLD;
+            #else
+            s_threshold = DEBUG_LEVEL_THRESHOLD;
+            #endif
+    }
+
+    if ( debugLevel > LOGTHIRDPARTY )
+        toDisk = false;
+
+    #ifdef LOG_SQL_QUERIES
+    if ( debugLevel == LOGSQL )
+        toDisk = true;
+    #endif
+
+    LogLine line;
+    line.toDisk = toDisk || (int)debugLevel <= s_threshold;
+    line.toConsole = debugLevel <= LOGEXTRA || (int)debugLevel <= s_threshold;
+    if ( !line.toDisk && !line.toConsole )
+        return;
+
+    line.msg = msg;
+    line.timestamp = QDateTime::currentMSecsSinceEpoch();
+    line.debugLevel = debugLevel;
+
+    // Formatting and disk I/O happen on the writer thread, unless it isn't running
+    if ( s_async.fetchAndAddAcquire( 0 ) )
+        enqueue( line );
+    else
+        writeSync( line );
+}
+
+
 void
 #if QT_VERSION >= QT_VERSION_CHECK( 5, 0, 0 )
 TomahawkLogHandler( QtMsgType type, const QMessageLogContext& context, const QString& msg )
@@ -133,8 +399,6 @@ TomahawkLogHandler( QtMsgType type, const QMessageLogContext& context, const QSt
 TomahawkLogHandler( QtMsgType type, const char* msg )
 #endif
 {
-    static QMutex s_mutex;
-
 #if QT_VERSION >= QT_VERSION_CHECK( 5, 0, 0 )
     QByteArray ba = msg.toUtf8();
     const char* message = ba.constData();
@@ -142,7 +406,6 @@ TomahawkLogHandler( QtMsgType type, const char* msg )
     const char* message = msg;
 #endif
 
-    QMutexLocker locker( &s_mutex );
     switch( type )
     {
         case QtDebugMsg:
@@ -159,6 +422,8 @@ TomahawkLogHandler( QtMsgType type, const char* msg )
 
         case QtFatalMsg:
             log( message, 0 );
+            // We're about to abort, get everything on disk first
+            flush();
             break;
     }
 }
@@ -167,35 +432,32 @@ TomahawkLogHandler( QtMsgType type, const char* msg )
 QString
 logFile()
 {
+    if ( !s_logfilePath.isEmpty() )
+        return s_logfilePath;
+
     return TomahawkUtils::appLogDir().filePath( "Tomahawk.log" );
 }
 
 
 void
-setupLogfile()
+setupLogfile( const QString& logfilePath )
 {
-    if ( QFileInfo( logFile() ).size() > LOGFILE_SIZE )
-    {
-        QByteArray lc;
-        {
-            QFile f( logFile() );
-            f.open( QIODevice::ReadOnly | QIODevice::Text );
-            f.seek( f.size() - ( LOGFILE_SIZE - ( LOGFILE_SIZE / 4 ) ) );
-            lc = f.readAll();
-            f.close();
-        }
+    s_logfilePath = logfilePath;
+    trimLogfile();
 
-        QFile::remove( logFile() );
+    logfile.open( logFile().toUtf8().constData(), ios::app );
+    s_logfileSize = QFileInfo( logFile() ).size();
 
-        {
-            QFile f( logFile() );
-            f.open( QIODevice::WriteOnly | QIODevice::Text );
-            f.write( lc );
-            f.close();
-        }
+    if ( !s_writer )
+    {
+        for ( int i = 0; i < RING_SIZE; i++ )
+            s_ring[ i ].sequence.fetchAndStoreRelaxed( i );
+
+        s_writer = new LogWriter();
+        s_writer->start( QThread::LowPriority );
+        s_async.fetchAndStoreRelease( 1 );
     }
 
-    logfile.open( logFile().toUtf8().constData(), ios::app );
 #if QT_VERSION >= QT_VERSION_CHECK( 5, 0, 0 )
     qInstallMessageHandler( TomahawkLogHandler );
 #else
@@ -203,6 +465,14 @@ setupLogfile()
 #endif
 }
 
+
+void
+flush()
+{
+    QMutexLocker lock( &s_drainMutex );
+    drainRing();
+}
+
 }
 
 using namespace Logger;
@@ -223,6 +493,17 @@ TLog::~TLog()
 void
 tLogNotifyShutdown()
 {
+    // From now on we write synchronously, make sure nothing queued gets lost
+    if ( s_writer )
+    {
+        s_async.fetchAndStoreRelease( 0 );
+        s_writer->stop();
+        delete s_writer;
+        s_writer = 0;
+
+        Logger::flush();
+    }
+
     QMutexLocker locker( &s_mutex );
     shutdownInProgress = true;
 }
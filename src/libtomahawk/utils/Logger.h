@@ -60,8 +60,18 @@ namespace Logger
     };
 
     DLLEXPORT void TomahawkLogHandler( QtMsgType type, const char* msg );
-    DLLEXPORT void setupLogfile();
+
+    /**
+     * Opens the logfile (the default one if logfilePath is empty) and starts
+     * the thread writing queued messages to it.
+     */
+    DLLEXPORT void setupLogfile( const QString& logfilePath = QString() );
     DLLEXPORT QString logFile();
+
+    /**
+     * Synchronously writes out all queued messages, e.g. before crashing.
+     */
+    DLLEXPORT void flush();
 }
 
 #define tLog Logger::TLog
@@ -19,15 +19,11 @@
 
 #include "ResultUrlChecker.h"
 
-#include <QNetworkAccessManager>
-#include <QNetworkRequest>
-#include <QUrl>
-
 #include "Query.h"
 #include "Result.h"
 #include "Source.h"
 #include "utils/Logger.h"
-#include "utils/NetworkAccessManager.h"
+#include "utils/UrlCheckCache.h"
 
 using namespace Tomahawk;
 
@@ -49,40 +45,56 @@ ResultUrlChecker::~ResultUrlChecker()
 void
 ResultUrlChecker::check()
 {
+    UrlCheckCache* cache = UrlCheckCache::instance();
+    connect( cache, SIGNAL( checked( QString, bool ) ), SLOT( onUrlChecked( QString, bool ) ) );
+
+    QStringList unknownUrls;
     foreach ( const result_ptr& result, m_results )
     {
-        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Checking http url:" << result->url();
-        QUrl url = QUrl::fromUserInput( result->url() );
-        if ( url.isEmpty() || !url.toString().startsWith( "http" ) )
-            continue;
-
-        NetworkReply* reply = new NetworkReply( Tomahawk::Utils::nam()->head( QNetworkRequest( url ) ) );
-        m_replies.insert( reply, result );
-        connect( reply, SIGNAL( finished() ), SLOT( headFinished() ) );
+        switch ( cache->state( result->url() ) )
+        {
+            case UrlCheckCache::Valid:
+                m_validResults << result;
+                break;
+
+            case UrlCheckCache::Invalid:
+                break;
+
+            case UrlCheckCache::Unknown:
+                m_pending.insert( result->url(), result );
+                unknownUrls << result->url();
+                break;
+        }
+    }
+
+    // Emit asynchronously, our creator hasn't had a chance to connect to done() yet
+    if ( m_pending.isEmpty() )
+    {
+        QMetaObject::invokeMethod( this, "done", Qt::QueuedConnection );
+        return;
     }
+
+    foreach ( const QString& url, unknownUrls )
+        cache->check( url );
 }
 
 
 void
-ResultUrlChecker::headFinished()
+ResultUrlChecker::onUrlChecked( const QString& url, bool valid )
 {
-    NetworkReply* r = qobject_cast<NetworkReply*>( sender() );
-    r->deleteLater();
-
-    if ( !m_replies.contains( r ) )
+    if ( !m_pending.contains( url ) )
         return;
 
-    result_ptr result = m_replies.value( r );
-    m_replies.remove( r );
-
-    if ( r->reply()->error() == QNetworkReply::NoError )
+    foreach ( const result_ptr& result, m_pending.values( url ) )
     {
-        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Found valid http url:" << result->url();
-        m_validResults << result;
+        if ( valid )
+            m_validResults << result;
     }
-    else
-        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Found invalid http url:" << result->url() << r->reply()->error();
+    m_pending.remove( url );
 
-    if ( m_replies.isEmpty() )
+    if ( m_pending.isEmpty() )
+    {
+        disconnect( UrlCheckCache::instance(), SIGNAL( checked( QString, bool ) ), this, SLOT( onUrlChecked( QString, bool ) ) );
         emit done();
+    }
 }
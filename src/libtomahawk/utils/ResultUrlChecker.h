@@ -21,10 +21,10 @@
 #define WEB_RESULT_HINT_CHECKER_H
 
 #include "Typedefs.h"
-#include "utils/NetworkReply.h"
 
+#include <QMultiHash>
 #include <QObject>
-#include <QSet>
+#include <QStringList>
 
 namespace Tomahawk
 {
@@ -45,13 +45,13 @@ signals:
 
 private slots:
     void check();
-    void headFinished();
+    void onUrlChecked( const QString& url, bool valid );
 
 private:
     query_ptr m_query;
     QList< result_ptr > m_results;
     QList< result_ptr > m_validResults;
-    QHash< NetworkReply*, Tomahawk::result_ptr > m_replies;
+    QMultiHash< QString, Tomahawk::result_ptr > m_pending;
 };
 
 }
@@ -0,0 +1,116 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+
+#define WHEEL_BITS 6
+#define WHEEL_SIZE ( 1 << WHEEL_BITS )
+#define WHEEL_MASK ( WHEEL_SIZE - 1 )
+
+using namespace Tomahawk;
+
+
+TimerWheel::TimerWheel( qint64 now, int resolution )
+    : m_resolution( qMax( 1, resolution ) )
+    , m_tick( now / m_resolution )
+    , m_count( 0 )
+    , m_fine( WHEEL_SIZE )
+    , m_coarse( WHEEL_SIZE )
+{
+}
+
+
+void
+TimerWheel::schedule( quint64 id, qint64 deadline, qint64 now )
+{
+    // Every slot is empty, stepping through them on the next advance() would be wasted time
+    if ( m_count == 0 )
+        m_tick = qMax( m_tick, now / m_resolution );
+
+    Entry entry;
+    entry.id = id;
+    entry.tick = ( deadline + m_resolution - 1 ) / m_resolution;
+
+    insert( entry );
+    m_count++;
+}
+
+
+void
+TimerWheel::insert( const Entry& entry )
+{
+    if ( entry.tick <= m_tick )
+        m_due << entry;
+    else if ( entry.tick - m_tick < WHEEL_SIZE )
+        m_fine[ entry.tick & WHEEL_MASK ] << entry;
+    else if ( ( entry.tick >> WHEEL_BITS ) - ( m_tick >> WHEEL_BITS ) < WHEEL_SIZE )
+        m_coarse[ ( entry.tick >> WHEEL_BITS ) & WHEEL_MASK ] << entry;
+    else
+        m_overflow << entry;
+}
+
+
+QList< quint64 >
+TimerWheel::advance( qint64 now )
+{
+    QList< quint64 > expired;
+    const qint64 target = now / m_resolution;
+
+    // Timeouts that were already due when they got scheduled
+    foreach ( const Entry& entry, m_due )
+        expired << entry.id;
+    m_due.clear();
+
+    while ( m_tick < target && m_count > expired.count() )
+    {
+        m_tick++;
+
+        // Whenever a wheel wraps around, the next coarser slot gets spread out below
+        if ( ( m_tick & WHEEL_MASK ) == 0 )
+        {
+            if ( ( ( m_tick >> WHEEL_BITS ) & WHEEL_MASK ) == 0 )
+            {
+                const QList< Entry > overflow = m_overflow;
+                m_overflow.clear();
+                foreach ( const Entry& entry, overflow )
+                    insert( entry );
+            }
+
+            const QList< Entry > coarse = m_coarse[ ( m_tick >> WHEEL_BITS ) & WHEEL_MASK ];
+            m_coarse[ ( m_tick >> WHEEL_BITS ) & WHEEL_MASK ].clear();
+            foreach ( const Entry& entry, coarse )
+                insert( entry );
+        }
+
+        QList< Entry >& slot = m_fine[ m_tick & WHEEL_MASK ];
+        foreach ( const Entry& entry, slot )
+            expired << entry.id;
+        slot.clear();
+
+        foreach ( const Entry& entry, m_due )
+            expired << entry.id;
+        m_due.clear();
+    }
+
+    // Nothing left to fire, skip ahead instead of stepping through empty slots
+    if ( m_tick < target )
+        m_tick = target;
+
+    m_count -= expired.count();
+    return expired;
+}
@@ -0,0 +1,89 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include "DllMacro.h"
+
+#include <QList>
+#include <QVector>
+
+namespace Tomahawk
+{
+
+/**
+ * Hierarchical timer wheel for large numbers of timeouts.
+ *
+ * Deadlines are rounded up to ticks of a fixed resolution. Timeouts within
+ * the next 64 ticks sit in the slot of their tick, those within 64 * 64
+ * ticks in a coarser second wheel and are moved down whenever the first
+ * wheel wraps around. Anything further out waits in an overflow list. Adding
+ * a timeout and advancing by one tick are therefore constant time, no matter
+ * how many timeouts are pending.
+ *
+ * Cancelling isn't supported, owners are expected to ignore ids of timeouts
+ * they don't care about anymore.
+ */
+class DLLEXPORT TimerWheel
+{
+public:
+    /**
+     * @param now current time in milliseconds
+     * @param resolution length of a tick in milliseconds
+     */
+    explicit TimerWheel( qint64 now, int resolution = 250 );
+
+    int resolution() const { return m_resolution; }
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    /**
+     * Adds a timeout for deadline. While the wheel is empty nobody needs to
+     * advance it, so it first skips ahead to now.
+     */
+    void schedule( quint64 id, qint64 deadline, qint64 now );
+
+    /**
+     * Moves the wheel forward to now and returns the ids of all timeouts
+     * which expired on the way.
+     */
+    QList< quint64 > advance( qint64 now );
+
+private:
+    struct Entry
+    {
+        quint64 id;
+        qint64 tick;
+    };
+
+    void insert( const Entry& entry );
+
+    int m_resolution;
+    qint64 m_tick;
+    int m_count;
+
+    QVector< QList< Entry > > m_fine;
+    QVector< QList< Entry > > m_coarse;
+    QList< Entry > m_overflow;
+    QList< Entry > m_due;
+};
+
+}
+
+#endif // TIMERWHEEL_H
@@ -22,35 +22,89 @@
 #include "Source.h"
 #include "utils/Logger.h"
 
+#include <QDataStream>
 #include <QDateTime>
-#include <QSettings>
 #include <QMutexLocker>
+#include <qtconcurrentrun.h>
+
+#define LOG_MAGIC 0x54434c47    // "TCLG"
+#define LOG_VERSION 1
+#define COMPACT_MIN_RECORDS 64  // Don't bother rewriting tiny logs
 
 using namespace TomahawkUtils;
 
 Cache*Cache::s_instance = 0;
-const int Cache::s_cacheVersion = 1;
+const int Cache::s_cacheVersion = 2;
+
+
+namespace
+{
+    // Identifiers and keys are free-form, join them with a char neither of them contains
+    inline QString
+    entryKey( const QString& identifier, const QString& key )
+    {
+        return identifier + QChar( 0 ) + key;
+    }
+
+
+    void
+    writeHeader( QIODevice* device )
+    {
+        QDataStream stream( device );
+        stream.setVersion( QDataStream::Qt_4_8 );
+        stream << (quint32)LOG_MAGIC << (quint32)LOG_VERSION;
+    }
+
+
+    // The value is wrapped in its own byte array, so a record we fail to
+    // deserialize (e.g. an unregistered type) doesn't break the rest of the log
+    QByteArray
+    serializeRecord( const QString& entryKey, const CacheData& data )
+    {
+        QByteArray value;
+        {
+            QDataStream stream( &value, QIODevice::WriteOnly );
+            stream.setVersion( QDataStream::Qt_4_8 );
+            stream << data.data;
+        }
+
+        QByteArray record;
+        QDataStream stream( &record, QIODevice::WriteOnly );
+        stream.setVersion( QDataStream::Qt_4_8 );
+        stream << entryKey << data.maxAge << value;
+        return record;
+    }
+}
 
 
 Cache* Cache::instance()
 {
     if ( !s_instance )
-        s_instance = new Cache();
+    {
+        const QString cacheDir = TomahawkSettings::instance()->storageCacheLocation() + "/GenericCache/";
+        if ( TomahawkSettings::instance()->genericCacheVersion() < s_cacheVersion )
+        {
+            TomahawkUtils::removeDirectory( cacheDir );
+            TomahawkSettings::instance()->setGenericCacheVersion( s_cacheVersion );
+        }
+
+        s_instance = new Cache( cacheDir );
+    }
 
     return s_instance;
 }
 
 
-Cache::Cache()
-    : QObject( 0 )
-    , m_cacheBaseDir( TomahawkSettings::instance()->storageCacheLocation() + "/GenericCache/" )
-    , m_cacheManifest( m_cacheBaseDir + "cachemanifest.ini", QSettings::IniFormat )
+Cache::Cache( const QString& cacheDir, QObject* parent )
+    : QObject( parent )
+    , m_cacheBaseDir( cacheDir )
+    , m_logRecords( 0 )
+    , m_compacting( false )
 {
-    if ( TomahawkSettings::instance()->genericCacheVersion() < s_cacheVersion )
-    {
-        TomahawkUtils::removeDirectory( m_cacheBaseDir );
-        TomahawkSettings::instance()->setGenericCacheVersion( s_cacheVersion );
-    }
+    if ( !m_cacheBaseDir.endsWith( '/' ) )
+        m_cacheBaseDir += '/';
+
+    load();
 
     m_pruneTimer.setInterval( 300000 );
     m_pruneTimer.setSingleShot( false );
@@ -61,116 +115,256 @@ Cache::Cache()
 
 Cache::~Cache()
 {
+    m_compaction.waitForFinished();
+
+    QMutexLocker logLocker( &m_logMutex );
+    m_log.close();
+
+    if ( s_instance == this )
+        s_instance = 0;
+}
+
+
+Cache::Shard&
+Cache::shardFor( const QString& entryKey )
+{
+    return m_shards[ qHash( entryKey ) % s_shardCount ];
 }
 
 
 void
-Cache::pruneTimerFired()
+Cache::load()
 {
-    QMutexLocker mutex_locker( &m_mutex );
+    QDir().mkpath( m_cacheBaseDir );
+    m_log.setFileName( m_cacheBaseDir + "cache.log" );
+    if ( !m_log.open( QIODevice::ReadWrite ) )
+    {
+        tLog() << Q_FUNC_INFO << "Could not open cache log:" << m_log.fileName() << m_log.errorString();
+        return;
+    }
 
-    qDebug() << Q_FUNC_INFO << "Pruning tomahawkcache";
-    qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    const qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    qint64 validSize = 0;
+
+    QDataStream stream( &m_log );
+    stream.setVersion( QDataStream::Qt_4_8 );
 
-    QVariantList clients = m_cacheManifest.value( "clients" ).toList();
-    foreach ( const QVariant& client, clients )
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if ( stream.status() == QDataStream::Ok && magic == LOG_MAGIC && version == LOG_VERSION )
     {
-        const QString client_identifier = client.toString();
-        const QString cache_dir = m_cacheBaseDir + client_identifier;
+        validSize = m_log.pos();
 
-        QSettings cached_settings( cache_dir, QSettings::IniFormat );
-        const QStringList keys = cached_settings.allKeys();
-        foreach ( const QString& key, keys )
+        while ( !stream.atEnd() )
         {
-            CacheData data = cached_settings.value( key ).value<TomahawkUtils::CacheData>();
+            QString key;
+            CacheData data;
+            QByteArray value;
+            stream >> key >> data.maxAge >> value;
+            if ( stream.status() != QDataStream::Ok )
+                break;
+
+            validSize = m_log.pos();
+            m_logRecords++;
+
+            // Later records supersede earlier ones, even if they already expired
+            Shard& shard = shardFor( key );
             if ( data.maxAge < currentMSecsSinceEpoch )
             {
-                cached_settings.remove( key );
-                tLog() << Q_FUNC_INFO << "Removed stale entry:" << client_identifier << key;
+                shard.entries.remove( key );
+                continue;
             }
+
+            QDataStream valueStream( value );
+            valueStream.setVersion( QDataStream::Qt_4_8 );
+            valueStream >> data.data;
+            if ( valueStream.status() != QDataStream::Ok )
+            {
+                tLog() << Q_FUNC_INFO << "Skipping unreadable entry:" << key;
+                shard.entries.remove( key );
+                continue;
+            }
+
+            shard.entries.insert( key, data );
         }
-        cached_settings.sync();
-        if ( cached_settings.allKeys().size() == 0 )
-            removeClient( client_identifier );
     }
+
+    if ( validSize < m_log.size() )
+    {
+        tLog() << Q_FUNC_INFO << "Dropping broken tail of cache log at" << validSize;
+        m_log.resize( validSize );
+    }
+
+    m_log.seek( validSize );
+    if ( validSize == 0 )
+        writeHeader( &m_log );
+    m_log.flush();
 }
 
 
-QVariant
-Cache::getData( const QString& identifier, const QString& key )
+void
+Cache::appendRecord( const QByteArray& record )
 {
-    QMutexLocker mutex_locker( &m_mutex );
+    QMutexLocker logLocker( &m_logMutex );
+    if ( !m_log.isOpen() )
+        return;
+
+    m_log.write( record );
+    m_log.flush();
+    m_logRecords++;
 
-    const QString cacheDir = m_cacheBaseDir + identifier;
-    QSettings cached_settings( cacheDir, QSettings::IniFormat );
+    if ( m_compacting )
+        m_compactionTail += record;
+}
 
-    if ( cached_settings.contains( key ) )
+
+void
+Cache::pruneTimerFired()
+{
+    qDebug() << Q_FUNC_INFO << "Pruning tomahawkcache";
+    qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+
+    int liveEntries = 0;
+    for ( int i = 0; i < s_shardCount; i++ )
     {
-        CacheData data = cached_settings.value( key ).value<TomahawkUtils::CacheData>();
+        QMutexLocker shardLocker( &m_shards[ i ].mutex );
 
-        if ( data.maxAge < QDateTime::currentMSecsSinceEpoch() )
+        QHash< QString, CacheData >::iterator it = m_shards[ i ].entries.begin();
+        while ( it != m_shards[ i ].entries.end() )
         {
-            cached_settings.remove( key );
-            tLog() << Q_FUNC_INFO << "Removed stale entry:" << identifier << key;
-            return QVariant();
+            if ( it.value().maxAge < currentMSecsSinceEpoch )
+                it = m_shards[ i ].entries.erase( it );
+            else
+                ++it;
         }
-        tDebug() << Q_FUNC_INFO << "Fetched data for" << identifier << key;
-        return data.data;
 
+        liveEntries += m_shards[ i ].entries.count();
     }
-    tDebug() << Q_FUNC_INFO << "No such key" << key;
-    return QVariant();
+
+    QMutexLocker logLocker( &m_logMutex );
+    if ( !m_compacting && m_logRecords > COMPACT_MIN_RECORDS && m_logRecords > 2 * liveEntries )
+        m_compaction = QtConcurrent::run( this, &Cache::compact );
 }
 
 
 void
-Cache::putData( const QString& identifier, qint64 maxAge, const QString& key, const QVariant& value )
+Cache::compact()
 {
-    QMutexLocker mutex_locker( &m_mutex );
+    int recordsAtStart;
+    {
+        QMutexLocker logLocker( &m_logMutex );
+        if ( m_compacting || !m_log.isOpen() )
+            return;
 
-    const QString cacheDir = m_cacheBaseDir + identifier;
-    addClient( identifier );
-    QSettings cached_settings( cacheDir, QSettings::IniFormat );
-    cached_settings.setValue( key, QVariant::fromValue( CacheData( QDateTime::currentMSecsSinceEpoch() + maxAge, value ) ) );
-    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Storing from client" << identifier << maxAge << key;
+        // From now on every appended record also ends up in the tail, so
+        // whatever gets stored while we take the snapshot below isn't lost
+        m_compacting = true;
+        m_compactionTail.clear();
+        recordsAtStart = m_logRecords;
+    }
+
+    const QString compactedPath = m_cacheBaseDir + "cache.log.compact";
+    QFile compacted( compactedPath );
+    if ( !compacted.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        tLog() << Q_FUNC_INFO << "Could not write compacted cache log:" << compacted.errorString();
+
+        QMutexLocker logLocker( &m_logMutex );
+        m_compacting = false;
+        m_compactionTail.clear();
+        return;
+    }
+
+    writeHeader( &compacted );
+
+    const qlonglong currentMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    int records = 0;
+    for ( int i = 0; i < s_shardCount; i++ )
+    {
+        QHash< QString, CacheData > entries;
+        {
+            QMutexLocker shardLocker( &m_shards[ i ].mutex );
+            entries = m_shards[ i ].entries;
+        }
+
+        QHash< QString, CacheData >::const_iterator it = entries.constBegin();
+        for ( ; it != entries.constEnd(); ++it )
+        {
+            if ( it.value().maxAge < currentMSecsSinceEpoch )
+                continue;
+
+            compacted.write( serializeRecord( it.key(), it.value() ) );
+            records++;
+        }
+    }
+
+    QMutexLocker logLocker( &m_logMutex );
+    compacted.write( m_compactionTail );
+    records += m_logRecords - recordsAtStart;
+    compacted.close();
+
+    const QString logPath = m_log.fileName();
+    m_log.close();
+    if ( compacted.error() == QFile::NoError )
+    {
+        QFile::remove( logPath );
+        if ( compacted.rename( logPath ) )
+            m_logRecords = records;
+    }
+    else
+    {
+        tLog() << Q_FUNC_INFO << "Failed writing compacted cache log:" << compacted.errorString();
+        QFile::remove( compactedPath );
+    }
+
+    if ( !m_log.open( QIODevice::WriteOnly | QIODevice::Append ) )
+        tLog() << Q_FUNC_INFO << "Could not reopen cache log:" << m_log.errorString();
+
+    m_compacting = false;
+    m_compactionTail.clear();
 }
 
 
-void
-Cache::addClient( const QString& identifier )
+QVariant
+Cache::getData( const QString& identifier, const QString& key )
 {
-    QVariantList clients = m_cacheManifest.value( "clients" ).toList();
-    foreach ( const QVariant& client, clients )
+    const QString k = entryKey( identifier, key );
+    Shard& shard = shardFor( k );
+    QMutexLocker shardLocker( &shard.mutex );
+
+    QHash< QString, CacheData >::iterator it = shard.entries.find( k );
+    if ( it == shard.entries.end() )
     {
-        const QString client_identifier = client.toString();
-        if ( identifier == client_identifier )
-            return;
+        tDebug() << Q_FUNC_INFO << "No such key" << key;
+        return QVariant();
+    }
+
+    if ( it.value().maxAge < QDateTime::currentMSecsSinceEpoch() )
+    {
+        // No need to log the removal, expired records are skipped when loading
+        shard.entries.erase( it );
+        tLog() << Q_FUNC_INFO << "Removed stale entry:" << identifier << key;
+        return QVariant();
     }
 
-    tLog() << Q_FUNC_INFO << "adding client" << identifier;
-    clients.append( identifier );
-    m_cacheManifest.setValue( "clients", clients );
-    m_cacheManifest.sync();
+    tDebug() << Q_FUNC_INFO << "Fetched data for" << identifier << key;
+    return it.value().data;
 }
 
 
 void
-Cache::removeClient( const QString& identifier )
+Cache::putData( const QString& identifier, qint64 maxAge, const QString& key, const QVariant& value )
 {
-    QVariantList clients = m_cacheManifest.value( "clients" ).toList();
-    QVariantList::iterator it = clients.begin();
-    while ( it != clients.end() )
-    {
-        const QString client_identifier = it->toString();
-        if ( identifier == client_identifier )
-        {
-            tLog() << Q_FUNC_INFO << "removing client" << identifier;
-            clients.erase( it );
-            break;
-        }
-        ++it;
-    }
+    const QString k = entryKey( identifier, key );
+    const CacheData data( QDateTime::currentMSecsSinceEpoch() + maxAge, value );
+    const QByteArray record = serializeRecord( k, data );
+
+    // Append while holding the shard lock, so the log order of records for
+    // the same key matches the order they were applied in memory
+    Shard& shard = shardFor( k );
+    QMutexLocker shardLocker( &shard.mutex );
+    shard.entries.insert( k, data );
+    appendRecord( record );
 
-    m_cacheManifest.setValue( "clients", clients );
-    m_cacheManifest.sync();
+    tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Storing from client" << identifier << maxAge << key;
 }
@@ -22,8 +22,10 @@
 #include "DllMacro.h"
 #include "utils/TomahawkUtils.h"
 
+#include <QFile>
+#include <QFuture>
+#include <QHash>
 #include <QMutex>
-#include <QSettings>
 #include <QObject>
 #include <QTimer>
 #include <QDir>
@@ -54,6 +56,11 @@ struct CacheData
  *
  * Structure is a basic key-value store with associated max lifetime in
  * milliseconds.
+ *
+ * All entries are kept in memory, spread over a number of separately locked
+ * shards so concurrent callers rarely wait on each other. Every put is
+ * appended to a log file which gets replayed on startup and is rewritten in
+ * the background once it contains too many superseded or expired records.
  */
 class DLLEXPORT Cache : public QObject
 {
@@ -61,6 +68,12 @@ Q_OBJECT
 
 public:
     static Cache* instance();
+
+    /**
+     * Opens the cache stored in cacheDir. Use instance() unless you need a
+     * separate cache, e.g. in tests.
+     */
+    explicit Cache( const QString& cacheDir, QObject* parent = 0 );
     virtual ~Cache();
 
     /**
@@ -80,11 +93,22 @@ public:
      */
     QVariant getData( const QString& identifier, const QString& key );
 
+    /**
+     * Rewrites the log so it only contains live entries.
+     * Usually started in the background by the prune timer.
+     */
+    void compact();
+
 private slots:
     void pruneTimerFired();
 
 private:
-    Cache();
+    struct Shard
+    {
+        QMutex mutex;
+        QHash< QString, CacheData > entries;
+    };
+
     static Cache* s_instance;
 
     /**
@@ -93,23 +117,33 @@ private:
      * increase this number.
      */
     static const int s_cacheVersion;
+    static const int s_shardCount = 16;
+
+    Shard& shardFor( const QString& entryKey );
 
     /**
-     * Adds a client to the manifest.
-     * Does not lock the mutex.
+     * Replays the log into memory, skipping expired entries.
+     * A broken tail, e.g. from a crash while writing, gets cut off.
      */
-    void addClient( const QString& identifier );
+    void load();
 
     /**
-     * Removes a client to the manifest.
-     * Does not lock the mutex.
+     * Appends a serialized record to the log.
+     * Has to be called while holding the lock of the record's shard.
      */
-    void removeClient( const QString& identifier );
+    void appendRecord( const QByteArray& record );
 
     QString m_cacheBaseDir;
-    QSettings m_cacheManifest;
+    Shard m_shards[ s_shardCount ];
+
+    QMutex m_logMutex;
+    QFile m_log;
+    int m_logRecords;
+    bool m_compacting;
+    QByteArray m_compactionTail; // records written while compacting
+    QFuture< void > m_compaction;
+
     QTimer m_pruneTimer;
-    QMutex m_mutex;
 };
 
 }
@@ -0,0 +1,213 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UrlCheckCache.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QThread>
+#include <QUrl>
+
+#include "utils/Logger.h"
+#include "utils/NetworkAccessManager.h"
+#include "utils/NetworkReply.h"
+
+#define VALID_TTL 30 * 60 * 1000
+#define INVALID_TTL 5 * 60 * 1000
+#define MAX_CHECKS_PER_HOST 4
+#define MAX_CACHE_ENTRIES 20000
+
+using namespace Tomahawk;
+
+UrlCheckCache* UrlCheckCache::s_instance = 0;
+
+
+UrlCheckCache*
+UrlCheckCache::instance()
+{
+    static QMutex instanceMutex;
+    QMutexLocker lock( &instanceMutex );
+
+    if ( !s_instance )
+        s_instance = new UrlCheckCache();
+
+    return s_instance;
+}
+
+
+UrlCheckCache::UrlCheckCache()
+    : QObject( 0 )
+{
+    // Network checks have to happen in a thread with a running event loop,
+    // no matter which thread first asked for the cache.
+    if ( thread() != QCoreApplication::instance()->thread() )
+        moveToThread( QCoreApplication::instance()->thread() );
+}
+
+
+UrlCheckCache::~UrlCheckCache()
+{
+    qDeleteAll( m_replies.keys() );
+}
+
+
+UrlCheckCache::UrlState
+UrlCheckCache::state( const QString& url ) const
+{
+    QMutexLocker lock( &m_mutex );
+
+    QHash< QString, CacheEntry >::const_iterator it = m_cache.constFind( url );
+    if ( it == m_cache.constEnd() || it->expires < QDateTime::currentMSecsSinceEpoch() )
+        return Unknown;
+
+    return it->valid ? Valid : Invalid;
+}
+
+
+void
+UrlCheckCache::check( const QString& url )
+{
+    QMetaObject::invokeMethod( this, "enqueue", Qt::AutoConnection, Q_ARG( QString, url ) );
+}
+
+
+void
+UrlCheckCache::invalidate( const QString& url )
+{
+    QMutexLocker lock( &m_mutex );
+    m_cache.remove( url );
+}
+
+
+void
+UrlCheckCache::enqueue( const QString& url )
+{
+    const UrlState cached = state( url );
+    if ( cached != Unknown )
+    {
+        emit checked( url, cached == Valid );
+        return;
+    }
+
+    // Someone already asked for this url, they'll all get the same answer
+    if ( m_pending.contains( url ) )
+        return;
+
+    const QUrl qurl = QUrl::fromUserInput( url );
+    if ( qurl.isEmpty() || !qurl.scheme().startsWith( "http" ) )
+    {
+        store( url, false );
+        emit checked( url, false );
+        return;
+    }
+
+    m_pending.insert( url );
+    m_queued[ qurl.host() ].enqueue( url );
+    startNext( qurl.host() );
+}
+
+
+void
+UrlCheckCache::startNext( const QString& host )
+{
+    while ( m_running.value( host ) < MAX_CHECKS_PER_HOST && !m_queued.value( host ).isEmpty() )
+    {
+        const QString url = m_queued[ host ].dequeue();
+        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Checking http url:" << url;
+
+        NetworkReply* reply = new NetworkReply( Tomahawk::Utils::nam()->head( QNetworkRequest( QUrl::fromUserInput( url ) ) ) );
+        m_replies.insert( reply, url );
+        m_running[ host ]++;
+        connect( reply, SIGNAL( finished() ), SLOT( headFinished() ) );
+    }
+
+    if ( m_queued.value( host ).isEmpty() )
+        m_queued.remove( host );
+    if ( m_running.value( host ) == 0 )
+        m_running.remove( host );
+}
+
+
+void
+UrlCheckCache::headFinished()
+{
+    NetworkReply* r = qobject_cast< NetworkReply* >( sender() );
+    r->deleteLater();
+
+    if ( !m_replies.contains( r ) )
+        return;
+
+    const QString url = m_replies.take( r );
+    const QString host = QUrl::fromUserInput( url ).host();
+    m_running[ host ]--;
+    m_pending.remove( url );
+
+    const bool valid = ( r->reply() && r->reply()->error() == QNetworkReply::NoError );
+    if ( valid )
+        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Found valid http url:" << url;
+    else
+        tDebug( LOGVERBOSE ) << Q_FUNC_INFO << "Found invalid http url:" << url;
+
+    store( url, valid );
+    emit checked( url, valid );
+
+    startNext( host );
+}
+
+
+void
+UrlCheckCache::store( const QString& url, bool valid )
+{
+    QMutexLocker lock( &m_mutex );
+
+    if ( m_cache.count() >= MAX_CACHE_ENTRIES )
+        pruneExpired();
+
+    CacheEntry entry;
+    entry.valid = valid;
+    entry.expires = QDateTime::currentMSecsSinceEpoch() + ( valid ? VALID_TTL : INVALID_TTL );
+    m_cache.insert( url, entry );
+}
+
+
+void
+UrlCheckCache::pruneExpired()
+{
+    // Expects m_mutex to be locked
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QHash< QString, CacheEntry >::iterator it = m_cache.begin();
+    while ( it != m_cache.end() )
+    {
+        if ( it->expires < now )
+            it = m_cache.erase( it );
+        else
+            ++it;
+    }
+
+    // Still full, drop an arbitrary half rather than growing without bounds
+    if ( m_cache.count() < MAX_CACHE_ENTRIES )
+        return;
+
+    it = m_cache.begin();
+    while ( m_cache.count() > MAX_CACHE_ENTRIES / 2 && it != m_cache.end() )
+        it = m_cache.erase( it );
+}
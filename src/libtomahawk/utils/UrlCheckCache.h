@@ -0,0 +1,115 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef URLCHECKCACHE_H
+#define URLCHECKCACHE_H
+
+#include "DllMacro.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QSet>
+#include <QString>
+
+class NetworkReply;
+
+namespace Tomahawk
+{
+
+/**
+ * Shared cache for HTTP url validity checks.
+ *
+ * Results of HEAD requests are remembered for a limited time (valid urls
+ * longer than invalid ones), concurrent checks for the same url are merged
+ * into a single request and the number of requests running against one host
+ * at the same time is capped.
+ *
+ * state() may be called from any thread. Network checks are always run in
+ * the main thread, check() can be called from any thread as well.
+ */
+class DLLEXPORT UrlCheckCache : public QObject
+{
+Q_OBJECT
+
+public:
+    enum UrlState
+    {
+        Unknown = 0,
+        Valid,
+        Invalid
+    };
+
+    static UrlCheckCache* instance();
+    virtual ~UrlCheckCache();
+
+    /**
+     * Returns the cached state of url, or Unknown if it hasn't been checked
+     * yet or the cached answer has expired.
+     */
+    UrlState state( const QString& url ) const;
+
+    /**
+     * Schedules a HEAD check for url. checked() is always emitted in the main
+     * thread once the answer is known. A fresh cached answer is emitted right
+     * away, without asking the network again.
+     */
+    void check( const QString& url );
+
+    /**
+     * Forget everything we know about url.
+     */
+    void invalidate( const QString& url );
+
+signals:
+    void checked( const QString& url, bool valid );
+
+private slots:
+    void enqueue( const QString& url );
+    void headFinished();
+
+private:
+    struct CacheEntry
+    {
+        bool valid;
+        qint64 expires;
+    };
+
+    UrlCheckCache();
+
+    void store( const QString& url, bool valid );
+    void startNext( const QString& host );
+    void pruneExpired();
+
+    static UrlCheckCache* s_instance;
+
+    mutable QMutex m_mutex; // for m_cache
+    QHash< QString, CacheEntry > m_cache;
+
+    // urls that are either queued or currently being checked
+    QSet< QString > m_pending;
+    // host -> queued urls and host -> number of running requests
+    QHash< QString, QQueue< QString > > m_queued;
+    QHash< QString, int > m_running;
+    QHash< NetworkReply*, QString > m_replies;
+};
+
+}
+
+#endif // URLCHECKCACHE_H
@@ -0,0 +1,151 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A script resolver for the tests: answers every query after a fixed delay,
+ * given in milliseconds as first argument. Queries for the track "never"
+ * don't get an answer at all. Queries are answered independently of each
+ * other, like a resolver waiting for a web service would. Every answer
+ * carries how many answers were still pending when it went out, itself
+ * included, so tests can tell how many requests were out at once.
+ */
+
+#include "utils/Json.h"
+
+#include <QDateTime>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QThread>
+#include <QWaitCondition>
+#include <QtEndian>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static QMutex s_mutex;
+static QWaitCondition s_wakeUp;
+static QMap< QPair< qint64, int >, QVariantMap > s_replies; // by due time, then in order
+static int s_sequence = 0;
+static bool s_quit = false;
+
+
+static void
+writeFrame( const QByteArray& msg )
+{
+    quint32 len;
+    qToBigEndian( msg.length(), (uchar*) &len );
+    fwrite( &len, 4, 1, stdout );
+    fwrite( msg.constData(), msg.length(), 1, stdout );
+    fflush( stdout );
+}
+
+
+static void
+schedule( qint64 due, const QVariantMap& msg )
+{
+    QMutexLocker locker( &s_mutex );
+    s_replies.insert( qMakePair( due, s_sequence++ ), msg );
+    s_wakeUp.wakeAll();
+}
+
+
+class Reader : public QThread
+{
+public:
+    explicit Reader( int latency ) : m_latency( latency ) {}
+
+protected:
+    void run()
+    {
+        quint32 len;
+        while ( fread( &len, 4, 1, stdin ) == 1 )
+        {
+            QByteArray frame( qFromBigEndian( len ), 0 );
+            if ( frame.length() && fread( frame.data(), frame.length(), 1, stdin ) != 1 )
+                break;
+
+            const QVariantMap m = TomahawkUtils::parseJson( frame ).toMap();
+            const QString msgtype = m.value( "_msgtype" ).toString();
+
+            if ( msgtype == "quit" )
+                break;
+
+            if ( msgtype == "config" )
+            {
+                QVariantMap settings;
+                settings[ "_msgtype" ] = "settings";
+                settings[ "name" ] = "Stand-in";
+                settings[ "weight" ] = 50;
+                settings[ "timeout" ] = 5;
+                schedule( 0, settings );
+            }
+            else if ( msgtype == "rq" && m.value( "track" ).toString() != "never" )
+            {
+                QVariantMap result;
+                result[ "artist" ] = m.value( "artist" );
+                result[ "track" ] = m.value( "track" );
+                result[ "url" ] = QString( "http://localhost/%1" ).arg( m.value( "qid" ).toString() );
+                result[ "mimetype" ] = "audio/mpeg";
+                result[ "duration" ] = 180;
+
+                QVariantMap results;
+                results[ "_msgtype" ] = "results";
+                results[ "qid" ] = m.value( "qid" );
+                results[ "results" ] = QVariantList() << result;
+                schedule( QDateTime::currentMSecsSinceEpoch() + m_latency, results );
+            }
+        }
+
+        QMutexLocker locker( &s_mutex );
+        s_quit = true;
+        s_wakeUp.wakeAll();
+    }
+
+private:
+    int m_latency;
+};
+
+
+int
+main( int argc, char** argv )
+{
+    Reader reader( argc > 1 ? atoi( argv[1] ) : 50 );
+    reader.start();
+
+    QMutexLocker locker( &s_mutex );
+    while ( !s_quit )
+    {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        while ( !s_replies.isEmpty() && s_replies.begin().key().first <= now )
+        {
+            QVariantMap msg = s_replies.take( s_replies.begin().key() );
+            msg[ "pending" ] = s_replies.count() + 1;
+            writeFrame( TomahawkUtils::toJson( msg ) );
+        }
+
+        if ( s_replies.isEmpty() )
+            s_wakeUp.wait( &s_mutex );
+        else
+            s_wakeUp.wait( &s_mutex, s_replies.begin().key().first - now );
+    }
+
+    locker.unlock();
+    reader.wait();
+    return 0;
+}
@@ -0,0 +1,260 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTCACHE_H
+#define TOMAHAWK_TESTCACHE_H
+
+#include <QtTest>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSettings>
+#include <QThreadPool>
+
+#include "libtomahawk/utils/TomahawkCache.h"
+#include "libtomahawk/utils/TomahawkUtils.h"
+
+/**
+ * Common interface for the backends compared in the benchmark.
+ */
+class CacheBackend
+{
+public:
+    virtual ~CacheBackend() {}
+    virtual QVariant get( const QString& identifier, const QString& key ) = 0;
+    virtual void put( const QString& identifier, qint64 maxAge, const QString& key, const QVariant& value ) = 0;
+};
+
+
+/**
+ * The previous implementation: one INI file per client, parsed on every
+ * access under a single mutex.
+ */
+class SettingsCacheBackend : public CacheBackend
+{
+public:
+    SettingsCacheBackend( const QString& dir ) : m_dir( dir ) {}
+
+    QVariant get( const QString& identifier, const QString& key )
+    {
+        QMutexLocker locker( &m_mutex );
+        QSettings settings( m_dir + identifier, QSettings::IniFormat );
+        if ( !settings.contains( key ) )
+            return QVariant();
+
+        const QVariantList entry = settings.value( key ).toList();
+        if ( entry.value( 0 ).toLongLong() < QDateTime::currentMSecsSinceEpoch() )
+            return QVariant();
+
+        return entry.value( 1 );
+    }
+
+    void put( const QString& identifier, qint64 maxAge, const QString& key, const QVariant& value )
+    {
+        QMutexLocker locker( &m_mutex );
+        QSettings settings( m_dir + identifier, QSettings::IniFormat );
+        settings.setValue( key, QVariantList() << QDateTime::currentMSecsSinceEpoch() + maxAge << value );
+    }
+
+private:
+    QString m_dir;
+    QMutex m_mutex;
+};
+
+
+class LogCacheBackend : public CacheBackend
+{
+public:
+    LogCacheBackend( const QString& dir ) : m_cache( dir ) {}
+
+    QVariant get( const QString& identifier, const QString& key ) { return m_cache.getData( identifier, key ); }
+    void put( const QString& identifier, qint64 maxAge, const QString& key, const QVariant& value ) { m_cache.putData( identifier, maxAge, key, value ); }
+
+private:
+    TomahawkUtils::Cache m_cache;
+};
+
+
+/**
+ * Runs a mix of nine lookups per store against a backend.
+ */
+class CacheWorker : public QRunnable
+{
+public:
+    CacheWorker( CacheBackend* backend, int worker, int operations )
+        : m_backend( backend )
+        , m_worker( worker )
+        , m_operations( operations )
+    {}
+
+    void run()
+    {
+        const QString identifier = QString( "client%1" ).arg( m_worker % 4 );
+        for ( int i = 0; i < m_operations; i++ )
+        {
+            const QString key = QString( "key%1" ).arg( ( i * 7 + m_worker ) % 100 );
+            if ( i % 10 == 0 )
+                m_backend->put( identifier, 3600000, key, QString( "value %1" ).arg( i ) );
+            else
+                m_backend->get( identifier, key );
+        }
+    }
+
+private:
+    CacheBackend* m_backend;
+    int m_worker;
+    int m_operations;
+};
+
+
+class TestCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_dir;
+
+    QString logPath() const { return m_dir + "cache.log"; }
+
+private slots:
+    void init()
+    {
+        m_dir = QDir::tempPath() + QString( "/tomahawk-testcache-%1/" ).arg( QCoreApplication::applicationPid() );
+        TomahawkUtils::removeDirectory( m_dir );
+        QDir().mkpath( m_dir );
+    }
+
+    void cleanup()
+    {
+        TomahawkUtils::removeDirectory( m_dir );
+    }
+
+    void testPersistence()
+    {
+        {
+            TomahawkUtils::Cache cache( m_dir );
+            cache.putData( "client", 3600000, "a", QString( "first" ) );
+            cache.putData( "client", 3600000, "b", QStringList() << "x" << "y" );
+            cache.putData( "client", 3600000, "a", QString( "second" ) );
+            cache.putData( "other", 3600000, "a", 42 );
+            QCOMPARE( cache.getData( "client", "a" ).toString(), QString( "second" ) );
+        }
+
+        TomahawkUtils::Cache cache( m_dir );
+        QCOMPARE( cache.getData( "client", "a" ).toString(), QString( "second" ) );
+        QCOMPARE( cache.getData( "client", "b" ).toStringList(), QStringList() << "x" << "y" );
+        QCOMPARE( cache.getData( "other", "a" ).toInt(), 42 );
+        QVERIFY( !cache.getData( "other", "b" ).isValid() );
+    }
+
+    void testExpiry()
+    {
+        {
+            TomahawkUtils::Cache cache( m_dir );
+            cache.putData( "client", 3600000, "a", QString( "value" ) );
+            cache.putData( "client", -1, "a", QString( "gone" ) );
+            cache.putData( "client", -1, "b", QString( "gone" ) );
+            QVERIFY( !cache.getData( "client", "a" ).isValid() );
+            QVERIFY( !cache.getData( "client", "b" ).isValid() );
+        }
+
+        // the expired record supersedes the older one
+        TomahawkUtils::Cache cache( m_dir );
+        QVERIFY( !cache.getData( "client", "a" ).isValid() );
+    }
+
+    void testCompaction()
+    {
+        {
+            TomahawkUtils::Cache cache( m_dir );
+            for ( int i = 0; i < 500; i++ )
+                cache.putData( "client", 3600000, "a", i );
+            cache.putData( "client", -1, "b", QString( "gone" ) );
+
+            const qint64 sizeBefore = QFileInfo( logPath() ).size();
+            cache.compact();
+            QVERIFY( QFileInfo( logPath() ).size() < sizeBefore / 100 );
+
+            // still appending to the new log
+            cache.putData( "client", 3600000, "c", QString( "after" ) );
+        }
+
+        TomahawkUtils::Cache cache( m_dir );
+        QCOMPARE( cache.getData( "client", "a" ).toInt(), 499 );
+        QVERIFY( !cache.getData( "client", "b" ).isValid() );
+        QCOMPARE( cache.getData( "client", "c" ).toString(), QString( "after" ) );
+    }
+
+    void testBrokenTail()
+    {
+        {
+            TomahawkUtils::Cache cache( m_dir );
+            cache.putData( "client", 3600000, "a", QString( "value" ) );
+        }
+
+        // a record cut short by a crash
+        QFile log( logPath() );
+        QVERIFY( log.open( QIODevice::WriteOnly | QIODevice::Append ) );
+        log.write( "\x00\x00\x01", 3 );
+        log.close();
+
+        {
+            TomahawkUtils::Cache cache( m_dir );
+            QCOMPARE( cache.getData( "client", "a" ).toString(), QString( "value" ) );
+            cache.putData( "client", 3600000, "b", QString( "more" ) );
+        }
+
+        TomahawkUtils::Cache cache( m_dir );
+        QCOMPARE( cache.getData( "client", "a" ).toString(), QString( "value" ) );
+        QCOMPARE( cache.getData( "client", "b" ).toString(), QString( "more" ) );
+    }
+
+    void benchmarkConcurrentAccess_data()
+    {
+        QTest::addColumn< bool >( "log" );
+        QTest::newRow( "settings" ) << false;
+        QTest::newRow( "log" ) << true;
+    }
+
+    void benchmarkConcurrentAccess()
+    {
+        QFETCH( bool, log );
+
+        CacheBackend* backend;
+        if ( log )
+            backend = new LogCacheBackend( m_dir );
+        else
+            backend = new SettingsCacheBackend( m_dir );
+
+        for ( int i = 0; i < 100; i++ )
+            backend->put( QString( "client%1" ).arg( i % 4 ), 3600000, QString( "key%1" ).arg( i ), i );
+
+        QThreadPool pool;
+        pool.setMaxThreadCount( 8 );
+        QBENCHMARK
+        {
+            for ( int i = 0; i < 8; i++ )
+                pool.start( new CacheWorker( backend, i, 500 ) );
+            pool.waitForDone();
+        }
+
+        delete backend;
+    }
+};
+
+#endif // TOMAHAWK_TESTCACHE_H
@@ -0,0 +1,185 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTCOVERLOADER_H
+#define TOMAHAWK_TESTCOVERLOADER_H
+
+#include <QtTest>
+#include <QBuffer>
+#include <QPainter>
+#include <QPixmapCache>
+
+#include "utils/CoverLoader.h"
+
+class CoverReceiver : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void coverChanged();
+};
+
+
+class TestCoverLoader : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDir m_dir;
+
+    // A full size cover like the ones coming from the info system
+    static QByteArray jpeg( int width, int height, const QColor& color )
+    {
+        QImage image( width, height, QImage::Format_RGB32 );
+        image.fill( color.rgb() );
+
+        QPainter p( &image );
+        p.fillRect( 0, 0, width / 2, height / 2, Qt::white );
+        p.end();
+
+        QByteArray data;
+        QBuffer buffer( &data );
+        buffer.open( QIODevice::WriteOnly );
+        image.save( &buffer, "JPEG", 90 );
+        return data;
+    }
+
+private slots:
+    void init()
+    {
+        m_dir = QDir( QDir::temp().absoluteFilePath( "tomahawk-test-thumbnails" ) );
+        m_dir.removeRecursively();
+        QPixmapCache::clear();
+    }
+
+    void cleanup()
+    {
+        m_dir.removeRecursively();
+    }
+
+    void testLoad()
+    {
+        Tomahawk::CoverLoader loader;
+        loader.setThumbnailDir( m_dir );
+
+        CoverReceiver receiver;
+        QSignalSpy spy( &receiver, SIGNAL( coverChanged() ) );
+
+        const QByteArray data = jpeg( 1200, 900, Qt::blue );
+        loader.load( "cover_100", data, QSize( 100, 100 ), &receiver );
+        loader.load( "cover_100", data, QSize( 100, 100 ), &receiver );
+
+        QTRY_COMPARE( spy.count(), 1 );
+
+        // cropped to a square, then scaled
+        QPixmap pixmap;
+        QVERIFY( QPixmapCache::find( "cover_100", &pixmap ) );
+        QCOMPARE( pixmap.size(), QSize( 100, 100 ) );
+        QCOMPARE( m_dir.entryList( QDir::Files ).count(), 1 );
+    }
+
+    void testFromDisk()
+    {
+        const QByteArray data = jpeg( 800, 800, Qt::red );
+        CoverReceiver receiver;
+        {
+            Tomahawk::CoverLoader loader;
+            loader.setThumbnailDir( m_dir );
+            QSignalSpy spy( &loader, SIGNAL( loaded( QString ) ) );
+            loader.load( "first", data, QSize( 64, 64 ), &receiver );
+            QTRY_COMPARE( spy.count(), 1 );
+        }
+        const QStringList thumbnails = m_dir.entryList( QDir::Files );
+        QCOMPARE( thumbnails.count(), 1 );
+
+        // Another session picks up the thumbnail of the same cover
+        QPixmapCache::clear();
+        Tomahawk::CoverLoader loader;
+        loader.setThumbnailDir( m_dir );
+        QSignalSpy spy( &loader, SIGNAL( loaded( QString ) ) );
+        loader.load( "second", data, QSize( 64, 64 ), &receiver );
+        QTRY_COMPARE( spy.count(), 1 );
+
+        QPixmap pixmap;
+        QVERIFY( QPixmapCache::find( "second", &pixmap ) );
+        QCOMPARE( pixmap.size(), QSize( 64, 64 ) );
+        QCOMPARE( m_dir.entryList( QDir::Files ), thumbnails );
+    }
+
+    void testUndecodable()
+    {
+        Tomahawk::CoverLoader loader;
+        loader.setThumbnailDir( m_dir );
+
+        CoverReceiver receiver;
+        QSignalSpy spy( &receiver, SIGNAL( coverChanged() ) );
+        loader.load( "broken", "not an image", QSize( 64, 64 ), &receiver );
+
+        QTest::qWait( 200 );
+        QCOMPARE( spy.count(), 0 );
+        QVERIFY( m_dir.entryList( QDir::Files ).isEmpty() );
+    }
+
+    void benchmarkThumbnail_data()
+    {
+        QTest::addColumn< bool >( "fromDisk" );
+        QTest::newRow( "decode full size cover" ) << false;
+        QTest::newRow( "thumbnail from disk" ) << true;
+    }
+
+    // Grid of 40 covers at 160x160, as an album view shows them
+    void benchmarkThumbnail()
+    {
+        QFETCH( bool, fromDisk );
+
+        QList< QByteArray > covers;
+        for ( int i = 0; i < 40; i++ )
+            covers << jpeg( 1000, 1000, QColor::fromHsv( i * 9, 200, 200 ) );
+
+        Tomahawk::CoverLoader loader;
+        loader.setThumbnailDir( m_dir );
+        CoverReceiver receiver;
+        QSignalSpy spy( &loader, SIGNAL( loaded( QString ) ) );
+
+        if ( fromDisk )
+        {
+            for ( int i = 0; i < covers.count(); i++ )
+                loader.load( QString( "warmup_%1" ).arg( i ), covers.at( i ), QSize( 160, 160 ), &receiver );
+            QTRY_COMPARE_WITH_TIMEOUT( spy.count(), covers.count(), 30000 );
+        }
+
+        int round = 0;
+        QBENCHMARK
+        {
+            // Without thumbnails on disk, every cover has to be decoded
+            if ( !fromDisk )
+            {
+                m_dir.removeRecursively();
+                loader.setThumbnailDir( m_dir );
+            }
+
+            spy.clear();
+            for ( int i = 0; i < covers.count(); i++ )
+                loader.load( QString( "cover_%1_%2" ).arg( round ).arg( i ), covers.at( i ), QSize( 160, 160 ), &receiver );
+            QTRY_COMPARE_WITH_TIMEOUT( spy.count(), covers.count(), 30000 );
+            round++;
+        }
+    }
+};
+
+#endif // TOMAHAWK_TESTCOVERLOADER_H
@@ -22,7 +22,21 @@
 #include <QtTest>
 
 #include "database/Database.h"
+#include "database/DatabaseCommand_GenericSelect.h"
+#include "database/DatabaseCommand_LoadPlaylistEntries.h"
 #include "database/DatabaseCommand_LogPlayback.h"
+#include "database/DatabaseCommand_Replay.h"
+#include "database/DatabaseImpl.h"
+#include "utils/Json.h"
+#include "Pipeline.h"
+#include "Source.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#define MIGRATION_SCRIPTS "@PROJECT_SOURCE_DIR@/data/sql"
 
 
 class TestDatabaseCommand : public Tomahawk::DatabaseCommand
@@ -31,12 +45,202 @@ Q_OBJECT
     virtual QString commandname() const { return "TestCommand"; }
 };
 
+class TestLoadPlaylistEntries : public Tomahawk::DatabaseCommand_LoadPlaylistEntries
+{
+public:
+    explicit TestLoadPlaylistEntries( const QString& revision )
+        : Tomahawk::DatabaseCommand_LoadPlaylistEntries( revision )
+    {}
+
+    QStringList guids() const { return m_guids; }
+    QMap< QString, Tomahawk::plentry_ptr > entries() const { return m_entrymap; }
+};
+
+class TestReplayCommand : public Tomahawk::DatabaseCommand
+{
+Q_OBJECT
+
+public:
+    // only a peer's commands get replayed
+    TestReplayCommand( int value, const Tomahawk::source_ptr& source ) : m_value( value ), m_notified( 1 ) { setSource( source ); }
+
+    virtual QString commandname() const { return "testreplay"; }
+
+    // negative values fail after having written to the database
+    virtual void exec( Tomahawk::DatabaseImpl* dbi )
+    {
+        TomahawkSqlQuery query = dbi->newquery();
+        query.prepare( "INSERT INTO replay_test(v) VALUES(?)" );
+        query.addBindValue( m_value );
+        query.exec();
+
+        if ( m_value < 0 )
+            throw "negative value";
+    }
+
+    virtual void postCommitHook() { s_hooks++; s_notified += m_notified; }
+
+    virtual bool coalescePostCommit( Tomahawk::DatabaseCommand* later )
+    {
+        if ( !qobject_cast< TestReplayCommand* >( later ) )
+            return false;
+
+        m_notified++;
+        return true;
+    }
+
+    static int s_hooks;
+    static int s_notified;
+
+private:
+    int m_value;
+    int m_notified;
+};
+
+int TestReplayCommand::s_hooks = 0;
+int TestReplayCommand::s_notified = 0;
+
+// Counts what a GenericSelect emits without keeping it, can cancel it after a few chunks
+class GenericSelectReceiver : public QObject
+{
+Q_OBJECT
+
+public:
+    explicit GenericSelectReceiver( Tomahawk::DatabaseCommand_GenericSelect* cmd, int cancelAfter = -1 )
+        : rows( 0 )
+        , columns( 0 )
+        , firstRow( -1 )
+        , done( 0 )
+        , m_cmd( cmd )
+        , m_cancelAfter( cancelAfter )
+    {
+        connect( cmd, SIGNAL( rawData( QList< QStringList > ) ), SLOT( onRawData( QList< QStringList > ) ) );
+        connect( cmd, SIGNAL( done() ), SLOT( onDone() ) );
+        m_timer.start();
+    }
+
+    QList< int > chunks;
+    int rows;
+    int columns;
+    qint64 firstRow; // ms until the first row arrived
+    int done;
+
+private slots:
+    void onRawData( const QList< QStringList >& data )
+    {
+        if ( firstRow < 0 && !data.isEmpty() )
+            firstRow = m_timer.elapsed();
+
+        chunks << data.count();
+        rows += data.count();
+        if ( !data.isEmpty() )
+            columns = data.first().count();
+
+        if ( chunks.count() == m_cancelAfter )
+            m_cmd->cancel();
+    }
+
+    void onDone()
+    {
+        done++;
+    }
+
+private:
+    Tomahawk::DatabaseCommand_GenericSelect* m_cmd;
+    int m_cancelAfter;
+    QElapsedTimer m_timer;
+};
+
 class TestDatabase : public QObject
 {
     Q_OBJECT
 private:
     Tomahawk::Database* db;
 
+    static void fillSelectTest( Tomahawk::DatabaseImpl* impl, int size )
+    {
+        impl->newquery().exec( "DROP TABLE IF EXISTS select_test" );
+        impl->newquery().exec( "CREATE TABLE select_test(id INTEGER PRIMARY KEY, name TEXT, v INTEGER)" );
+
+        impl->database().transaction();
+        TomahawkSqlQuery query = impl->newquery();
+        query.prepare( "INSERT INTO select_test(id, name, v) VALUES(?, ?, ?)" );
+        for ( int i = 0; i < size; i++ )
+        {
+            query.bindValue( 0, i );
+            query.bindValue( 1, QString( "Row %1" ).arg( i ) );
+            query.bindValue( 2, i % 100 );
+            query.exec();
+        }
+        impl->database().commit();
+    }
+
+    // Names of the filtertest tracks matching filter
+    static QStringList filteredTracks( Tomahawk::DatabaseImpl* impl, const QString& filter )
+    {
+        const QString filterSql = impl->collectionFilterSql( filter );
+
+        TomahawkSqlQuery query = impl->newquery();
+        query.exec( "SELECT track.name FROM file, file_join, artist, track "
+                    "LEFT JOIN album ON album.id = file_join.album "
+                    "WHERE file.id = file_join.file AND artist.id = file_join.artist AND track.id = file_join.track "
+                    "AND file.url LIKE 'file:///filtertest/%'" + filterSql + " ORDER BY track.name" );
+
+        QStringList names;
+        while ( query.next() )
+            names << query.value( 0 ).toString();
+
+        return names;
+    }
+
+    static void logPlayback( Tomahawk::DatabaseImpl* impl, const Tomahawk::source_ptr& source, uint playtime, uint secsPlayed )
+    {
+        Tomahawk::DatabaseCommand_LogPlayback cmd;
+        cmd.setSource( source );
+        cmd.setArtist( "Rollup Artist" );
+        cmd.setTrack( "Rollup Track" );
+        cmd.setPlaytime( playtime );
+        cmd.setSecsPlayed( secsPlayed );
+        cmd.setAction( Tomahawk::DatabaseCommand_LogPlayback::Finished );
+
+        impl->database().transaction();
+        cmd.exec( impl );
+        impl->database().commit();
+    }
+
+    // Runs a migration script statement by statement, like DatabaseImpl::updateSchema
+    static void migrate( QSqlDatabase& database, const QString& script )
+    {
+        QFile file( QString( MIGRATION_SCRIPTS "/%1" ).arg( script ) );
+        QVERIFY( file.open( QIODevice::ReadOnly ) );
+
+        foreach ( QString statement, QString::fromUtf8( file.readAll() ).split( ";", QString::SkipEmptyParts ) )
+        {
+            statement.replace( QRegExp( "--[^\\n]*" ), QString() );
+            if ( statement.trimmed().isEmpty() )
+                continue;
+
+            QSqlQuery query( database );
+            QVERIFY2( query.exec( statement ), qPrintable( query.lastError().text() ) );
+        }
+    }
+
+    // Peak resident memory of the process in kB, -1 where we can't tell
+    static qint64 peakMemory()
+    {
+        QFile status( "/proc/self/status" );
+        if ( !status.open( QIODevice::ReadOnly ) )
+            return -1;
+
+        foreach ( const QByteArray& line, status.readAll().split( '\n' ) )
+        {
+            if ( line.startsWith( "VmHWM:" ) )
+                return line.mid( 6 ).trimmed().split( ' ' ).first().toLongLong();
+        }
+
+        return -1;
+    }
+
 private slots:
     void initTestCase()
     {
@@ -73,6 +277,404 @@ private slots:
         TestDatabaseCommand* tCmd = qobject_cast< TestDatabaseCommand* >( command.data() );
         QVERIFY( tCmd );
     }
+
+    void testDirectoryFilter()
+    {
+        QCOMPARE( Tomahawk::DatabaseImpl::directoryOfUrl( "file:///music/foo/bar.mp3" ), QString( "file:///music/foo" ) );
+
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        impl->database().transaction();
+
+        TomahawkSqlQuery query = impl->newquery();
+        query.exec( "DELETE FROM file WHERE source IS NULL AND url LIKE 'file:///dirtest/%'" );
+        query.prepare( "INSERT INTO file(source, url, dir, size, mtime) VALUES(NULL, ?, ?, 0, 0)" );
+        const QStringList urls = QStringList() << "file:///dirtest/foo/a.mp3"
+                                               << "file:///dirtest/foo/sub/b.mp3"
+                                               << "file:///dirtest/foobar/c.mp3"
+                                               << "file:///dirtest/d.mp3";
+        foreach ( const QString& url, urls )
+        {
+            query.bindValue( 0, url );
+            query.bindValue( 1, Tomahawk::DatabaseImpl::directoryOfUrl( url ) );
+            query.exec();
+        }
+        impl->database().commit();
+
+        // the directory and its subdirectories, but not a sibling sharing its prefix
+        QStringList found;
+        query.exec( "SELECT url FROM file WHERE source IS NULL" + Tomahawk::DatabaseImpl::directoryFilterSql( "file:///dirtest/foo/" ) + " ORDER BY url" );
+        while ( query.next() )
+            found << query.value( 0 ).toString();
+
+        QCOMPARE( found, QStringList() << "file:///dirtest/foo/a.mp3" << "file:///dirtest/foo/sub/b.mp3" );
+    }
+
+    void testCollectionFilter()
+    {
+        Tomahawk::DatabaseImpl* impl = db->impl();
+
+        TomahawkSqlQuery query = impl->newquery();
+        query.exec( "DELETE FROM file WHERE source IS NULL AND url LIKE 'file:///filtertest/%'" );
+        query.exec( "DELETE FROM artist WHERE sortname = 'wombatfilter'" );
+
+        // loads the name index
+        impl->collectionFilterSql( "anything" );
+
+        impl->database().transaction();
+        const int zebra = impl->artistId( "Zebrafilter Band", true );
+        const int quokka = impl->artistId( "Quokkafilter", true );
+
+        // Added behind the index' back, like by a transaction that was still running while it loaded
+        query.exec( "INSERT INTO artist(name, sortname) VALUES('Wombatfilter', 'wombatfilter')" );
+        const int wombat = query.lastInsertId().toInt();
+
+        QList< QVariantList > files;
+        files << ( QVariantList() << zebra << impl->trackId( zebra, "Striped Song", true ) << QVariant( QVariant::Int ) );
+        files << ( QVariantList() << quokka << impl->trackId( quokka, "Happy Song", true ) << impl->albumId( quokka, "Smiles", true ) );
+        files << ( QVariantList() << wombat << impl->trackId( wombat, "Burrow Song", true ) << QVariant( QVariant::Int ) );
+
+        TomahawkSqlQuery joinQuery = impl->newquery();
+        query.prepare( "INSERT INTO file(source, url, size, mtime) VALUES(NULL, ?, 0, 0)" );
+        joinQuery.prepare( "INSERT INTO file_join(file, artist, track, album) VALUES(?, ?, ?, ?)" );
+        for ( int i = 0; i < files.count(); i++ )
+        {
+            query.bindValue( 0, QString( "file:///filtertest/%1.mp3" ).arg( i ) );
+            query.exec();
+
+            joinQuery.bindValue( 0, query.lastInsertId() );
+            for ( int j = 0; j < 3; j++ )
+                joinQuery.bindValue( j + 1, files.at( i ).at( j ) );
+            joinQuery.exec();
+        }
+        impl->database().commit();
+
+        QCOMPARE( filteredTracks( impl, "zebrafilter" ), QStringList() << "Striped Song" );
+        QCOMPARE( filteredTracks( impl, "song quokkafilter" ), QStringList() << "Happy Song" );
+        QCOMPARE( filteredTracks( impl, "smiles" ), QStringList() << "Happy Song" );
+        QCOMPARE( filteredTracks( impl, "song" ), QStringList() << "Burrow Song" << "Happy Song" << "Striped Song" );
+        QCOMPARE( filteredTracks( impl, "wombatfilter" ), QStringList() << "Burrow Song" );
+        QCOMPARE( filteredTracks( impl, "sm quokkafilter" ), QStringList() << "Happy Song" );
+        QVERIFY( filteredTracks( impl, "nosuchnamefilter" ).isEmpty() );
+    }
+
+    void testPlaybackRollup()
+    {
+        Tomahawk::DatabaseImpl* impl = db->impl();
+
+        TomahawkSqlQuery query = impl->newquery();
+        query.exec( "INSERT OR IGNORE INTO source(name, friendlyname) VALUES('rolluptest', 'rolluptest')" );
+        query.exec( "SELECT id FROM source WHERE name = 'rolluptest'" );
+        QVERIFY( query.next() );
+        const int sourceId = query.value( 0 ).toInt();
+        query.exec( QString( "DELETE FROM playback_log WHERE source = %1" ).arg( sourceId ) );
+        query.exec( QString( "DELETE FROM playback_log_daily WHERE source = %1" ).arg( sourceId ) );
+
+        Tomahawk::source_ptr source( new Tomahawk::Source( sourceId, "rolluptest" ) );
+        const uint day = 16000;
+        logPlayback( impl, source, day * 86400 + 100, 60 );
+        logPlayback( impl, source, day * 86400 + 86399, 90 );
+        logPlayback( impl, source, ( day + 1 ) * 86400, 30 );
+
+        // two plays on the first day add up in one row, the next day gets its own
+        query.exec( QString( "SELECT day, plays, secs_played FROM playback_log_daily WHERE source = %1 ORDER BY day" ).arg( sourceId ) );
+        QVERIFY( query.next() );
+        QCOMPARE( query.value( 0 ).toUInt(), day );
+        QCOMPARE( query.value( 1 ).toInt(), 2 );
+        QCOMPARE( query.value( 2 ).toInt(), 150 );
+        QVERIFY( query.next() );
+        QCOMPARE( query.value( 0 ).toUInt(), day + 1 );
+        QCOMPARE( query.value( 1 ).toInt(), 1 );
+        QCOMPARE( query.value( 2 ).toInt(), 30 );
+        QVERIFY( !query.next() );
+
+        // Local plays are keyed as source 0, the key holds for them, too
+        query.exec( "SELECT track, artist FROM playback_log_daily LIMIT 1" );
+        QVERIFY( query.next() );
+        const QString values = QString( "VALUES(0, %1, %2, 1, 1, 1)" ).arg( query.value( 0 ).toInt() ).arg( query.value( 1 ).toInt() );
+        impl->newquery().exec( "DELETE FROM playback_log_daily WHERE source = 0 AND day = 1" );
+
+        QSqlQuery insert( impl->database() );
+        QVERIFY( insert.exec( "INSERT INTO playback_log_daily(source, track, artist, day, plays, secs_played) " + values ) );
+        QVERIFY( !insert.exec( "INSERT INTO playback_log_daily(source, track, artist, day, plays, secs_played) " + values ) );
+        impl->newquery().exec( "DELETE FROM playback_log_daily WHERE source = 0 AND day = 1" );
+    }
+
+    void testPlaybackRollupMigration()
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase( "QSQLITE", "rollupmigration" );
+        database.setDatabaseName( ":memory:" );
+        QVERIFY( database.open() );
+
+        {
+            QSqlQuery query( database );
+            query.exec( "CREATE TABLE settings(k TEXT NOT NULL PRIMARY KEY, v TEXT NOT NULL DEFAULT '')" );
+            query.exec( "INSERT INTO settings(k, v) VALUES('schema_version', '31')" );
+            query.exec( "CREATE TABLE track(id INTEGER PRIMARY KEY, artist INTEGER, name TEXT)" );
+            query.exec( "CREATE TABLE playback_log(id INTEGER PRIMARY KEY, source INTEGER, track INTEGER, playtime INTEGER, secs_played INTEGER)" );
+            query.exec( "INSERT INTO track(id, artist, name) VALUES(1, 10, 'a')" );
+            query.exec( "INSERT INTO track(id, artist, name) VALUES(2, 20, 'b')" );
+            query.exec( "INSERT INTO playback_log(source, track, playtime, secs_played) VALUES(NULL, 1, 86400 * 5 + 10, 100)" );
+            query.exec( "INSERT INTO playback_log(source, track, playtime, secs_played) VALUES(NULL, 1, 86400 * 5 + 20, 50)" );
+            query.exec( "INSERT INTO playback_log(source, track, playtime, secs_played) VALUES(3, 1, 86400 * 5 + 30, 10)" );
+            query.exec( "INSERT INTO playback_log(source, track, playtime, secs_played) VALUES(NULL, 2, 86400 * 6, 20)" );
+        }
+
+        // the backfill groups the log per source, track and day
+        migrate( database, "dbmigrate-31_to_32.sql" );
+        {
+            QSqlQuery query( database );
+            query.exec( "SELECT source, track, artist, day, plays, secs_played FROM playback_log_daily ORDER BY track, source" );
+            QVERIFY( query.next() );
+            QCOMPARE( query.value( 0 ).toInt(), 0 );
+            QCOMPARE( query.value( 2 ).toInt(), 10 );
+            QCOMPARE( query.value( 3 ).toInt(), 5 );
+            QCOMPARE( query.value( 4 ).toInt(), 2 );
+            QCOMPARE( query.value( 5 ).toInt(), 150 );
+            QVERIFY( query.next() );
+            QCOMPARE( query.value( 0 ).toInt(), 3 );
+            QCOMPARE( query.value( 4 ).toInt(), 1 );
+            QVERIFY( query.next() );
+            QCOMPARE( query.value( 1 ).toInt(), 2 );
+            QCOMPARE( query.value( 3 ).toInt(), 6 );
+            QVERIFY( !query.next() );
+
+            // one row per source, track and day
+            QVERIFY( !query.exec( "INSERT INTO playback_log_daily(source, track, artist, day) VALUES(0, 1, 10, 5)" ) );
+
+            query.exec( "SELECT v FROM settings WHERE k = 'schema_version'" );
+            QVERIFY( query.next() );
+            QCOMPARE( query.value( 0 ).toString(), QString( "32" ) );
+        }
+
+        database.close();
+        database = QSqlDatabase();
+        QSqlDatabase::removeDatabase( "rollupmigration" );
+    }
+
+    void testReplay()
+    {
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        impl->newquery().exec( "CREATE TABLE IF NOT EXISTS replay_test(v INTEGER)" );
+        impl->newquery().exec( "DELETE FROM replay_test" );
+        TestReplayCommand::s_hooks = TestReplayCommand::s_notified = 0;
+        const Tomahawk::source_ptr source( new Tomahawk::Source( 1, "replaytest" ) );
+
+        QList< Tomahawk::dbcmd_ptr > cmds;
+        for ( int i = 1; i <= 10; i++ )
+            cmds << Tomahawk::dbcmd_ptr( new TestReplayCommand( i == 5 ? -1 : i, source ) );
+
+        Tomahawk::DatabaseCommand_Replay replay( cmds );
+        impl->database().transaction();
+        replay.exec( impl );
+        impl->database().commit();
+        replay.postCommit();
+
+        // the failing command was rolled back on its own, the batch stopped there
+        QCOMPARE( replay.failed(), 6 );
+        TomahawkSqlQuery query = impl->newquery();
+        query.exec( "SELECT count(*), min(v), max(v) FROM replay_test" );
+        QVERIFY( query.next() );
+        QCOMPARE( query.value( 0 ).toInt(), 4 );
+        QCOMPARE( query.value( 1 ).toInt(), 1 );
+        QCOMPARE( query.value( 2 ).toInt(), 4 );
+
+        // a single hook covered all four applied commands
+        QCOMPARE( TestReplayCommand::s_hooks, 1 );
+        QCOMPARE( TestReplayCommand::s_notified, 4 );
+    }
+
+    void testGenericSelectPages()
+    {
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        fillSelectTest( impl, 25 );
+
+        Tomahawk::DatabaseCommand_GenericSelect all( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        GenericSelectReceiver allReceiver( &all );
+        all.exec( impl );
+        QCOMPARE( allReceiver.chunks, QList< int >() << 25 );
+        QCOMPARE( allReceiver.columns, 3 );
+        QCOMPARE( allReceiver.done, 1 );
+
+        Tomahawk::DatabaseCommand_GenericSelect paged( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        paged.setPageSize( 10 );
+        GenericSelectReceiver pagedReceiver( &paged );
+        paged.exec( impl );
+        QCOMPARE( pagedReceiver.chunks, QList< int >() << 10 << 10 << 5 );
+        QCOMPARE( pagedReceiver.done, 1 );
+
+        // Nothing but done() if the last page was full
+        Tomahawk::DatabaseCommand_GenericSelect even( "SELECT id, name, v FROM select_test WHERE id < 20", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        even.setPageSize( 10 );
+        GenericSelectReceiver evenReceiver( &even );
+        even.exec( impl );
+        QCOMPARE( evenReceiver.chunks, QList< int >() << 10 << 10 );
+        QCOMPARE( evenReceiver.done, 1 );
+    }
+
+    void testGenericSelectCancel()
+    {
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        fillSelectTest( impl, 25 );
+
+        Tomahawk::DatabaseCommand_GenericSelect cmd( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        cmd.setPageSize( 10 );
+        GenericSelectReceiver receiver( &cmd, 1 );
+        cmd.exec( impl );
+        QVERIFY( cmd.isCancelled() );
+        QCOMPARE( receiver.chunks, QList< int >() << 10 );
+        QCOMPARE( receiver.done, 0 );
+
+        // Cancelled before it ran
+        Tomahawk::DatabaseCommand_GenericSelect early( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        GenericSelectReceiver earlyReceiver( &early );
+        early.cancel();
+        early.exec( impl );
+        QVERIFY( earlyReceiver.chunks.isEmpty() );
+        QCOMPARE( earlyReceiver.done, 0 );
+    }
+
+    // Time to the first row and peak memory for a select over a million rows, in pages
+    // and in one go. The paged one runs first, the peak only ever goes up.
+    void benchmarkGenericSelect()
+    {
+        if ( qgetenv( "TOMAHAWK_LARGE_BENCHMARKS" ).isEmpty() )
+        {
+            qDebug() << "Builds a table of a million rows, set TOMAHAWK_LARGE_BENCHMARKS to run it";
+            return;
+        }
+
+        const int size = 1000000;
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        fillSelectTest( impl, size );
+
+        const qint64 base = peakMemory();
+        QElapsedTimer timer;
+
+        Tomahawk::DatabaseCommand_GenericSelect paged( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        paged.setPageSize( 500 );
+        GenericSelectReceiver pagedReceiver( &paged );
+        timer.start();
+        paged.exec( impl );
+        const qint64 pagedTime = timer.elapsed();
+        const qint64 pagedPeak = peakMemory();
+
+        Tomahawk::DatabaseCommand_GenericSelect all( "SELECT id, name, v FROM select_test", Tomahawk::DatabaseCommand_GenericSelect::Track, true );
+        GenericSelectReceiver allReceiver( &all );
+        timer.restart();
+        all.exec( impl );
+        const qint64 allTime = timer.elapsed();
+        const qint64 allPeak = peakMemory();
+
+        QCOMPARE( pagedReceiver.rows, size );
+        QCOMPARE( allReceiver.rows, size );
+
+        qDebug() << "paged: first row after" << pagedReceiver.firstRow << "ms, all after" << pagedTime << "ms, peak +" << pagedPeak - base << "kB";
+        qDebug() << "all at once: first row after" << allReceiver.firstRow << "ms, all after" << allTime << "ms, peak +" << allPeak - base << "kB";
+        QVERIFY( pagedReceiver.firstRow < allReceiver.firstRow );
+
+        impl->newquery().exec( "DROP TABLE select_test" );
+    }
+
+    void benchmarkReplay_data()
+    {
+        QTest::addColumn< bool >( "batched" );
+        QTest::newRow( "one transaction per command" ) << false;
+        QTest::newRow( "batched replay" ) << true;
+    }
+
+    // Applying 2000 ops, one commit each like the worker does for single
+    // commands, against a single replay batch
+    void benchmarkReplay()
+    {
+        QFETCH( bool, batched );
+        const int size = 2000;
+
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        impl->newquery().exec( "CREATE TABLE IF NOT EXISTS replay_test(v INTEGER)" );
+
+        QBENCHMARK
+        {
+            const Tomahawk::source_ptr source( new Tomahawk::Source( 1, "replaytest" ) );
+            QList< Tomahawk::dbcmd_ptr > cmds;
+            for ( int i = 0; i < size; i++ )
+                cmds << Tomahawk::dbcmd_ptr( new TestReplayCommand( i, source ) );
+
+            if ( batched )
+            {
+                Tomahawk::DatabaseCommand_Replay replay( cmds );
+                impl->database().transaction();
+                replay.exec( impl );
+                impl->database().commit();
+                replay.postCommit();
+            }
+            else
+            {
+                foreach ( const Tomahawk::dbcmd_ptr& cmd, cmds )
+                {
+                    impl->database().transaction();
+                    cmd->exec( impl );
+                    impl->database().commit();
+                    cmd->postCommit();
+                }
+            }
+        }
+    }
+
+    void benchmarkLoadPlaylistEntries()
+    {
+        const int size = 50000;
+        const QString playlist = "benchmark-playlist";
+        const QString revision = "benchmark-playlist-rev";
+
+        if ( !Tomahawk::Pipeline::instance() )
+            new Tomahawk::Pipeline( this );
+
+        Tomahawk::DatabaseImpl* impl = db->impl();
+        impl->database().transaction();
+
+        TomahawkSqlQuery query = impl->newquery();
+        query.prepare( "DELETE FROM playlist WHERE guid = ?" );
+        query.addBindValue( playlist );
+        query.exec();
+
+        query.prepare( "INSERT INTO playlist(guid, title, currentrevision) VALUES(?, ?, ?)" );
+        query.addBindValue( playlist );
+        query.addBindValue( "Benchmark" );
+        query.addBindValue( revision );
+        query.exec();
+
+        QVariantList guids;
+        query.prepare( "INSERT INTO playlist_item(guid, playlist, trackname, artistname, albumname) VALUES(?, ?, ?, ?, ?)" );
+        for ( int i = 0; i < size; i++ )
+        {
+            const QString guid = QString( "%1-item-%2" ).arg( playlist ).arg( i );
+            guids << guid;
+
+            query.bindValue( 0, guid );
+            query.bindValue( 1, playlist );
+            query.bindValue( 2, QString( "Track %1" ).arg( i ) );
+            query.bindValue( 3, QString( "Artist %1" ).arg( i % 1000 ) );
+            query.bindValue( 4, QString( "Album %1" ).arg( i % 5000 ) );
+            query.exec();
+        }
+
+        query.prepare( "INSERT INTO playlist_revision(guid, playlist, entries) VALUES(?, ?, ?)" );
+        query.addBindValue( revision );
+        query.addBindValue( playlist );
+        query.addBindValue( TomahawkUtils::toJson( guids ) );
+        query.exec();
+
+        impl->database().commit();
+
+        QBENCHMARK
+        {
+            TestLoadPlaylistEntries cmd( revision );
+            cmd.exec( impl );
+
+            QCOMPARE( cmd.guids().count(), size );
+            QCOMPARE( cmd.entries().count(), size );
+        }
+    }
 };
 
 #endif // TOMAHAWK_TESTDATABASE_H
@@ -0,0 +1,96 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTIMAGEREGISTRY_H
+#define TOMAHAWK_TESTIMAGEREGISTRY_H
+
+#include <QtTest>
+
+#include "utils/ImageRegistry.h"
+
+#define TEST_SVG "@PROJECT_SOURCE_DIR@/data/images/account-online.svg"
+
+class TestImageRegistry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCached()
+    {
+        ImageRegistry registry;
+
+        const QPixmap first = registry.pixmap( TEST_SVG, QSize( 32, 32 ) );
+        QVERIFY( !first.isNull() );
+        QCOMPARE( first.size(), QSize( 32, 32 ) );
+
+        // the very same pixmap, not a new rendering
+        QCOMPARE( registry.pixmap( TEST_SVG, QSize( 32, 32 ) ).cacheKey(), first.cacheKey() );
+
+        // opacity and tint are variants of their own
+        const QPixmap faded = registry.pixmap( TEST_SVG, QSize( 32, 32 ), TomahawkUtils::Original, 0.5 );
+        QCOMPARE( faded.size(), QSize( 32, 32 ) );
+        QVERIFY( faded.cacheKey() != first.cacheKey() );
+        QCOMPARE( registry.pixmap( TEST_SVG, QSize( 32, 32 ), TomahawkUtils::Original, 0.5 ).cacheKey(), faded.cacheKey() );
+        QVERIFY( registry.pixmap( TEST_SVG, QSize( 32, 32 ), TomahawkUtils::Original, 1.0, Qt::red ).cacheKey() != first.cacheKey() );
+    }
+
+    void testBounded()
+    {
+        ImageRegistry registry;
+        registry.setCacheLimit( 64 );
+
+        // 16kb each
+        for ( int i = 0; i < 20; i++ )
+            registry.pixmap( TEST_SVG, QSize( 64, 64 + i ) );
+
+        QVERIFY( registry.cacheSize() <= 64 );
+        QVERIFY( registry.cacheSize() > 0 );
+
+        // the most recently used are the ones still there
+        const qint64 key = registry.pixmap( TEST_SVG, QSize( 64, 83 ) ).cacheKey();
+        QCOMPARE( registry.pixmap( TEST_SVG, QSize( 64, 83 ) ).cacheKey(), key );
+    }
+
+    void benchmarkPaintPath_data()
+    {
+        QTest::addColumn< int >( "cacheLimit" );
+        QTest::newRow( "uncached" ) << 0;
+        QTest::newRow( "cached" ) << 32768;
+    }
+
+    // What a view asks for while painting its rows: a few icon sizes, faded and not
+    void benchmarkPaintPath()
+    {
+        QFETCH( int, cacheLimit );
+
+        ImageRegistry registry;
+        registry.setCacheLimit( cacheLimit );
+
+        QBENCHMARK
+        {
+            for ( int row = 0; row < 50; row++ )
+            {
+                const QSize size( 16 + ( row % 3 ) * 8, 16 + ( row % 3 ) * 8 );
+                registry.pixmap( TEST_SVG, size );
+                registry.pixmap( TEST_SVG, size, TomahawkUtils::Original, 0.5 );
+            }
+        }
+    }
+};
+
+#endif // TOMAHAWK_TESTIMAGEREGISTRY_H
@@ -0,0 +1,266 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTINFOREQUESTSCHEDULER_H
+#define TOMAHAWK_TESTINFOREQUESTSCHEDULER_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QQueue>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "libtomahawk/infosystem/InfoRequestScheduler.h"
+
+#define SERVER_LATENCY 100
+
+using namespace Tomahawk::InfoSystem;
+
+/**
+ * Answers every GET with its path after a fixed delay, keeping track of
+ * which requests arrived when and how many it had to answer at once.
+ */
+class HttpStandIn : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    HttpStandIn()
+        : m_open( 0 )
+        , m_maxOpen( 0 )
+    {
+        m_clock.start();
+        connect( this, SIGNAL( newConnection() ), SLOT( accept() ) );
+    }
+
+    QStringList paths() const { return m_paths; }
+    QList< qint64 > arrivals() const { return m_arrivals; }
+    int maxOpen() const { return m_maxOpen; }
+
+    QUrl url( const QString& path ) const
+    {
+        return QUrl( QString( "http://127.0.0.1:%1%2" ).arg( serverPort() ).arg( path ) );
+    }
+
+private slots:
+    void accept()
+    {
+        while ( hasPendingConnections() )
+        {
+            QTcpSocket* socket = nextPendingConnection();
+            connect( socket, SIGNAL( readyRead() ), SLOT( readRequest() ) );
+            connect( socket, SIGNAL( disconnected() ), socket, SLOT( deleteLater() ) );
+        }
+    }
+
+    void readRequest()
+    {
+        QTcpSocket* socket = qobject_cast< QTcpSocket* >( sender() );
+        const QByteArray buffer = socket->property( "buffer" ).toByteArray() + socket->readAll();
+        if ( !buffer.contains( "\r\n\r\n" ) )
+        {
+            socket->setProperty( "buffer", buffer );
+            return;
+        }
+        disconnect( socket, SIGNAL( readyRead() ), this, 0 );
+
+        const QString path = QString::fromLatin1( buffer.split( ' ' ).value( 1 ) );
+        m_paths << path;
+        m_arrivals << m_clock.elapsed();
+        m_maxOpen = qMax( m_maxOpen, ++m_open );
+
+        m_pending.enqueue( qMakePair( QPointer< QTcpSocket >( socket ), path ) );
+        QTimer::singleShot( SERVER_LATENCY, this, SLOT( answer() ) );
+    }
+
+    void answer()
+    {
+        const QPair< QPointer< QTcpSocket >, QString > rq = m_pending.dequeue();
+        m_open--;
+        if ( !rq.first )
+            return;
+
+        const QByteArray body = rq.second.toLatin1();
+        rq.first->write( QString( "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %1\r\nConnection: close\r\n\r\n" )
+                            .arg( body.length() ).toLatin1() + body );
+        rq.first->disconnectFromHost();
+    }
+
+private:
+    QElapsedTimer m_clock;
+    QStringList m_paths;
+    QList< qint64 > m_arrivals;
+    QQueue< QPair< QPointer< QTcpSocket >, QString > > m_pending;
+    int m_open;
+    int m_maxOpen;
+};
+
+
+class TestInfoRequestScheduler : public QObject
+{
+    Q_OBJECT
+
+private:
+    HttpStandIn* m_server;
+    InfoRequestScheduler* m_scheduler;
+
+    QNetworkReply* get( const QString& path, InfoRequestPriority priority = InfoPriorityNormal )
+    {
+        return m_scheduler->get( QNetworkRequest( m_server->url( path ) ), priority );
+    }
+
+    static bool waitFor( const QList< QNetworkReply* >& replies, int timeout = 5000 )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        foreach ( QNetworkReply* reply, replies )
+        {
+            while ( !reply->isFinished() && timer.elapsed() < timeout )
+                QTest::qWait( 5 );
+
+            if ( !reply->isFinished() )
+                return false;
+        }
+
+        return true;
+    }
+
+private slots:
+    void init()
+    {
+        m_server = new HttpStandIn;
+        QVERIFY( m_server->listen( QHostAddress::LocalHost ) );
+        m_scheduler = new InfoRequestScheduler;
+    }
+
+    void cleanup()
+    {
+        delete m_scheduler;
+        delete m_server;
+    }
+
+    void testDedup()
+    {
+        InfoRequestData first;
+        InfoRequestData second;
+        QNetworkReply* a = m_scheduler->get( QNetworkRequest( m_server->url( "/same" ) ), first );
+        QNetworkReply* b = m_scheduler->get( QNetworkRequest( m_server->url( "/same" ) ), second );
+        QNetworkReply* c = get( "/other" );
+
+        QVERIFY( waitFor( QList< QNetworkReply* >() << a << b << c ) );
+        QCOMPARE( m_server->paths().count( "/same" ), 1 );
+        QCOMPARE( a->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt(), 200 );
+        QCOMPARE( b->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt(), 200 );
+        QCOMPARE( a->readAll(), QByteArray( "/same" ) );
+        QCOMPARE( b->readAll(), QByteArray( "/same" ) );
+        QCOMPARE( c->readAll(), QByteArray( "/other" ) );
+
+        // done requests aren't shared anymore
+        QNetworkReply* again = get( "/same" );
+        QVERIFY( waitFor( QList< QNetworkReply* >() << again ) );
+        QCOMPARE( m_server->paths().count( "/same" ), 2 );
+    }
+
+    void testConcurrency()
+    {
+        m_scheduler->setHostLimits( "127.0.0.1", 2 );
+
+        QList< QNetworkReply* > replies;
+        for ( int i = 0; i < 6; i++ )
+            replies << get( QString( "/c%1" ).arg( i ) );
+        QCOMPARE( m_scheduler->running( "127.0.0.1" ), 2 );
+        QCOMPARE( m_scheduler->queued( "127.0.0.1" ), 4 );
+
+        QVERIFY( waitFor( replies ) );
+        QCOMPARE( m_server->paths().count(), 6 );
+        QCOMPARE( m_server->maxOpen(), 2 );
+        QCOMPARE( m_scheduler->running( "127.0.0.1" ), 0 );
+    }
+
+    void testRateLimit()
+    {
+        // one request right away, then one every 200ms
+        m_scheduler->setHostLimits( "127.0.0.1", 10, 5, 1 );
+
+        QList< QNetworkReply* > replies;
+        for ( int i = 0; i < 4; i++ )
+            replies << get( QString( "/r%1" ).arg( i ) );
+        QCOMPARE( m_scheduler->running( "127.0.0.1" ), 1 );
+
+        QVERIFY( waitFor( replies ) );
+        const QList< qint64 > arrivals = m_server->arrivals();
+        QCOMPARE( arrivals.count(), 4 );
+        for ( int i = 1; i < arrivals.count(); i++ )
+            QVERIFY( arrivals.at( i ) - arrivals.at( i - 1 ) >= 150 );
+    }
+
+    void testPriority()
+    {
+        m_scheduler->setHostLimits( "127.0.0.1", 1 );
+
+        QList< QNetworkReply* > replies;
+        replies << get( "/first", InfoPriorityLow );
+        replies << get( "/low1", InfoPriorityLow );
+        replies << get( "/normal" );
+        replies << get( "/low2", InfoPriorityLow );
+        replies << get( "/high", InfoPriorityHigh );
+
+        // asking for a queued request with a higher priority moves it up
+        replies << get( "/low2", InfoPriorityHigh );
+
+        QVERIFY( waitFor( replies ) );
+        QCOMPARE( m_server->paths(), QStringList() << "/first" << "/high" << "/low2" << "/normal" << "/low1" );
+    }
+
+    void testCancel()
+    {
+        m_scheduler->setHostLimits( "127.0.0.1", 1 );
+
+        InfoRequestData running;
+        InfoRequestData queued;
+        InfoRequestData sharing;
+        QNetworkReply* a = m_scheduler->get( QNetworkRequest( m_server->url( "/a" ) ), running );
+        QNetworkReply* b = m_scheduler->get( QNetworkRequest( m_server->url( "/b" ) ), queued );
+        QNetworkReply* shared = m_scheduler->get( QNetworkRequest( m_server->url( "/b" ) ), sharing );
+        QNetworkReply* c = m_scheduler->get( QNetworkRequest( m_server->url( "/c" ) ), queued );
+        QCOMPARE( m_scheduler->queued( "127.0.0.1" ), 2 );
+
+        // "/c" only had the canceled request waiting for it, "/b" is still wanted
+        m_scheduler->cancel( queued.internalId );
+        QVERIFY( b->isFinished() );
+        QVERIFY( c->isFinished() );
+        QCOMPARE( b->error(), QNetworkReply::OperationCanceledError );
+        QCOMPARE( m_scheduler->queued( "127.0.0.1" ), 1 );
+
+        // aborting the running request lets the next one out right away
+        m_scheduler->cancel( running.internalId );
+        QVERIFY( a->isFinished() );
+        QCOMPARE( a->error(), QNetworkReply::OperationCanceledError );
+        QCOMPARE( m_scheduler->running( "127.0.0.1" ), 1 );
+        QCOMPARE( m_scheduler->queued( "127.0.0.1" ), 0 );
+
+        QVERIFY( waitFor( QList< QNetworkReply* >() << shared ) );
+        QCOMPARE( shared->error(), QNetworkReply::NoError );
+        QCOMPARE( shared->readAll(), QByteArray( "/b" ) );
+        QVERIFY( !m_server->paths().contains( "/c" ) );
+    }
+};
+
+#endif // TOMAHAWK_TESTINFOREQUESTSCHEDULER_H
@@ -0,0 +1,190 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTINFOSYSTEMWORKER_H
+#define TOMAHAWK_TESTINFOSYSTEMWORKER_H
+
+#include <QtTest>
+
+#include "libtomahawk/infosystem/InfoSystem.h"
+#include "libtomahawk/infosystem/InfoSystemWorker.h"
+#include "libtomahawk/utils/TimerWheel.h"
+
+using namespace Tomahawk::InfoSystem;
+
+/**
+ * Remembers all requests it gets and only answers them when told to.
+ */
+class MockInfoPlugin : public InfoPlugin
+{
+    Q_OBJECT
+
+public:
+    MockInfoPlugin()
+    {
+        m_supportedGetTypes << InfoArtistBiography;
+    }
+
+    QList< InfoRequestData > requests;
+
+    void answer( const QVariant& output )
+    {
+        foreach ( const InfoRequestData& requestData, requests )
+            emit info( requestData, output );
+        requests.clear();
+    }
+
+protected slots:
+    void init() {}
+    void getInfo( Tomahawk::InfoSystem::InfoRequestData requestData ) { requests << requestData; }
+    void pushInfo( Tomahawk::InfoSystem::InfoPushData ) {}
+    void notInCacheSlot( Tomahawk::InfoSystem::InfoStringHash, Tomahawk::InfoSystem::InfoRequestData ) {}
+};
+
+
+class TestInfoSystemWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    static InfoRequestData request( quint64 requestId, const QString& artist, uint timeoutMillis = 0 )
+    {
+        InfoStringHash criteria;
+        criteria[ "artist" ] = artist;
+
+        InfoRequestData requestData( requestId, "TestInfoSystemWorker", InfoArtistBiography, QVariant::fromValue< InfoStringHash >( criteria ), QVariantMap() );
+        requestData.timeoutMillis = timeoutMillis;
+        return requestData;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        qRegisterMetaType< Tomahawk::InfoSystem::InfoRequestData >( "Tomahawk::InfoSystem::InfoRequestData" );
+        qRegisterMetaType< Tomahawk::InfoSystem::InfoStringHash >( "Tomahawk::InfoSystem::InfoStringHash" );
+        qRegisterMetaType< Tomahawk::InfoSystem::InfoType >( "Tomahawk::InfoSystem::InfoType" );
+    }
+
+    void testTimerWheel()
+    {
+        Tomahawk::TimerWheel wheel( 1000, 10 );
+        wheel.schedule( 1, 1005, 1000 );
+        wheel.schedule( 2, 1500, 1000 );
+        wheel.schedule( 3, 1000 + 10 * 64 * 64 * 3, 1000 ); // beyond both wheels
+        wheel.schedule( 4, 500, 1000 );                      // already due
+        QCOMPARE( wheel.count(), 4 );
+
+        QCOMPARE( wheel.advance( 1000 ), QList< quint64 >() << 4 );
+        QCOMPARE( wheel.advance( 1009 ), QList< quint64 >() );
+        QCOMPARE( wheel.advance( 1010 ), QList< quint64 >() << 1 );
+        QCOMPARE( wheel.advance( 1499 ), QList< quint64 >() );
+        QCOMPARE( wheel.advance( 1500 ), QList< quint64 >() << 2 );
+        QCOMPARE( wheel.advance( 1000 + 10 * 64 * 64 * 3 - 10 ), QList< quint64 >() );
+        QCOMPARE( wheel.advance( 1000 + 10 * 64 * 64 * 3 ), QList< quint64 >() << 3 );
+        QVERIFY( wheel.isEmpty() );
+    }
+
+    void testTimerWheelAfterIdle()
+    {
+        Tomahawk::TimerWheel wheel( 0, 1 );
+        wheel.schedule( 1, 10, 0 );
+        QCOMPARE( wheel.advance( 10 ), QList< quint64 >() << 1 );
+
+        // Nobody advances an empty wheel. A year later it must not step through every tick it missed.
+        const qint64 later = Q_INT64_C( 365 ) * 24 * 3600 * 1000;
+        wheel.schedule( 2, later + 100, later );
+        wheel.schedule( 3, later - 5, later );
+        QCOMPARE( wheel.count(), 2 );
+
+        QCOMPARE( wheel.advance( later ), QList< quint64 >() << 3 );
+        QCOMPARE( wheel.advance( later + 99 ), QList< quint64 >() );
+        QCOMPARE( wheel.advance( later + 100 ), QList< quint64 >() << 2 );
+        QVERIFY( wheel.isEmpty() );
+    }
+
+    void testCoalescing()
+    {
+        InfoSystemWorker worker;
+        MockInfoPlugin* plugin = new MockInfoPlugin;
+        worker.addInfoPlugin( InfoPluginPtr( plugin ) );
+        QSignalSpy spy( &worker, SIGNAL( info( Tomahawk::InfoSystem::InfoRequestData, QVariant ) ) );
+
+        worker.getInfo( request( 101, "Queen" ) );
+        worker.getInfo( request( 102, "Queen" ) );
+        worker.getInfo( request( 103, "Queen" ) );
+        worker.getInfo( request( 104, "Blur" ) );
+        QCoreApplication::processEvents();
+        QCOMPARE( plugin->requests.count(), 2 );
+
+        plugin->answer( QString( "biography" ) );
+        QCoreApplication::processEvents();
+
+        QCOMPARE( spy.count(), 4 );
+        QSet< quint64 > answered;
+        for ( int i = 0; i < spy.count(); i++ )
+        {
+            answered << spy.at( i ).at( 0 ).value< Tomahawk::InfoSystem::InfoRequestData >().requestId;
+            QCOMPARE( spy.at( i ).at( 1 ).toString(), QString( "biography" ) );
+        }
+        QCOMPARE( answered, QSet< quint64 >() << 101 << 102 << 103 << 104 );
+
+        // the call is done, asking again reaches the plugin again
+        worker.getInfo( request( 105, "Queen" ) );
+        QCoreApplication::processEvents();
+        QCOMPARE( plugin->requests.count(), 1 );
+    }
+
+    void testDispatchOnPluginAdded()
+    {
+        InfoSystemWorker worker;
+        worker.getInfo( request( 201, "Queen" ) );
+        QCoreApplication::processEvents();
+
+        MockInfoPlugin* plugin = new MockInfoPlugin;
+        worker.addInfoPlugin( InfoPluginPtr( plugin ) );
+        QCoreApplication::processEvents();
+        QCOMPARE( plugin->requests.count(), 1 );
+        QCOMPARE( plugin->requests.first().requestId, (quint64)201 );
+    }
+
+    void testTimeout()
+    {
+        InfoSystemWorker worker;
+        MockInfoPlugin* plugin = new MockInfoPlugin;
+        worker.addInfoPlugin( InfoPluginPtr( plugin ) );
+        QSignalSpy spy( &worker, SIGNAL( info( Tomahawk::InfoSystem::InfoRequestData, QVariant ) ) );
+
+        worker.getInfo( request( 301, "Queen", 300 ) );
+        worker.getInfo( request( 302, "Queen", 5000 ) );
+        QCoreApplication::processEvents();
+        QCOMPARE( plugin->requests.count(), 1 );
+
+        QTest::qWait( 1000 );
+        QCOMPARE( spy.count(), 1 );
+        QVERIFY( !spy.at( 0 ).at( 1 ).isValid() );
+
+        // the second request is still waiting for the shared call
+        plugin->answer( QString( "biography" ) );
+        QCoreApplication::processEvents();
+        QCOMPARE( spy.count(), 2 );
+        QCOMPARE( spy.at( 1 ).at( 0 ).value< Tomahawk::InfoSystem::InfoRequestData >().requestId, (quint64)302 );
+        QCOMPARE( spy.at( 1 ).at( 1 ).toString(), QString( "biography" ) );
+    }
+};
+
+#endif // TOMAHAWK_TESTINFOSYSTEMWORKER_H
@@ -0,0 +1,250 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTJSRESOLVER_H
+#define TOMAHAWK_TESTJSRESOLVER_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include "libtomahawk/Pipeline.h"
+#include "libtomahawk/Query.h"
+#include "libtomahawk/Result.h"
+#include "libtomahawk/Track.h"
+#include "libtomahawk/resolvers/JSResolver.h"
+
+// Resources aren't compiled into the tests, resolvers get it as a required script instead
+#define TOMAHAWK_JS "@PROJECT_SOURCE_DIR@/data/js/tomahawk.js"
+
+// A result for every query of the batch, its url tells how large the batch was
+#define ANSWER_BATCH \
+    "function answer( queries ) {" \
+    "    var results = [], i;" \
+    "    for ( i = 0; i < queries.length; i++ ) {" \
+    "        results.push( { qid: queries[i].qid, results: [ { artist: queries[i].artist, album: queries[i].album," \
+    "                        track: queries[i].track, mimetype: 'audio/mpeg', duration: 180," \
+    "                        url: 'http://localhost/' + queries.length + '/' + queries[i].qid } ] } );" \
+    "    }" \
+    "    return results;" \
+    "}"
+
+
+class TestJSResolver : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir* m_dir;
+    QList< JSResolver* > m_resolvers;
+    int m_queries;
+
+    // Loads a resolver with the given members through the real JSResolver and adds it to the Pipeline
+    JSResolver* addResolver( const QString& members, const QString& prelude = QString() )
+    {
+        const QString path = m_dir->path() + QString( "/standin%1.js" ).arg( m_resolvers.count() );
+        QFile script( path );
+        if ( !script.open( QIODevice::WriteOnly ) )
+            return 0;
+
+        script.write( QString( "%1\n"
+                               "var StandInResolver = Tomahawk.extend( TomahawkResolver, {"
+                               "    settings: { name: 'Stand-in %2', weight: 100, timeout: 1 },"
+                               "    %3"
+                               "} );"
+                               "Tomahawk.resolver.instance = StandInResolver;" )
+                          .arg( prelude ).arg( m_resolvers.count() ).arg( members ).toUtf8() );
+        script.close();
+
+        JSResolver* resolver = new JSResolver( "jsresolvertest", path, QStringList() << TOMAHAWK_JS );
+        m_resolvers << resolver;
+        resolver->start();
+        return resolver;
+    }
+
+    QList< Tomahawk::query_ptr > queries( int count )
+    {
+        QList< Tomahawk::query_ptr > qlist;
+        for ( int i = 0; i < count; i++ )
+            qlist << Tomahawk::Query::get( "Artist", QString( "Track %1" ).arg( m_queries++ ), QString() );
+
+        return qlist;
+    }
+
+    static void resolve( const QList< Tomahawk::query_ptr >& qlist )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        Tomahawk::Pipeline::instance()->resolve( qlist );
+
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            while ( !q->resolvingFinished() && timer.elapsed() < 10000 )
+                QTest::qWait( 5 );
+        }
+    }
+
+    // Size of the batch the result of q was found in
+    static int batchSize( const Tomahawk::query_ptr& q )
+    {
+        if ( q->results().isEmpty() )
+            return 0;
+
+        return q->results().first()->url().section( '/', 3, 3 ).toInt();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        m_queries = 0;
+        m_dir = new QTemporaryDir;
+        QVERIFY( m_dir->isValid() );
+
+        new Tomahawk::Pipeline( this );
+        Tomahawk::Pipeline::instance()->start();
+    }
+
+    void cleanupTestCase()
+    {
+        delete m_dir;
+    }
+
+    void cleanup()
+    {
+        qDeleteAll( m_resolvers );
+        m_resolvers.clear();
+    }
+
+    void testLoad()
+    {
+        JSResolver* resolver = addResolver( "" );
+        QVERIFY( resolver->running() );
+        QCOMPARE( resolver->name(), QString( "Stand-in 0" ) );
+        QCOMPARE( resolver->weight(), 100U );
+        QCOMPARE( resolver->timeout(), 1000U );
+    }
+
+    void testBatch()
+    {
+        addResolver( "resolveBatch: function( queries ) { return answer( queries ); }", ANSWER_BATCH );
+
+        // The Pipeline hands over what it dispatches at once in a single call
+        const QList< Tomahawk::query_ptr > qlist = queries( 3 );
+        resolve( qlist );
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            QVERIFY( q->solved() );
+            QCOMPARE( batchSize( q ), 3 );
+        }
+    }
+
+    void testBatchKeepsQueryLimit()
+    {
+        addResolver( "resolveBatch: function( queries ) { return answer( queries ); }", ANSWER_BATCH );
+
+        // More queries than may resolve at once, they are split up instead of going out together
+        const QList< Tomahawk::query_ptr > qlist = queries( 40 );
+        resolve( qlist );
+
+        int largest = 0;
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            QVERIFY( q->solved() );
+            QVERIFY( batchSize( q ) > 0 );
+            largest = qMax( largest, batchSize( q ) );
+        }
+        QVERIFY( largest <= 16 );
+    }
+
+    void testResolvePerQuery()
+    {
+        // No resolveBatch() of its own, tomahawk.js calls resolve() for every query of the batch
+        addResolver( "resolve: function( qid, artist, album, title ) {"
+                     "    if ( title === 'broken' ) throw 'broken';"
+                     "    return { qid: qid, results: [ { artist: artist, album: album, track: title,"
+                     "                                    mimetype: 'audio/mpeg', url: 'http://localhost/1/' + qid } ] };"
+                     "}" );
+
+        const Tomahawk::query_ptr quoted = Tomahawk::Query::get( "Guns N' Roses \\ \"live\"", "Don't Cry", QString() );
+        const Tomahawk::query_ptr broken = Tomahawk::Query::get( "Artist", "broken", QString() );
+        const Tomahawk::query_ptr plain = queries( 1 ).first();
+        resolve( QList< Tomahawk::query_ptr >() << quoted << broken << plain );
+
+        // strings arrive untouched, no escaping involved
+        QVERIFY( quoted->solved() );
+        QCOMPARE( quoted->results().first()->track()->artist(), QString( "Guns N' Roses \\ \"live\"" ) );
+        QCOMPARE( quoted->results().first()->track()->track(), QString( "Don't Cry" ) );
+
+        // a failing query doesn't take the batch down
+        QVERIFY( !broken->solved() );
+        QVERIFY( plain->solved() );
+    }
+
+    void testAddTrackResultsBatch()
+    {
+        // Answers later through Tomahawk.addTrackResultsBatch()
+        addResolver( "resolveBatch: function( queries ) {"
+                     "    window.setTimeout( function() { Tomahawk.addTrackResultsBatch( answer( queries ) ); }, 20 );"
+                     "}",
+                     ANSWER_BATCH );
+
+        const QList< Tomahawk::query_ptr > qlist = queries( 2 );
+        resolve( qlist );
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            QVERIFY( q->solved() );
+            QCOMPARE( batchSize( q ), 2 );
+        }
+    }
+
+    void benchmarkPerQuery_data()
+    {
+        QTest::addColumn< int >( "size" );
+        QTest::addColumn< bool >( "batched" );
+
+        const int sizes[] = { 1, 10, 50, 100, 500 };
+        for ( unsigned int i = 0; i < sizeof( sizes ) / sizeof( sizes[0] ); i++ )
+        {
+            QTest::newRow( QString( "%1 one by one" ).arg( sizes[i] ).toLatin1().constData() ) << sizes[i] << false;
+            QTest::newRow( QString( "%1 batched" ).arg( sizes[i] ).toLatin1().constData() ) << sizes[i] << true;
+        }
+    }
+
+    // The cost of calling into the script, the resolver itself answers asynchronously and never does
+    void benchmarkPerQuery()
+    {
+        QFETCH( int, size );
+        QFETCH( bool, batched );
+
+        JSResolver* resolver = addResolver( "resolveBatch: function( queries ) {}" );
+        const QList< Tomahawk::query_ptr > qlist = queries( size );
+
+        QBENCHMARK
+        {
+            if ( batched )
+                resolver->resolve( qlist );
+            else
+            {
+                foreach ( const Tomahawk::query_ptr& q, qlist )
+                    resolver->resolve( q );
+            }
+        }
+    }
+};
+
+#endif // TOMAHAWK_TESTJSRESOLVER_H
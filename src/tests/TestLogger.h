@@ -0,0 +1,148 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTLOGGER_H
+#define TOMAHAWK_TESTLOGGER_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "libtomahawk/utils/Logger.h"
+
+#define PRODUCERS 16
+
+/**
+ * Logs a number of lines as fast as it can and records how long each call took.
+ */
+class LogProducer : public QThread
+{
+public:
+    LogProducer( int id, int count ) : m_id( id ), m_count( count ) {}
+
+    QVector< qint64 > latencies;
+
+protected:
+    void run()
+    {
+        latencies.clear();
+        latencies.reserve( m_count );
+
+        QElapsedTimer timer;
+        for ( int i = 0; i < m_count; i++ )
+        {
+            timer.start();
+            tDebug( LOGVERBOSE ) << "testlogger" << m_id << i;
+            latencies << timer.nsecsElapsed();
+        }
+    }
+
+private:
+    int m_id;
+    int m_count;
+};
+
+
+class TestLogger : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_logfile;
+
+    static QList< LogProducer* > runProducers( int count )
+    {
+        QList< LogProducer* > producers;
+        for ( int i = 0; i < PRODUCERS; i++ )
+            producers << new LogProducer( i, count );
+
+        foreach ( LogProducer* producer, producers )
+            producer->start();
+        foreach ( LogProducer* producer, producers )
+            producer->wait();
+
+        return producers;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        m_logfile = QDir::tempPath() + QString( "/tomahawk-testlogger-%1.log" ).arg( QCoreApplication::applicationPid() );
+        QFile::remove( m_logfile );
+        Logger::setupLogfile( m_logfile );
+    }
+
+    void cleanupTestCase()
+    {
+        tLogNotifyShutdown();
+        QFile::remove( m_logfile );
+    }
+
+    void testNothingLost()
+    {
+        QFile::resize( m_logfile, 0 );
+        qDeleteAll( runProducers( 2000 ) );
+        Logger::flush();
+
+        QFile log( m_logfile );
+        QVERIFY( log.open( QIODevice::ReadOnly | QIODevice::Text ) );
+
+        // Everything is either on disk or accounted for as dropped
+        int written = 0, dropped = 0;
+        QRegExp droppedRx( "dropped (\\d+) messages" );
+        while ( !log.atEnd() )
+        {
+            const QString line = QString::fromUtf8( log.readLine() );
+            if ( line.contains( "testlogger" ) )
+                written++;
+            else if ( droppedRx.indexIn( line ) >= 0 )
+                dropped += droppedRx.cap( 1 ).toInt();
+        }
+
+        QCOMPARE( written + dropped, PRODUCERS * 2000 );
+    }
+
+    void benchmarkProducers()
+    {
+        QVector< qint64 > latencies;
+        QElapsedTimer timer;
+        qint64 elapsed = 0;
+
+        QBENCHMARK
+        {
+            timer.start();
+            QList< LogProducer* > producers = runProducers( 5000 );
+            elapsed = timer.nsecsElapsed();
+
+            latencies.clear();
+            foreach ( LogProducer* producer, producers )
+                latencies += producer->latencies;
+            qDeleteAll( producers );
+        }
+        Logger::flush();
+
+        qSort( latencies );
+        tLog() << "messages/s:" << (qint64)( latencies.count() * 1000000000.0 / qMax( elapsed, (qint64)1 ) )
+               << "p50:" << latencies.at( latencies.count() / 2 ) << "ns"
+               << "p99:" << latencies.at( latencies.count() * 99 / 100 ) << "ns"
+               << "p99.9:" << latencies.at( latencies.count() * 999 / 1000 ) << "ns"
+               << "max:" << latencies.last() << "ns";
+    }
+};
+
+#endif // TOMAHAWK_TESTLOGGER_H
@@ -0,0 +1,350 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTPIPELINE_H
+#define TOMAHAWK_TESTPIPELINE_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+#include "libtomahawk/Pipeline.h"
+#include "libtomahawk/Query.h"
+#include "libtomahawk/Result.h"
+#include "libtomahawk/Track.h"
+#include "libtomahawk/resolvers/Resolver.h"
+
+Q_DECLARE_METATYPE( Tomahawk::Pipeline::DispatchMode )
+
+static QElapsedTimer s_clock;
+
+/**
+ * Answers every query after a fixed delay, with a perfect result if it
+ * finds tracks and with no results otherwise. Results are served from
+ * below baseUrl.
+ */
+class MockResolver : public Tomahawk::Resolver
+{
+    Q_OBJECT
+
+public:
+    MockResolver( const QString& name, unsigned int weight, int delay, bool finds, const QString& baseUrl = "http://localhost" )
+        : asked( 0 )
+        , cancelled( 0 )
+        , askedAt( -1 )
+        , timeoutAfter( 0 )
+        , m_name( name )
+        , m_weight( weight )
+        , m_delay( delay )
+        , m_finds( finds )
+        , m_baseUrl( baseUrl )
+    {
+    }
+
+    QString name() const { return m_name; }
+    unsigned int weight() const { return m_weight; }
+    unsigned int timeout() const { return timeoutAfter; }
+
+    int asked;
+    int cancelled;
+    qint64 askedAt;
+    unsigned int timeoutAfter;
+
+public slots:
+    void resolve( const Tomahawk::query_ptr& query )
+    {
+        asked++;
+        askedAt = s_clock.elapsed();
+
+        m_pending << query;
+        QTimer::singleShot( m_delay, this, SLOT( answer() ) );
+    }
+
+    void cancel( const Tomahawk::query_ptr& query )
+    {
+        Q_UNUSED( query );
+        cancelled++;
+    }
+
+private slots:
+    void answer()
+    {
+        const Tomahawk::query_ptr query = m_pending.takeFirst();
+
+        QList< Tomahawk::result_ptr > results;
+        if ( m_finds )
+        {
+            Tomahawk::result_ptr result = Tomahawk::Result::get( QString( "%1/%2/%3" ).arg( m_baseUrl ).arg( m_name ).arg( query->id() ) );
+            result->setTrack( Tomahawk::Track::get( query->queryTrack()->artist(), query->queryTrack()->track() ) );
+            result->setMimetype( "audio/mpeg" );
+            result->setRID( uuid() );
+            result->setResolvedBy( this );
+            results << result;
+        }
+
+        Tomahawk::Pipeline::instance()->reportResults( query->id(), this, results );
+    }
+
+private:
+    QString m_name;
+    unsigned int m_weight;
+    int m_delay;
+    bool m_finds;
+    QString m_baseUrl;
+    QList< Tomahawk::query_ptr > m_pending;
+};
+
+
+class TestPipeline : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList< MockResolver* > m_resolvers;
+    int m_queries;
+
+    MockResolver* addResolver( unsigned int weight, int delay, bool finds, const QString& baseUrl = "http://localhost" )
+    {
+        MockResolver* r = new MockResolver( QString( "Mock %1" ).arg( m_resolvers.count() ), weight, delay, finds, baseUrl );
+        m_resolvers << r;
+        Tomahawk::Pipeline::instance()->addResolver( r );
+        return r;
+    }
+
+    QList< Tomahawk::query_ptr > queries( int count )
+    {
+        QList< Tomahawk::query_ptr > qlist;
+        for ( int i = 0; i < count; i++ )
+            qlist << Tomahawk::Query::get( "Artist", QString( "Track %1" ).arg( m_queries++ ), QString() );
+
+        return qlist;
+    }
+
+    // Resolves the queries and returns how long it took until all of them were done
+    static qint64 resolve( const QList< Tomahawk::query_ptr >& qlist, int timeout = 10000 )
+    {
+        const qint64 start = s_clock.elapsed();
+        Tomahawk::Pipeline::instance()->resolve( qlist );
+
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            while ( !q->resolvingFinished() && s_clock.elapsed() - start < timeout )
+                QTest::qWait( 5 );
+        }
+
+        return s_clock.elapsed() - start;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        s_clock.start();
+        m_queries = 0;
+
+        new Tomahawk::Pipeline( this );
+        Tomahawk::Pipeline::instance()->start();
+    }
+
+    void cleanup()
+    {
+        foreach ( MockResolver* r, m_resolvers )
+            Tomahawk::Pipeline::instance()->removeResolver( r );
+
+        // let late answers arrive before their resolvers go away
+        QTest::qWait( 50 );
+        qDeleteAll( m_resolvers );
+        m_resolvers.clear();
+
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Sequential );
+    }
+
+    void testSequential()
+    {
+        MockResolver* first = addResolver( 100, 100, false );
+        MockResolver* second = addResolver( 90, 100, false );
+        MockResolver* third = addResolver( 80, 100, true );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        QVERIFY( resolve( QList< Tomahawk::query_ptr >() << q ) >= 300 );
+        QVERIFY( q->solved() );
+
+        QCOMPARE( first->asked + second->asked + third->asked, 3 );
+        QVERIFY( first->askedAt < second->askedAt );
+        QVERIFY( second->askedAt < third->askedAt );
+    }
+
+    void testDeadHint()
+    {
+        // Nothing listens there, the url check fails and the result is dropped
+        MockResolver* dead = addResolver( 100, 20, true, "http://127.0.0.1:1" );
+        MockResolver* live = addResolver( 90, 20, true );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        resolve( QList< Tomahawk::query_ptr >() << q );
+        QVERIFY( q->solved() );
+
+        QCOMPARE( dead->asked, 1 );
+        QCOMPARE( live->asked, 1 );
+        QCOMPARE( q->results().count(), 1 );
+        QVERIFY( q->results().first()->url().startsWith( "http://localhost/" ) );
+    }
+
+    void testLateAnswer()
+    {
+        MockResolver* timedOut = addResolver( 100, 300, false );
+        timedOut->timeoutAfter = 100;
+        MockResolver* slow = addResolver( 90, 400, false );
+        MockResolver* last = addResolver( 80, 20, true );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        resolve( QList< Tomahawk::query_ptr >() << q );
+        QVERIFY( q->solved() );
+
+        // the answer arriving after the timeout doesn't count for the round after it
+        QVERIFY( slow->askedAt - timedOut->askedAt < 250 );
+        QVERIFY( last->askedAt - slow->askedAt >= 350 );
+    }
+
+    void testParallel()
+    {
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Parallel );
+        MockResolver* first = addResolver( 100, 200, false );
+        MockResolver* second = addResolver( 90, 200, false );
+        MockResolver* third = addResolver( 80, 200, true );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        QVERIFY( resolve( QList< Tomahawk::query_ptr >() << q ) < 2 * 200 );
+        QVERIFY( q->solved() );
+
+        QCOMPARE( first->asked + second->asked + third->asked, 3 );
+        QCOMPARE( first->cancelled + second->cancelled + third->cancelled, 0 );
+    }
+
+    void testEarlyTermination()
+    {
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Parallel );
+        addResolver( 100, 50, true );
+        MockResolver* slow = addResolver( 90, 2000, false );
+        MockResolver* slower = addResolver( 80, 3000, false );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        QVERIFY( resolve( QList< Tomahawk::query_ptr >() << q ) < 1000 );
+        QVERIFY( q->solved() );
+
+        // the perfect result of the top resolver can't be beaten, nobody else needs to bother
+        QCOMPARE( slow->cancelled, 1 );
+        QCOMPARE( slower->cancelled, 1 );
+    }
+
+    void testTopWeightAnswersFirst()
+    {
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Parallel );
+        addResolver( 100, 300, false );
+        addResolver( 50, 20, true );
+
+        // a perfect result from the lower weight resolver still waits for the higher one
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        QVERIFY( resolve( QList< Tomahawk::query_ptr >() << q ) >= 250 );
+        QVERIFY( q->solved() );
+    }
+
+    void testTiered()
+    {
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Tiered );
+        MockResolver* a = addResolver( 100, 100, false );
+        MockResolver* b = addResolver( 100, 100, false );
+        MockResolver* c = addResolver( 50, 100, true );
+
+        const Tomahawk::query_ptr q = queries( 1 ).first();
+        resolve( QList< Tomahawk::query_ptr >() << q );
+        QVERIFY( q->solved() );
+
+        // both of the top weight at once, the next weight once they answered
+        QVERIFY( qAbs( a->askedAt - b->askedAt ) < 50 );
+        QVERIFY( c->askedAt - a->askedAt >= 90 );
+    }
+
+    void testStats()
+    {
+        Tomahawk::Pipeline::instance()->resetStats();
+        Tomahawk::Pipeline::instance()->setDispatchMode( Tomahawk::Pipeline::Parallel );
+        MockResolver* top = addResolver( 100, 100, true );
+        MockResolver* none = addResolver( 90, 20, false );
+        MockResolver* slow = addResolver( 80, 3000, false );
+
+        resolve( queries( 4 ) );
+        const Tomahawk::PipelineStats stats = Tomahawk::Pipeline::instance()->stats();
+        QCOMPARE( stats.queued(), Q_UINT64_C( 4 ) );
+        QCOMPARE( stats.finished(), Q_UINT64_C( 4 ) );
+        QCOMPARE( stats.solved(), Q_UINT64_C( 4 ) );
+        QCOMPARE( stats.queueWait().count(), Q_UINT64_C( 4 ) );
+        QCOMPARE( stats.timeToFirstResult().count(), Q_UINT64_C( 4 ) );
+        QVERIFY( stats.timeToFirstResult().max() >= 100 );
+
+        const Tomahawk::ResolverStats topStats = stats.resolver( top->name() );
+        QCOMPARE( topStats.dispatched, Q_UINT64_C( 4 ) );
+        QCOMPARE( topStats.hits, Q_UINT64_C( 4 ) );
+        QCOMPARE( topStats.hitRate(), 1.0 );
+        QVERIFY( topStats.latency.percentile( 50 ) >= 100 && topStats.latency.percentile( 50 ) <= 250 );
+
+        // answers without results are told apart by who reported them
+        const Tomahawk::ResolverStats noneStats = stats.resolver( none->name() );
+        QCOMPARE( noneStats.answered, Q_UINT64_C( 4 ) );
+        QCOMPARE( noneStats.hitRate(), 0.0 );
+        QVERIFY( noneStats.latency.max() < 100 );
+
+        // nobody waited for the slow one anymore once the top one found it
+        const Tomahawk::ResolverStats slowStats = stats.resolver( slow->name() );
+        QCOMPARE( slowStats.answered, Q_UINT64_C( 0 ) );
+        QCOMPARE( slowStats.cancelled, Q_UINT64_C( 4 ) );
+
+        const QVariantMap m = stats.toVariantMap();
+        QCOMPARE( m.value( "resolvers" ).toMap().count(), 3 );
+        QCOMPARE( m.value( "firstresult" ).toMap().value( "count" ).toInt(), 4 );
+    }
+
+    void benchmarkDispatch_data()
+    {
+        QTest::addColumn< Tomahawk::Pipeline::DispatchMode >( "mode" );
+        QTest::newRow( "sequential" ) << Tomahawk::Pipeline::Sequential;
+        QTest::newRow( "tiered" ) << Tomahawk::Pipeline::Tiered;
+        QTest::newRow( "parallel" ) << Tomahawk::Pipeline::Parallel;
+    }
+
+    // 20 queries only the fifth of five resolvers can answer, each taking 30ms
+    void benchmarkDispatch()
+    {
+        QFETCH( Tomahawk::Pipeline::DispatchMode, mode );
+
+        Tomahawk::Pipeline::instance()->setDispatchMode( mode );
+        addResolver( 100, 30, false );
+        addResolver( 90, 30, false );
+        addResolver( 90, 30, false );
+        addResolver( 80, 30, false );
+        addResolver( 70, 30, true );
+
+        QBENCHMARK
+        {
+            const QList< Tomahawk::query_ptr > qlist = queries( 20 );
+            resolve( qlist, 30000 );
+            foreach ( const Tomahawk::query_ptr& q, qlist )
+                QVERIFY( q->solved() );
+        }
+    }
+};
+
+#endif // TOMAHAWK_TESTPIPELINE_H
@@ -0,0 +1,316 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTPLAYDARAPI_H
+#define TOMAHAWK_TESTPLAYDARAPI_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include "libtomahawk-playdarapi/Api_v1.h"
+#include "libtomahawk/Pipeline.h"
+#include "libtomahawk/Query.h"
+#include "libtomahawk/Result.h"
+#include "libtomahawk/Track.h"
+#include "libtomahawk/resolvers/Resolver.h"
+#include "libtomahawk/utils/Json.h"
+
+#define API_PORT 60211
+#define RESOLVER_LATENCY 200
+
+/**
+ * Finds every track after a fixed delay, except for the track "never".
+ */
+class DelayedResolver : public Tomahawk::Resolver
+{
+    Q_OBJECT
+
+public:
+    QString name() const { return "Delayed"; }
+    unsigned int weight() const { return 100; }
+    unsigned int timeout() const { return 0; }
+
+public slots:
+    void resolve( const Tomahawk::query_ptr& query )
+    {
+        if ( query->queryTrack()->track() == "never" )
+            return;
+
+        m_pending << query;
+        QTimer::singleShot( RESOLVER_LATENCY, this, SLOT( answer() ) );
+    }
+
+private slots:
+    void answer()
+    {
+        const Tomahawk::query_ptr query = m_pending.takeFirst();
+
+        Tomahawk::result_ptr result = Tomahawk::Result::get( "http://localhost/" + query->id() );
+        result->setTrack( Tomahawk::Track::get( query->queryTrack()->artist(), query->queryTrack()->track() ) );
+        result->setMimetype( "audio/mpeg" );
+        result->setRID( uuid() );
+        result->setResolvedBy( this );
+
+        Tomahawk::Pipeline::instance()->reportResults( query->id(), QList< Tomahawk::result_ptr >() << result );
+    }
+
+private:
+    QList< Tomahawk::query_ptr > m_pending;
+};
+
+
+class TestPlaydarApi : public QObject
+{
+    Q_OBJECT
+
+private:
+    QxtHttpSessionManager* m_session;
+    QxtHttpServerConnector* m_connector;
+    Api_v1* m_api;
+    DelayedResolver* m_resolver;
+    QNetworkAccessManager* m_nam;
+    int m_requests;
+
+    QVariantMap wait( QNetworkReply* reply )
+    {
+        m_requests++;
+
+        QEventLoop loop;
+        connect( reply, SIGNAL( finished() ), &loop, SLOT( quit() ) );
+        if ( !reply->isFinished() )
+            loop.exec();
+
+        reply->deleteLater();
+        return TomahawkUtils::parseJson( reply->readAll() ).toMap();
+    }
+
+    QVariantMap get( const QString& query )
+    {
+        return wait( m_nam->get( QNetworkRequest( QUrl( QString( "http://127.0.0.1:%1/api/?%2" ).arg( API_PORT ).arg( query ) ) ) ) );
+    }
+
+    QVariantMap post( const QString& query, const QVariantMap& body )
+    {
+        QNetworkRequest request( QUrl( QString( "http://127.0.0.1:%1/api/?%2" ).arg( API_PORT ).arg( query ) ) );
+        request.setHeader( QNetworkRequest::ContentTypeHeader, "application/json" );
+        return wait( m_nam->post( request, TomahawkUtils::toJson( body ) ) );
+    }
+
+    static QString resolveArgs( const QString& artist, const QString& track )
+    {
+        return QString( "method=resolve&artist=%1&track=%2" )
+                  .arg( QString::fromLatin1( QUrl::toPercentEncoding( artist ) ) )
+                  .arg( QString::fromLatin1( QUrl::toPercentEncoding( track ) ) );
+    }
+
+private slots:
+    void initTestCase()
+    {
+        new Tomahawk::Pipeline( this );
+        Tomahawk::Pipeline::instance()->start();
+
+        m_resolver = new DelayedResolver;
+        Tomahawk::Pipeline::instance()->addResolver( m_resolver );
+
+        m_session = new QxtHttpSessionManager;
+        m_connector = new QxtHttpServerConnector;
+        m_session->setListenInterface( QHostAddress::LocalHost );
+        m_session->setPort( API_PORT );
+        m_session->setConnector( m_connector );
+
+        m_api = new Api_v1( m_session );
+        m_session->setStaticContentService( m_api );
+        QVERIFY( m_session->start() );
+
+        m_nam = new QNetworkAccessManager( this );
+    }
+
+    void cleanupTestCase()
+    {
+        Tomahawk::Pipeline::instance()->removeResolver( m_resolver );
+        delete m_api;
+        delete m_session;
+        delete m_connector;
+        delete m_resolver;
+    }
+
+    void testLongPoll()
+    {
+        const QString qid = get( resolveArgs( "Artist", "Track" ) ).value( "qid" ).toString();
+        QVERIFY( !qid.isEmpty() );
+
+        QElapsedTimer timer;
+        timer.start();
+        const QVariantMap r = get( QString( "method=get_results&qid=%1&wait=10000" ).arg( qid ) );
+
+        // returned as soon as the resolver answered, not after the full wait
+        QVERIFY( timer.elapsed() < 5000 );
+        QCOMPARE( r.value( "results" ).toList().count(), 1 );
+
+        // nothing new to wait for
+        const QVariantMap again = get( QString( "method=get_results&qid=%1&wait=300&known=1" ).arg( qid ) );
+        QCOMPARE( again.value( "results" ).toList().count(), 1 );
+    }
+
+    void testLongPollTimeout()
+    {
+        const QString qid = get( resolveArgs( "Artist", "never" ) ).value( "qid" ).toString();
+
+        QElapsedTimer timer;
+        timer.start();
+        const QVariantMap r = get( QString( "method=get_results&qid=%1&wait=500" ).arg( qid ) );
+        QVERIFY( timer.elapsed() >= 400 );
+        QVERIFY( r.value( "results" ).toList().isEmpty() );
+    }
+
+    void testResolveBatch()
+    {
+        QVariantList queries;
+        for ( int i = 0; i < 5; i++ )
+        {
+            QVariantMap q;
+            q[ "artist" ] = QString( "Batch Artist %1" ).arg( i );
+            q[ "track" ] = QString( "Batch Track %1" ).arg( i );
+            queries << q;
+        }
+        QVariantMap invalid;
+        invalid[ "artist" ] = "No Track";
+        queries << invalid;
+
+        QVariantMap body;
+        body[ "queries" ] = queries;
+        const QVariantList qids = post( "method=resolve_batch", body ).value( "qids" ).toList();
+        QCOMPARE( qids.count(), 6 );
+        QVERIFY( qids.last().isNull() );
+
+        foreach ( const QVariant& qid, qids.mid( 0, 5 ) )
+        {
+            const QVariantMap r = get( QString( "method=get_results&qid=%1&wait=10000" ).arg( qid.toString() ) );
+            QCOMPARE( r.value( "results" ).toList().count(), 1 );
+        }
+    }
+
+    void testResolveBatchTooLarge()
+    {
+        QVariantList queries;
+        for ( int i = 0; i < 20000; i++ )
+        {
+            QVariantMap q;
+            q[ "artist" ] = QString( "Large Batch Artist %1" ).arg( i );
+            q[ "track" ] = QString( "Large Batch Track %1" ).arg( i );
+            queries << q;
+        }
+
+        QVariantMap body;
+        body[ "queries" ] = queries;
+        QVERIFY( TomahawkUtils::toJson( body ).size() > 1024 * 1024 );
+
+        // Refused without being read, and the api still answers afterwards
+        QVERIFY( !post( "method=resolve_batch", body ).contains( "qids" ) );
+        QCOMPARE( get( "method=stat" ).value( "name" ).toString(), QString( "playdar" ) );
+    }
+
+    void testStat()
+    {
+        const QVariantMap plain = get( "method=stat" );
+        QCOMPARE( plain.value( "name" ).toString(), QString( "playdar" ) );
+        QVERIFY( !plain.contains( "pipeline" ) );
+
+        get( QString( "method=get_results&qid=%1&wait=10000" ).arg( get( resolveArgs( "Stat Artist", "Track" ) ).value( "qid" ).toString() ) );
+
+        const QVariantMap pipeline = get( "method=stat&pipeline=1" ).value( "pipeline" ).toMap();
+        QVERIFY( pipeline.value( "queued" ).toInt() > 0 );
+        QVERIFY( pipeline.value( "firstresult" ).toMap().value( "count" ).toInt() > 0 );
+
+        const QVariantMap resolver = pipeline.value( "resolvers" ).toMap().value( "Delayed" ).toMap();
+        QVERIFY( resolver.value( "dispatched" ).toInt() > 0 );
+        QVERIFY( resolver.value( "latency" ).toMap().value( "p50" ).toInt() >= RESOLVER_LATENCY );
+        QCOMPARE( resolver.value( "latency" ).toMap().value( "buckets" ).toList().count(), Tomahawk::LatencyHistogram::bounds().count() + 1 );
+    }
+
+    // Time until a client sees the results of 10 queries, and the requests that took
+    void benchmarkResultDelivery()
+    {
+        const int count = 10;
+
+        // Polling: one resolve per query, then get_results every poll_interval
+        m_requests = 0;
+        QHash< QString, qint64 > started;
+        QElapsedTimer clock;
+        clock.start();
+        for ( int i = 0; i < count; i++ )
+            started.insert( get( resolveArgs( QString( "Polled Artist %1" ).arg( i ), "Track" ) ).value( "qid" ).toString(), clock.elapsed() );
+
+        qint64 pollLatency = 0;
+        QStringList pending = started.keys();
+        for ( int round = 0; !pending.isEmpty() && round < 14; round++ )
+        {
+            int interval = 0;
+            foreach ( const QString& qid, pending )
+            {
+                const QVariantMap r = get( QString( "method=get_results&qid=%1" ).arg( qid ) );
+                interval = r.value( "poll_interval" ).toInt();
+                if ( r.value( "results" ).toList().isEmpty() )
+                    continue;
+
+                pollLatency += clock.elapsed() - started.value( qid );
+                pending.removeAll( qid );
+            }
+
+            if ( !pending.isEmpty() )
+                QTest::qWait( interval );
+        }
+        QVERIFY( pending.isEmpty() );
+        const int pollRequests = m_requests;
+
+        // Batch resolve and long polling
+        m_requests = 0;
+        QVariantList queries;
+        for ( int i = 0; i < count; i++ )
+        {
+            QVariantMap q;
+            q[ "artist" ] = QString( "Pushed Artist %1" ).arg( i );
+            q[ "track" ] = "Track";
+            queries << q;
+        }
+        QVariantMap body;
+        body[ "queries" ] = queries;
+
+        clock.restart();
+        const QVariantList qids = post( "method=resolve_batch", body ).value( "qids" ).toList();
+
+        qint64 pushLatency = 0;
+        foreach ( const QVariant& qid, qids )
+        {
+            const QVariantMap r = get( QString( "method=get_results&qid=%1&wait=10000" ).arg( qid.toString() ) );
+            QVERIFY( !r.value( "results" ).toList().isEmpty() );
+            pushLatency += clock.elapsed();
+        }
+        const int pushRequests = m_requests;
+
+        qDebug() << "polling: avg latency" << pollLatency / count << "ms," << pollRequests << "requests";
+        qDebug() << "batch + long poll: avg latency" << pushLatency / count << "ms," << pushRequests << "requests";
+        QVERIFY( pushRequests < pollRequests );
+        QVERIFY( pushLatency < pollLatency );
+    }
+};
+
+#endif // TOMAHAWK_TESTPLAYDARAPI_H
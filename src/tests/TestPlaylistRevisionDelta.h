@@ -0,0 +1,151 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTPLAYLISTREVISIONDELTA_H
+#define TOMAHAWK_TESTPLAYLISTREVISIONDELTA_H
+
+#include <QtTest>
+
+#include "libtomahawk/database/PlaylistRevisionDelta.h"
+#include "libtomahawk/utils/Json.h"
+
+using Tomahawk::PlaylistRevisionDelta;
+
+class TestPlaylistRevisionDelta : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QStringList playlist( int size )
+    {
+        QStringList guids;
+        for ( int i = 0; i < size; i++ )
+            guids << QString( "guid-%1" ).arg( i );
+        return guids;
+    }
+
+    static void roundtrip( const QStringList& from, const QStringList& to )
+    {
+        const QVariantMap delta = PlaylistRevisionDelta::diff( from, to );
+        QVERIFY( !delta.isEmpty() );
+
+        QStringList result;
+        QVERIFY( PlaylistRevisionDelta::apply( from, delta, result ) );
+        QCOMPARE( result, to );
+    }
+
+private slots:
+    void testEdits()
+    {
+        const QStringList base = QStringList() << "a" << "b" << "c" << "d" << "e";
+
+        roundtrip( base, base );
+        roundtrip( QStringList(), base );
+        roundtrip( base, QStringList() );
+        roundtrip( base, QStringList() << "x" << "a" << "b" << "c" << "d" << "e" );
+        roundtrip( base, QStringList() << "a" << "b" << "x" << "y" << "c" << "d" << "e" );
+        roundtrip( base, QStringList() << "a" << "c" << "e" );
+        roundtrip( base, QStringList() << "b" << "c" << "d" << "e" << "a" );
+        roundtrip( base, QStringList() << "e" << "d" << "c" << "b" << "a" );
+        roundtrip( base, QStringList() << "x" << "d" << "a" << "y" << "c" );
+    }
+
+    void testSmallDelta()
+    {
+        const QStringList from = playlist( 1000 );
+        QStringList to = from;
+        to.insert( 500, "new" );
+        to.move( 10, 900 );
+        to.removeAt( 20 );
+
+        const QVariantMap delta = PlaylistRevisionDelta::diff( from, to );
+        QCOMPARE( delta.value( "removed" ).toList().count(), 1 );
+        QCOMPARE( delta.value( "placed" ).toList().count(), 2 );
+    }
+
+    void testInvalid()
+    {
+        // guids have to be unique
+        QVERIFY( PlaylistRevisionDelta::diff( QStringList() << "a" << "a", QStringList() << "a" ).isEmpty() );
+
+        // anchors have to exist
+        QVariantMap delta = PlaylistRevisionDelta::diff( QStringList() << "a", QStringList() << "a" << "b" );
+        QStringList result;
+        QVERIFY( !PlaylistRevisionDelta::apply( QStringList() << "c", delta, result ) );
+        QVERIFY( !PlaylistRevisionDelta::apply( QStringList() << "a", QVariantMap(), result ) );
+    }
+
+    void benchmarkEdit_data()
+    {
+        QTest::addColumn< int >( "size" );
+        QTest::newRow( "100" ) << 100;
+        QTest::newRow( "1000" ) << 1000;
+        QTest::newRow( "10000" ) << 10000;
+        QTest::newRow( "50000" ) << 50000;
+    }
+
+    // Cost of storing a single track insertion as a delta, compared to the full list
+    void benchmarkEdit()
+    {
+        QFETCH( int, size );
+
+        const QStringList from = playlist( size );
+        QStringList to = from;
+        to.insert( size / 2, "new" );
+
+        QVariantMap delta;
+        QByteArray deltaJson;
+        QBENCHMARK
+        {
+            delta = PlaylistRevisionDelta::diff( from, to );
+            deltaJson = TomahawkUtils::toJson( delta );
+        }
+
+        QVariantList full;
+        foreach ( const QString& guid, to )
+            full << guid;
+        const QByteArray fullJson = TomahawkUtils::toJson( full );
+
+        qDebug() << "entries:" << size << "delta bytes:" << deltaJson.size() << "full list bytes:" << fullJson.size();
+        QVERIFY( deltaJson.size() < 100 );
+    }
+
+    void benchmarkApply_data()
+    {
+        benchmarkEdit_data();
+    }
+
+    void benchmarkApply()
+    {
+        QFETCH( int, size );
+
+        const QStringList from = playlist( size );
+        QStringList to = from;
+        to.insert( size / 2, "new" );
+        const QVariantMap delta = PlaylistRevisionDelta::diff( from, to );
+
+        QStringList result;
+        QBENCHMARK
+        {
+            PlaylistRevisionDelta::apply( from, delta, result );
+        }
+        QCOMPARE( result, to );
+    }
+};
+
+#endif // TOMAHAWK_TESTPLAYLISTREVISIONDELTA_H
@@ -0,0 +1,305 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTRESOLVECACHE_H
+#define TOMAHAWK_TESTRESOLVECACHE_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+#include "libtomahawk/Pipeline.h"
+#include "libtomahawk/Query.h"
+#include "libtomahawk/Result.h"
+#include "libtomahawk/Track.h"
+#include "libtomahawk/resolvers/ResolveCache.h"
+#include "libtomahawk/resolvers/Resolver.h"
+#include "libtomahawk/utils/TomahawkCache.h"
+#include "libtomahawk/utils/TomahawkUtils.h"
+
+/**
+ * Finds every track with the given artist after a fixed delay and nothing
+ * else. A timeout makes the Pipeline move on before it answered.
+ */
+class ArtistResolver : public Tomahawk::Resolver
+{
+    Q_OBJECT
+
+public:
+    ArtistResolver( const QString& name, unsigned int weight, const QString& artist, int delay = 20, unsigned int timeout = 0 )
+        : asked( 0 )
+        , m_name( name )
+        , m_weight( weight )
+        , m_artist( artist )
+        , m_delay( delay )
+        , m_timeout( timeout )
+    {
+    }
+
+    QString name() const { return m_name; }
+    unsigned int weight() const { return m_weight; }
+    unsigned int timeout() const { return m_timeout; }
+
+    int asked;
+    QStringList hints;
+
+public slots:
+    void resolve( const Tomahawk::query_ptr& query )
+    {
+        asked++;
+        hints << query->resultHint();
+
+        m_pending << query;
+        QTimer::singleShot( m_delay, this, SLOT( answer() ) );
+    }
+
+private slots:
+    void answer()
+    {
+        const Tomahawk::query_ptr query = m_pending.takeFirst();
+
+        QList< Tomahawk::result_ptr > results;
+        if ( query->queryTrack()->artist() == m_artist )
+        {
+            Tomahawk::result_ptr result = Tomahawk::Result::get( QString( "http://localhost/%1/%2" ).arg( m_name ).arg( query->queryTrack()->track() ) );
+            result->setTrack( Tomahawk::Track::get( query->queryTrack()->artist(), query->queryTrack()->track() ) );
+            result->setMimetype( "audio/mpeg" );
+            result->setRID( uuid() );
+            result->setResolvedBy( this );
+            results << result;
+        }
+
+        Tomahawk::Pipeline::instance()->reportResults( query->id(), results );
+    }
+
+private:
+    QString m_name;
+    unsigned int m_weight;
+    QString m_artist;
+    int m_delay;
+    unsigned int m_timeout;
+    QList< Tomahawk::query_ptr > m_pending;
+};
+
+
+class TestResolveCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_dir;
+    TomahawkUtils::Cache* m_cache;
+    Tomahawk::ResolveCache* m_resolveCache;
+    QList< ArtistResolver* > m_resolvers;
+
+    ArtistResolver* addResolver( ArtistResolver* r )
+    {
+        m_resolvers << r;
+        Tomahawk::Pipeline::instance()->addResolver( r );
+        return r;
+    }
+
+    void openCache()
+    {
+        m_cache = new TomahawkUtils::Cache( m_dir );
+        m_resolveCache = new Tomahawk::ResolveCache( m_cache );
+    }
+
+    void closeCache()
+    {
+        delete m_resolveCache;
+        delete m_cache;
+    }
+
+    // Every session gets new query objects for the same tracks
+    static QList< Tomahawk::query_ptr > playlist( const QString& artist, int count )
+    {
+        QList< Tomahawk::query_ptr > qlist;
+        for ( int i = 0; i < count; i++ )
+            qlist << Tomahawk::Query::get( artist, QString( "Track %1" ).arg( i ), QString() );
+
+        return qlist;
+    }
+
+    // Resolves the queries and returns how long it took until all of them were done
+    static qint64 resolve( const QList< Tomahawk::query_ptr >& qlist, int timeout = 30000 )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        Tomahawk::Pipeline::instance()->resolve( qlist );
+
+        foreach ( const Tomahawk::query_ptr& q, qlist )
+        {
+            while ( !q->resolvingFinished() && timer.elapsed() < timeout )
+                QTest::qWait( 5 );
+        }
+
+        return timer.elapsed();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        new Tomahawk::Pipeline( this );
+        Tomahawk::Pipeline::instance()->start();
+
+        m_dir = QDir::tempPath() + QString( "/tomahawk-testresolvecache-%1/" ).arg( QCoreApplication::applicationPid() );
+    }
+
+    void init()
+    {
+        TomahawkUtils::removeDirectory( m_dir );
+        QDir().mkpath( m_dir );
+        openCache();
+    }
+
+    void cleanup()
+    {
+        foreach ( ArtistResolver* r, m_resolvers )
+            Tomahawk::Pipeline::instance()->removeResolver( r );
+
+        // let late answers arrive before their resolvers go away
+        QTest::qWait( 50 );
+        qDeleteAll( m_resolvers );
+        m_resolvers.clear();
+
+        closeCache();
+        TomahawkUtils::removeDirectory( m_dir );
+    }
+
+    void testNotFoundSkipped()
+    {
+        ArtistResolver* local = addResolver( new ArtistResolver( "Local", 100, "Nobody" ) );
+        ArtistResolver* remote = addResolver( new ArtistResolver( "Remote", 90, "Artist" ) );
+
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( local->asked, 1 );
+        QCOMPARE( remote->asked, 1 );
+
+        // who didn't find it isn't asked again, who did gets its result as hint
+        const QList< Tomahawk::query_ptr > again = playlist( "Artist", 1 );
+        resolve( again );
+        QVERIFY( again.first()->solved() );
+        QCOMPARE( local->asked, 1 );
+        QCOMPARE( remote->asked, 2 );
+        QCOMPARE( remote->hints.last(), QString( "http://localhost/Remote/Track 0" ) );
+    }
+
+    void testNobodyFound()
+    {
+        ArtistResolver* local = addResolver( new ArtistResolver( "Local", 100, "Nobody" ) );
+        ArtistResolver* remote = addResolver( new ArtistResolver( "Remote", 90, "Nobody" ) );
+
+        resolve( playlist( "Artist", 1 ) );
+
+        // done without asking anyone
+        const QList< Tomahawk::query_ptr > again = playlist( "Artist", 1 );
+        resolve( again );
+        QVERIFY( again.first()->resolvingFinished() );
+        QVERIFY( !again.first()->solved() );
+        QCOMPARE( local->asked + remote->asked, 2 );
+    }
+
+    void testTimeoutNotCached()
+    {
+        // answers long after the Pipeline moved on, its answer doesn't count
+        ArtistResolver* slow = addResolver( new ArtistResolver( "Slow", 100, "Nobody", 300, 50 ) );
+        addResolver( new ArtistResolver( "Remote", 90, "Artist" ) );
+
+        resolve( playlist( "Artist", 1 ) );
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( slow->asked, 2 );
+    }
+
+    void testInvalidate()
+    {
+        ArtistResolver* local = addResolver( new ArtistResolver( "Local", 100, "Nobody" ) );
+        addResolver( new ArtistResolver( "Remote", 90, "Artist" ) );
+
+        resolve( playlist( "Artist", 1 ) );
+        m_resolveCache->invalidate( "Local" );
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( local->asked, 2 );
+
+        // invalidation sticks across sessions, the new answer doesn't get lost either
+        closeCache();
+        openCache();
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( local->asked, 2 );
+    }
+
+    void testTimeToLive()
+    {
+        ArtistResolver* local = addResolver( new ArtistResolver( "Local", 100, "Nobody" ) );
+        ArtistResolver* remote = addResolver( new ArtistResolver( "Remote", 90, "Nobody" ) );
+        m_resolveCache->setTimeToLive( "Local", 60000, 0 );
+        m_resolveCache->setTimeToLive( "Remote", 60000, 100 );
+
+        resolve( playlist( "Artist", 1 ) );
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( local->asked, 2 );
+        QCOMPARE( remote->asked, 1 );
+
+        QTest::qWait( 150 );
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( remote->asked, 2 );
+    }
+
+    void testDatabaseResolverMissNotCached()
+    {
+        // a peer coming online later may have it
+        ArtistResolver* database = addResolver( new ArtistResolver( "DatabaseResolver", 100, "Nobody" ) );
+        addResolver( new ArtistResolver( "Remote", 90, "Artist" ) );
+
+        resolve( playlist( "Artist", 1 ) );
+        resolve( playlist( "Artist", 1 ) );
+        QCOMPARE( database->asked, 2 );
+    }
+
+    // Resolving a large playlist that two of three resolvers can't find, in a new and in a warmed up session
+    void benchmarkColdWarmStart()
+    {
+        const int count = 1000;
+        addResolver( new ArtistResolver( "Local", 100, "Nobody" ) );
+        addResolver( new ArtistResolver( "Script", 90, "Nobody" ) );
+        ArtistResolver* remote = addResolver( new ArtistResolver( "Remote", 80, "Artist" ) );
+
+        const QList< Tomahawk::query_ptr > cold = playlist( "Artist", count );
+        const qint64 coldTime = resolve( cold );
+
+        closeCache();
+        openCache();
+
+        const QList< Tomahawk::query_ptr > warm = playlist( "Artist", count );
+        const qint64 warmTime = resolve( warm );
+
+        int asked = 0;
+        foreach ( ArtistResolver* r, m_resolvers )
+            asked += r->asked;
+
+        foreach ( const Tomahawk::query_ptr& q, cold + warm )
+            QVERIFY( q->solved() );
+        QCOMPARE( remote->asked, 2 * count );
+        QCOMPARE( asked, 4 * count );
+
+        qDebug() << "cold start:" << coldTime << "ms," << 3 * count << "lookups";
+        qDebug() << "warm start:" << warmTime << "ms," << count << "lookups";
+        QVERIFY( warmTime < coldTime );
+    }
+};
+
+#endif // TOMAHAWK_TESTRESOLVECACHE_H
@@ -0,0 +1,187 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTSCRIPTRESOLVERCHANNEL_H
+#define TOMAHAWK_TESTSCRIPTRESOLVERCHANNEL_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QProcess>
+
+#include "libtomahawk/resolvers/ScriptResolverChannel.h"
+#include "libtomahawk/utils/Json.h"
+
+#define STANDIN_RESOLVER "@CMAKE_BINARY_DIR@/script-resolver-standin"
+
+class TestScriptResolverChannel : public QObject
+{
+    Q_OBJECT
+
+private:
+    QProcess* m_proc;
+
+    void startStandIn( int latency )
+    {
+        m_proc->start( STANDIN_RESOLVER, QStringList() << QString::number( latency ) );
+        QVERIFY( m_proc->waitForStarted() );
+    }
+
+    static QByteArray rq( const QString& qid, const QString& track = QString( "Track" ) )
+    {
+        QVariantMap m;
+        m[ "_msgtype" ] = "rq";
+        m[ "qid" ] = qid;
+        m[ "artist" ] = "Artist";
+        m[ "track" ] = track;
+        return TomahawkUtils::toJson( m );
+    }
+
+    // Most answers the stand-in had pending at once, i.e. requests it got before answering any of them
+    static int mostPending( const QSignalSpy& spy )
+    {
+        int pending = 0;
+        for ( int i = 0; i < spy.count(); i++ )
+            pending = qMax( pending, spy.at( i ).at( 0 ).toMap().value( "pending" ).toInt() );
+
+        return pending;
+    }
+
+    static bool waitFor( QSignalSpy& spy, int count, int timeout = 5000 )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while ( spy.count() < count && timer.elapsed() < timeout )
+            QTest::qWait( 5 );
+
+        return spy.count() >= count;
+    }
+
+private slots:
+    void init()
+    {
+        m_proc = new QProcess;
+    }
+
+    void cleanup()
+    {
+        m_proc->closeWriteChannel();
+        if ( !m_proc->waitForFinished( 2000 ) )
+            m_proc->kill();
+
+        delete m_proc;
+    }
+
+    void testPipelined()
+    {
+        startStandIn( 200 );
+        ScriptResolverChannel channel( m_proc );
+        QSignalSpy spy( &channel, SIGNAL( message( QVariantMap ) ) );
+
+        for ( int i = 0; i < 20; i++ )
+            channel.request( QString( "q%1" ).arg( i ), rq( QString( "q%1" ).arg( i ) ) );
+        QCOMPARE( channel.inFlight(), 20 );
+
+        QVERIFY( waitFor( spy, 20 ) );
+        QCOMPARE( channel.inFlight(), 0 );
+
+        // every request was out before the first answer came back
+        QCOMPARE( spy.first().at( 0 ).toMap().value( "pending" ).toInt(), 20 );
+
+        QSet< QString > qids;
+        for ( int i = 0; i < spy.count(); i++ )
+            qids << spy.at( i ).at( 0 ).toMap().value( "qid" ).toString();
+        QCOMPARE( qids.count(), 20 );
+    }
+
+    void testWindow()
+    {
+        startStandIn( 50 );
+        ScriptResolverChannel channel( m_proc );
+        channel.setWindow( 4 );
+        QSignalSpy spy( &channel, SIGNAL( message( QVariantMap ) ) );
+
+        for ( int i = 0; i < 12; i++ )
+            channel.request( QString( "q%1" ).arg( i ), rq( QString( "q%1" ).arg( i ) ) );
+        QCOMPARE( channel.inFlight(), 4 );
+        QCOMPARE( channel.queued(), 8 );
+
+        QVERIFY( waitFor( spy, 12 ) );
+        QCOMPARE( channel.queued(), 0 );
+
+        // the stand-in never had more than the window to answer
+        QCOMPARE( mostPending( spy ), 4 );
+
+        // answers come back in the order the window let the requests out
+        QCOMPARE( spy.first().at( 0 ).toMap().value( "qid" ).toString(), QString( "q0" ) );
+        QCOMPARE( spy.last().at( 0 ).toMap().value( "qid" ).toString(), QString( "q11" ) );
+    }
+
+    void testTimeout()
+    {
+        startStandIn( 10 );
+        ScriptResolverChannel channel( m_proc );
+        channel.setWindow( 1 );
+        channel.setTimeout( 300 );
+        QSignalSpy spy( &channel, SIGNAL( message( QVariantMap ) ) );
+
+        // the unanswered request only holds up the single slot until it times out
+        channel.request( "lost", rq( "lost", "never" ) );
+        channel.request( "found", rq( "found" ) );
+        QCOMPARE( channel.queued(), 1 );
+
+        QVERIFY( waitFor( spy, 1 ) );
+        QCOMPARE( spy.count(), 1 );
+        QCOMPARE( spy.first().at( 0 ).toMap().value( "qid" ).toString(), QString( "found" ) );
+        QCOMPARE( channel.inFlight(), 0 );
+        QCOMPARE( channel.queued(), 0 );
+    }
+
+    void benchmarkResolve_data()
+    {
+        QTest::addColumn< int >( "window" );
+        QTest::newRow( "one at a time" ) << 1;
+        QTest::newRow( "window of 8" ) << 8;
+        QTest::newRow( "window of 32" ) << 32;
+    }
+
+    // 64 queries against a resolver taking 20ms for each of them
+    void benchmarkResolve()
+    {
+        QFETCH( int, window );
+
+        startStandIn( 20 );
+        ScriptResolverChannel channel( m_proc );
+        channel.setWindow( window );
+        QSignalSpy spy( &channel, SIGNAL( message( QVariantMap ) ) );
+
+        int round = 0;
+        QBENCHMARK
+        {
+            spy.clear();
+            for ( int i = 0; i < 64; i++ )
+            {
+                const QString qid = QString( "r%1-%2" ).arg( round ).arg( i );
+                channel.request( qid, rq( qid ) );
+            }
+            QVERIFY( waitFor( spy, 64, 30000 ) );
+            round++;
+        }
+    }
+};
+
+#endif // TOMAHAWK_TESTSCRIPTRESOLVERCHANNEL_H
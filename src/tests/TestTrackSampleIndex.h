@@ -0,0 +1,205 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTTRACKSAMPLEINDEX_H
+#define TOMAHAWK_TESTTRACKSAMPLEINDEX_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+#include "libtomahawk/database/TrackSampleIndex.h"
+
+using Tomahawk::TrackSampleIndex;
+
+class TestTrackSampleIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    TrackSampleIndex* index;
+
+    // Track i is by artist i % 10 on album i % 50, released in 1950 + i % 60
+    // and played i % 5 times, the last time at i
+    static void fill( TrackSampleIndex* idx, int count )
+    {
+        for ( int i = 1; i <= count; i++ )
+        {
+            idx->load( i, i % 10 + 1, i % 50 + 1, 1950 + i % 60 );
+            if ( i % 5 )
+                idx->loadPlays( i, i % 5, i );
+        }
+        idx->setLoaded( true );
+    }
+
+private slots:
+    void init()
+    {
+        index = new TrackSampleIndex();
+        fill( index, 1000 );
+    }
+
+    void cleanup()
+    {
+        delete index;
+    }
+
+    void testDistinct()
+    {
+        const QList< int > ids = index->sample( TrackSampleIndex::Constraints(), 100 );
+        QCOMPARE( ids.count(), 100 );
+        QCOMPARE( ids.toSet().count(), 100 );
+
+        // Asking for more than there is gives everything once
+        const QList< int > all = index->sample( TrackSampleIndex::Constraints(), 5000 );
+        QCOMPARE( all.count(), 1000 );
+        QCOMPARE( all.toSet().count(), 1000 );
+    }
+
+    void testConstraints()
+    {
+        TrackSampleIndex::Constraints c;
+        c.artists << 3;
+        foreach ( int id, index->sample( c, 20 ) )
+            QCOMPARE( id % 10 + 1, 3 );
+
+        c.albums << 13; // tracks 12, 62, ... all by artist 3
+        QCOMPARE( index->sample( c, 100 ).count(), 20 );
+        c.albums = QList< int >() << 14;
+        QVERIFY( index->sample( c, 100 ).isEmpty() );
+
+        c = TrackSampleIndex::Constraints();
+        c.minYear = 2000;
+        c.maxYear = 2004;
+        foreach ( int id, index->sample( c, 50 ) )
+            QVERIFY( 1950 + id % 60 >= 2000 && 1950 + id % 60 <= 2004 );
+
+        c = TrackSampleIndex::Constraints();
+        c.minPlays = 3;
+        c.maxPlays = 3;
+        foreach ( int id, index->sample( c, 50 ) )
+            QCOMPARE( id % 5, 3 );
+
+        c = TrackSampleIndex::Constraints();
+        c.minPlays = 0;
+        c.maxPlays = 0;
+        QCOMPARE( index->sample( c, 1000 ).count(), 200 );
+    }
+
+    void testRecentlyPlayed()
+    {
+        TrackSampleIndex::Constraints c;
+        c.playedSince = 991;
+        QList< int > ids = index->sample( c, 100 );
+        qSort( ids );
+        QCOMPARE( ids, QList< int >() << 991 << 992 << 993 << 994 << 996 << 997 << 998 << 999 );
+
+        c = TrackSampleIndex::Constraints();
+        c.notPlayedSince = 11;
+        ids = index->sample( c, 1000 );
+        QCOMPARE( ids.count(), 8 + 200 ); // played before, or never
+    }
+
+    void testExclude()
+    {
+        TrackSampleIndex::Constraints c;
+        c.artists << 5;
+
+        // A station drawing batches doesn't repeat itself until it ran out of tracks
+        QSet< int > drawn;
+        for ( int i = 0; i < 4; i++ )
+        {
+            const QList< int > batch = index->sample( c, 25, drawn );
+            QCOMPARE( batch.count(), 25 );
+            foreach ( int id, batch )
+                QVERIFY( !drawn.contains( id ) );
+            drawn += batch.toSet();
+        }
+
+        QVERIFY( index->sample( c, 25, drawn ).isEmpty() );
+    }
+
+    void testInsert()
+    {
+        TrackSampleIndex idx;
+        idx.insert( 1, 1, 1, 2000 );
+        QCOMPARE( idx.count(), 0 );
+
+        idx.setLoaded( true );
+        idx.insert( 1, 1, 1, 2000 );
+        idx.insert( 1, 1, 2, 0 ); // the same track on another album
+        QCOMPARE( idx.count(), 1 );
+
+        TrackSampleIndex::Constraints c;
+        c.albums << 2;
+        QCOMPARE( idx.sample( c, 10 ), QList< int >() << 1 );
+
+        c = TrackSampleIndex::Constraints();
+        c.minPlays = 1;
+        QVERIFY( idx.sample( c, 10 ).isEmpty() );
+        idx.addPlayback( 1, 100 );
+        QCOMPARE( idx.sample( c, 10 ), QList< int >() << 1 );
+
+        idx.clear();
+        QVERIFY( !idx.isLoaded() );
+        QCOMPARE( idx.count(), 0 );
+    }
+
+    // Drawing a station's worth of tracks from a large collection, compared to looking at every track
+    void benchmarkSample()
+    {
+        TrackSampleIndex idx;
+        const int count = 500000;
+        fill( &idx, count );
+
+        TrackSampleIndex::Constraints all;
+        TrackSampleIndex::Constraints decade;
+        decade.minYear = 1990;
+        decade.maxYear = 1999;
+        decade.minPlays = 1;
+
+        QElapsedTimer timer;
+        timer.start();
+        for ( int i = 0; i < 100; i++ )
+            QCOMPARE( idx.sample( all, 25 ).count(), 25 );
+        const qint64 sampleTime = timer.restart();
+
+        for ( int i = 0; i < 100; i++ )
+            QCOMPARE( idx.sample( decade, 25 ).count(), 25 );
+        const qint64 constrainedTime = timer.restart();
+
+        int matching = 0;
+        for ( int i = 1; i <= count; i++ )
+        {
+            if ( i % 60 >= 40 && i % 60 < 50 && i % 5 )
+                matching++;
+        }
+
+        // What a station used to do: look at everything, then shuffle
+        timer.restart();
+        for ( int i = 0; i < 10; i++ )
+            QCOMPARE( idx.sample( decade, count ).count(), matching );
+        const qint64 scanTime = timer.elapsed();
+
+        qDebug() << "100 x 25 random tracks out of" << count << ":" << sampleTime << "ms";
+        qDebug() << "100 x 25 random tracks out of" << matching << "played ones from the 90s:" << constrainedTime << "ms";
+        qDebug() << "10 x all of them, shuffled:" << scanTime << "ms";
+        QVERIFY( constrainedTime < scanTime );
+    }
+};
+
+#endif // TOMAHAWK_TESTTRACKSAMPLEINDEX_H
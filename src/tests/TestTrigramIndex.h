@@ -0,0 +1,94 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTTRIGRAMINDEX_H
+#define TOMAHAWK_TESTTRIGRAMINDEX_H
+
+#include <QtTest>
+
+#include "libtomahawk/database/fuzzyindex/TrigramIndex.h"
+
+using Tomahawk::TrigramIndex;
+
+class TestTrigramIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    TrigramIndex* index;
+
+private slots:
+    void initTestCase()
+    {
+        index = new TrigramIndex();
+        index->load( TrigramIndex::Artist, 1, "the beatles" );
+        index->load( TrigramIndex::Artist, 2, "beach boys" );
+        index->load( TrigramIndex::Artist, 3, "radiohead" );
+        index->load( TrigramIndex::Track, 1, "let it be" );
+        index->setLoaded( true );
+    }
+
+    void cleanupTestCase()
+    {
+        delete index;
+    }
+
+    void testSubstring()
+    {
+        QCOMPARE( index->search( TrigramIndex::Artist, "beatles", false, 10 ), QList< int >() << 1 );
+        QCOMPARE( index->search( TrigramIndex::Artist, "head", false, 10 ), QList< int >() << 3 );
+        QVERIFY( index->search( TrigramIndex::Artist, "zeppelin", false, 10 ).isEmpty() );
+
+        // Shorter than a trigram
+        QList< int > ids = index->search( TrigramIndex::Artist, "be", false, 10 );
+        qSort( ids );
+        QCOMPARE( ids, QList< int >() << 1 << 2 );
+
+        // Types don't mix
+        QCOMPARE( index->search( TrigramIndex::Track, "be", false, 10 ), QList< int >() << 1 );
+    }
+
+    void testFuzzy()
+    {
+        QVERIFY( index->search( TrigramIndex::Artist, "radiohaed", false, 10 ).isEmpty() );
+        QCOMPARE( index->search( TrigramIndex::Artist, "radiohaed", true, 10 ), QList< int >() << 3 );
+    }
+
+    void testInsert()
+    {
+        index->insert( TrigramIndex::Album, 7, "ok computer" );
+        QCOMPARE( index->search( TrigramIndex::Album, "comp", false, 10 ), QList< int >() << 7 );
+    }
+
+    void testReplace()
+    {
+        index->insert( TrigramIndex::Album, 8, "rolled back" );
+        index->insert( TrigramIndex::Album, 8, "kid a" );
+        QVERIFY( index->search( TrigramIndex::Album, "rolled", false, 10 ).isEmpty() );
+        QCOMPARE( index->search( TrigramIndex::Album, "kid", false, 10 ), QList< int >() << 8 );
+    }
+
+    void testTruncated()
+    {
+        bool truncated = false;
+        QVERIFY( index->search( TrigramIndex::Artist, "e", false, 1, &truncated ).isEmpty() );
+        QVERIFY( truncated );
+    }
+};
+
+#endif // TOMAHAWK_TESTTRIGRAMINDEX_H
@@ -0,0 +1,158 @@
+/* === This file is part of Tomahawk Player - <http://tomahawk-player.org> ===
+ *
+ *   Copyright 2026, agent <agent@local>
+ *
+ *   Tomahawk is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Tomahawk is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Tomahawk. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOMAHAWK_TESTURLCHECKCACHE_H
+#define TOMAHAWK_TESTURLCHECKCACHE_H
+
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "libtomahawk/utils/UrlCheckCache.h"
+
+/**
+ * Minimal local HTTP server answering every request with the given status
+ * after a configurable delay.
+ */
+class HttpStandIn : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    HttpStandIn( int status, int delay )
+        : m_status( status )
+        , m_delay( delay )
+        , m_requests( 0 )
+    {
+        connect( this, SIGNAL( newConnection() ), SLOT( onNewConnection() ) );
+        listen( QHostAddress::LocalHost );
+    }
+
+    int requests() const { return m_requests; }
+    QString url( const QString& path ) const { return QString( "http://127.0.0.1:%1/%2" ).arg( serverPort() ).arg( path ); }
+
+private slots:
+    void onNewConnection()
+    {
+        while ( hasPendingConnections() )
+        {
+            QTcpSocket* socket = nextPendingConnection();
+            connect( socket, SIGNAL( readyRead() ), SLOT( onReadyRead() ) );
+            connect( socket, SIGNAL( disconnected() ), socket, SLOT( deleteLater() ) );
+        }
+    }
+
+    void onReadyRead()
+    {
+        QTcpSocket* socket = qobject_cast< QTcpSocket* >( sender() );
+        if ( !socket->readAll().contains( "\r\n\r\n" ) )
+            return;
+
+        m_requests++;
+        m_waiting << socket;
+        QTimer::singleShot( m_delay, this, SLOT( reply() ) );
+    }
+
+    void reply()
+    {
+        if ( m_waiting.isEmpty() )
+            return;
+
+        QTcpSocket* socket = m_waiting.takeFirst();
+        socket->write( QString( "HTTP/1.1 %1 Status\r\nContent-Length: 0\r\nConnection: close\r\n\r\n" ).arg( m_status ).toLatin1() );
+        socket->disconnectFromHost();
+    }
+
+private:
+    int m_status;
+    int m_delay;
+    int m_requests;
+    QList< QTcpSocket* > m_waiting;
+};
+
+
+class TestUrlCheckCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testUnknown()
+    {
+        Tomahawk::UrlCheckCache* cache = Tomahawk::UrlCheckCache::instance();
+        QCOMPARE( cache->state( "http://example.com/never-checked.mp3" ), Tomahawk::UrlCheckCache::Unknown );
+    }
+
+    void testNonHttpIsInvalid()
+    {
+        Tomahawk::UrlCheckCache* cache = Tomahawk::UrlCheckCache::instance();
+        QSignalSpy spy( cache, SIGNAL( checked( QString, bool ) ) );
+
+        cache->check( "ftp://example.com/track.mp3" );
+        QCOMPARE( spy.count(), 1 );
+        QCOMPARE( spy.at( 0 ).at( 1 ).toBool(), false );
+        QCOMPARE( cache->state( "ftp://example.com/track.mp3" ), Tomahawk::UrlCheckCache::Invalid );
+
+        // Cached answers are handed out again without another check
+        cache->check( "ftp://example.com/track.mp3" );
+        QCOMPARE( spy.count(), 2 );
+        QCOMPARE( spy.at( 1 ).at( 1 ).toBool(), false );
+
+        cache->invalidate( "ftp://example.com/track.mp3" );
+        QCOMPARE( cache->state( "ftp://example.com/track.mp3" ), Tomahawk::UrlCheckCache::Unknown );
+    }
+
+    void testCheckDoesNotBlock()
+    {
+        HttpStandIn server( 200, 500 );
+        const QString url = server.url( "slow.mp3" );
+
+        Tomahawk::UrlCheckCache* cache = Tomahawk::UrlCheckCache::instance();
+        QSignalSpy spy( cache, SIGNAL( checked( QString, bool ) ) );
+
+        QTime timer;
+        timer.start();
+        cache->check( url );
+        cache->check( url );
+        QVERIFY( timer.elapsed() < 500 );
+        QCOMPARE( cache->state( url ), Tomahawk::UrlCheckCache::Unknown );
+
+        QTRY_COMPARE( spy.count(), 1 );
+        QCOMPARE( spy.at( 0 ).at( 0 ).toString(), url );
+        QCOMPARE( spy.at( 0 ).at( 1 ).toBool(), true );
+        QCOMPARE( cache->state( url ), Tomahawk::UrlCheckCache::Valid );
+
+        // Both checks were merged into a single request
+        QCOMPARE( server.requests(), 1 );
+    }
+
+    void testDeadUrl()
+    {
+        HttpStandIn server( 404, 100 );
+        const QString url = server.url( "gone.mp3" );
+
+        Tomahawk::UrlCheckCache* cache = Tomahawk::UrlCheckCache::instance();
+        QSignalSpy spy( cache, SIGNAL( checked( QString, bool ) ) );
+
+        cache->check( url );
+        QTRY_COMPARE( spy.count(), 1 );
+        QCOMPARE( spy.at( 0 ).at( 1 ).toBool(), false );
+        QCOMPARE( cache->state( url ), Tomahawk::UrlCheckCache::Invalid );
+    }
+};
+
+#endif // TOMAHAWK_TESTURLCHECKCACHE_H
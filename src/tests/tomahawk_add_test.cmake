@@ -3,6 +3,15 @@ macro(tomahawk_add_test test_class)
 
     set(TOMAHAWK_TEST_CLASS ${test_class})
     set(TOMAHAWK_TEST_TARGET ${TOMAHAWK_TEST_CLASS}Test)
+
+    # Tests passing GUI get a QApplication, e.g. to drive a QWebPage
+    set(TOMAHAWK_TEST_APPLICATION QCoreApplication)
+    set(TOMAHAWK_TEST_MODULES Core Network Widgets Sql Xml Test)
+    if("${ARGN}" STREQUAL "GUI")
+        set(TOMAHAWK_TEST_APPLICATION QApplication)
+        list(APPEND TOMAHAWK_TEST_MODULES WebKitWidgets)
+    endif()
+
     configure_file(main.cpp.in Test${TOMAHAWK_TEST_CLASS}.cpp)
     configure_file(Test${TOMAHAWK_TEST_CLASS}.h Test${TOMAHAWK_TEST_CLASS}.h)
 
@@ -17,7 +26,10 @@ macro(tomahawk_add_test test_class)
     )
 
     add_test(NAME ${TOMAHAWK_TEST_TARGET} COMMAND ${TOMAHAWK_TEST_TARGET})
+    if("${ARGN}" STREQUAL "GUI")
+        set_tests_properties(${TOMAHAWK_TEST_TARGET} PROPERTIES ENVIRONMENT QT_QPA_PLATFORM=offscreen)
+    endif()
 
-    qt5_use_modules(${TOMAHAWK_TEST_TARGET} Core Network Widgets Sql Xml Test)
+    qt5_use_modules(${TOMAHAWK_TEST_TARGET} ${TOMAHAWK_TEST_MODULES})
 
 endmacro()
@@ -72,6 +72,7 @@
 #include "widgets/SplashWidget.h"
 
 #include "resolvers/JSResolver.h"
+#include "resolvers/ResolveCache.h"
 #include "resolvers/ScriptResolver.h"
 #include "utils/SpotifyParser.h"
 #include "AtticaManager.h"
@@ -214,6 +215,9 @@ TomahawkApp::init()
 
     // init pipeline and resolver factories
     new Pipeline();
+    Pipeline::instance()->setDispatchMode( (Pipeline::DispatchMode)TomahawkSettings::instance()->value( "pipeline/dispatchMode", Pipeline::Sequential ).toInt() );
+    if ( TomahawkSettings::instance()->value( "pipeline/resolveCache", true ).toBool() )
+        new ResolveCache( TomahawkUtils::Cache::instance(), Pipeline::instance() );
 
     m_servent = QPointer<Servent>( new Servent( this ) );
     connect( m_servent.data(), SIGNAL( ready() ), SLOT( initSIP() ) );
@@ -619,6 +623,8 @@ TomahawkApp::onInfoSystemReady()
     initPipeline();
 
     m_scanManager = QPointer<ScanManager>( new ScanManager( this ) );
+    if ( ResolveCache::instance() )
+        connect( m_scanManager.data(), SIGNAL( finished() ), ResolveCache::instance(), SLOT( onScanFinished() ) );
     if ( arguments().contains( "--filescan" ) )
     {
         m_scanManager.data()->runFullRescan();
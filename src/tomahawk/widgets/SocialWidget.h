@@ -68,6 +68,7 @@ private slots:
     void onShortLinkReady( const QUrl& longUrl, const QUrl& shortUrl, const QVariant& callbackObj );
 
     void onGeometryUpdate();
+    void onCoverChanged();
 
 private:
     unsigned int charsAvailable() const;